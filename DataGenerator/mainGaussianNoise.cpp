@@ -47,6 +47,7 @@ int main(int argc, char *argv[])
 		("datafile,f", po::value (&dataset)->default_value ("1"), "dataset file: use 1 for canonical and 2 for customized input from console")
 		("whitenoise_prob,w", po::value (&whitenoise_prob), "white noise probability parameter")
 		("mdl,o", "save MDL history to a file mdl.txt")
+		("winnercache,k", "reuse the winners of the data items while the nodes hardly move")
 		("modelefficiency,c", po::value (&model_efficiency)->default_value (1), "model efficiency constant");
 
 	// Declare an options description instance which will include
@@ -142,6 +143,8 @@ int main(int argc, char *argv[])
         // llrgng->setMeanDistanceMode (arithmetic);
 	if (vm.count("mdl"))
 		llrgng->saveMDLHistory ("mdl.txt");
+	if (vm.count("winnercache"))
+		llrgng->setWinnerCache (true);
 
 	
 	llrgng->begin();
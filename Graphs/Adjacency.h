@@ -0,0 +1,671 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file Adjacency.h
+* \brief Sparse and dense adjacency backends storing the edges of Base_Graph
+*
+*  \date    2026
+*/
+
+
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <boost/serialization/vector.hpp>
+
+namespace neuralgas {
+
+/** \class AdjacencyEntry
+ *  \brief One outgoing connection of a node as stored by the adjacency backends
+ *
+ * \param index index of the adjacent node
+ * \param edge ptr to the edge leading to the adjacent node
+ */
+template<typename E> struct AdjacencyEntry
+{
+	AdjacencyEntry() : index(0), edge(NULL) {}
+	AdjacencyEntry(const unsigned int& i, E* e) : index(i), edge(e) {}
+	// index of the adjacent node
+	unsigned int index;
+	// ptr to the edge leading to the adjacent node
+	E* edge;
+
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int) {
+		ar & BOOST_SERIALIZATION_NVP(index);
+		ar & BOOST_SERIALIZATION_NVP(edge);
+	}
+};
+
+/** \class SparseAdjacency
+ *  \brief Adjacency backend storing for every node only its existing edges
+ *
+ * Each node owns a short list of entries (adjacent node index, edge ptr),
+ * therefore memory grows with the number of edges and neighbor iteration
+ * is O(degree). The entries of a row are sorted by the index of the adjacent
+ * node, thus the neighbors are iterated in ascending order as by DenseAdjacency
+ * and an entry is found by binary search. Adding a node is O(1). Removing a node moves the last node
+ * into its place, as long as every entry x->y has a reverse entry y->x
+ * (undirected graphs) only the rows of the neighbors of the two nodes are
+ * visited, i.e. the removal is O(degree^2). Otherwise all rows have to be
+ * scanned for entries pointing to the two nodes.
+ * The backend does not own the edges, removed edge ptrs are handed back to
+ * the graph which is responsible for deleting them.
+ * This is the default backend of Base_Graph.
+ */
+template<typename E> class SparseAdjacency
+{
+public:
+	typedef E                                    Edge;
+	typedef AdjacencyEntry<E>                    Entry;
+	typedef std::vector<Entry>                   Row;
+	typedef typename Row::const_iterator         const_iterator;
+
+	// adds an edgeless node at the end
+	void                addVertex();
+	//std cto
+	SparseAdjacency() : _unmirrored(0) {}
+	// removes a node moving the last node into its place, collects the nodes linking to it and all edges it was part of
+	void                rmVertex(const unsigned int&, std::vector<unsigned int>&, std::vector<E*>&);
+	// returns the entry from x to y or NULL if there is none
+	inline Entry*       find(const unsigned int&, const unsigned int&);
+	// returns the entry from x to y or NULL if there is none
+	inline const Entry* find(const unsigned int&, const unsigned int&) const;
+	// sets the edge going from x to y
+	void                link(const unsigned int&, const unsigned int&, E*);
+	// removes the entry from x to y and returns its edge (NULL if there is none)
+	E*                  unlink(const unsigned int&, const unsigned int&);
+	// sets the edge going from x to y and from y to x, neither of both may exist
+	void                linkMutual(const unsigned int&, const unsigned int&, E*);
+	// removes the entries from x to y and from y to x and returns the edge (NULL if there is none)
+	E*                  unlinkMutual(const unsigned int&, const unsigned int&);
+	// first entry of node x
+	inline const_iterator begin(const unsigned int& x) const { return _rows[x].begin(); }
+	// end of the entries of node x
+	inline const_iterator end(const unsigned int& x) const { return _rows[x].end(); }
+	// number of entries of node x
+	inline unsigned int degree(const unsigned int& x) const { return _rows[x].size(); }
+	// number of nodes
+	inline unsigned int size() const { return _rows.size(); }
+	// removes all nodes and collects all distinct edges
+	void                clear(std::vector<E*>&);
+	// copies the entries of another backend leaving out one of its nodes, the backend has to be empty
+	void                assign(const SparseAdjacency&, const unsigned int&);
+	// replaces the edge ptrs given in a sorted array by the edges at the same position in another array
+	void                remapEdges(const std::vector<E*>&, const std::vector<E*>&);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int) {
+		ar & BOOST_SERIALIZATION_NVP(_rows);
+		if (Archive::is_loading::value)
+			countUnmirrored();
+	}
+	// orders the entries by the index of the adjacent node
+	struct EntryLess
+	{
+		inline bool operator()(const Entry& entry, const unsigned int& index) const { return entry.index < index; }
+	};
+	// returns the position of the first entry of row x not less than y
+	inline typename Row::iterator lowerBound(const unsigned int& x, const unsigned int& y) { return std::lower_bound(_rows[x].begin(), _rows[x].end(), y, EntryLess()); }
+	// inserts the entry from x to y at its sorted position, it must not exist
+	inline void         insert(const unsigned int&, const unsigned int&, E*);
+	// removes the entry from x to y keeping the order of the remaining entries
+	E*                  erase(const unsigned int&, const unsigned int&);
+	// changes the index of the entry of row x pointing to from into to, keeping the row sorted
+	void                rename(const unsigned int&, const unsigned int&, const unsigned int&);
+	// counts the entries without a reverse entry
+	void                countUnmirrored();
+	// entries of every node
+	std::vector<Row>    _rows;
+	// number of entries x->y without an entry y->x, self loops excluded
+	unsigned int        _unmirrored;
+};
+
+/** \class DenseAdjacency
+ *  \brief Adjacency backend storing an N x N matrix of edge ptrs
+ *
+ * The lookup of an edge is O(1) but adding and removing a node as well as
+ * neighbor iteration is O(N) and memory is quadratic in the number of nodes.
+ * Removing a node moves the last node into its place.
+ * It offers the same interface as SparseAdjacency, the iterator skips
+ * the empty slots of a row.
+ */
+template<typename E> class DenseAdjacency
+{
+public:
+	typedef E                                    Edge;
+	typedef AdjacencyEntry<E>                    Entry;
+	typedef std::vector<Entry>                   Row;
+
+	/** \class const_iterator
+	 *  \brief iterates over the non empty slots of a row
+	 */
+	class const_iterator
+	{
+	public:
+		const_iterator(typename Row::const_iterator cur, typename Row::const_iterator last) : _cur(cur), _last(last) { skip(); }
+		inline const Entry& operator*() const { return *_cur; }
+		inline const Entry* operator->() const { return &(*_cur); }
+		inline const_iterator& operator++() { ++_cur; skip(); return *this; }
+		inline bool operator==(const const_iterator& it) const { return _cur == it._cur; }
+		inline bool operator!=(const const_iterator& it) const { return _cur != it._cur; }
+	private:
+		inline void skip() { while (_cur != _last && _cur->edge == NULL) ++_cur; }
+		typename Row::const_iterator _cur;
+		typename Row::const_iterator _last;
+	};
+
+	// adds an edgeless node at the end
+	void                addVertex();
+	// removes a node moving the last node into its place, collects the nodes linking to it and all edges it was part of
+	void                rmVertex(const unsigned int&, std::vector<unsigned int>&, std::vector<E*>&);
+	// returns the entry from x to y or NULL if there is none
+	inline Entry*       find(const unsigned int&, const unsigned int&);
+	// returns the entry from x to y or NULL if there is none
+	inline const Entry* find(const unsigned int&, const unsigned int&) const;
+	// sets the edge going from x to y
+	void                link(const unsigned int&, const unsigned int&, E*);
+	// removes the entry from x to y and returns its edge (NULL if there is none)
+	E*                  unlink(const unsigned int&, const unsigned int&);
+	// sets the edge going from x to y and from y to x, neither of both may exist
+	void                linkMutual(const unsigned int&, const unsigned int&, E*);
+	// removes the entries from x to y and from y to x and returns the edge (NULL if there is none)
+	E*                  unlinkMutual(const unsigned int&, const unsigned int&);
+	// first entry of node x
+	inline const_iterator begin(const unsigned int& x) const { return const_iterator(_rows[x].begin(), _rows[x].end()); }
+	// end of the entries of node x
+	inline const_iterator end(const unsigned int& x) const { return const_iterator(_rows[x].end(), _rows[x].end()); }
+	// number of entries of node x
+	unsigned int        degree(const unsigned int&) const;
+	// number of nodes
+	inline unsigned int size() const { return _rows.size(); }
+	// removes all nodes and collects all distinct edges
+	void                clear(std::vector<E*>&);
+	// copies the entries of another backend leaving out one of its nodes, the backend has to be empty
+	void                assign(const DenseAdjacency&, const unsigned int&);
+	// replaces the edge ptrs given in a sorted array by the edges at the same position in another array
+	void                remapEdges(const std::vector<E*>&, const std::vector<E*>&);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int) {
+		ar & BOOST_SERIALIZATION_NVP(_rows);
+	}
+	// one slot for every node in every row
+	std::vector<Row>    _rows;
+};
+
+/** \brief Sorts the given edge ptrs and removes duplicates, edges of an undirected
+*   graph are referred to from both of their nodes
+*/
+template<typename E> inline void uniqueEdges(std::vector<E*>& edges)
+{
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+/** \brief adds an edgeless node at the end
+*/
+template<typename E> void SparseAdjacency<E>::addVertex()
+{
+	_rows.push_back(Row());
+}
+
+/** \brief Removes a node and moves the last node into its place
+*
+* If every entry has a reverse entry only the rows of the neighbors of the removed
+* and of the moved node are visited, otherwise all rows are scanned.
+* \param index node to be removed
+* \param sources gets the nodes (with their indices before the removal) that had an entry to index
+* \param removed gets all distinct edges the node was part of
+*/
+template<typename E> void SparseAdjacency<E>::rmVertex(const unsigned int& index, std::vector<unsigned int>& sources, std::vector<E*>& removed)
+{
+	assert (index < _rows.size());
+	unsigned int last = _rows.size() - 1;
+
+	if (_unmirrored == 0)
+	{
+		// the nodes linking to index are exactly its neighbors
+		const Row& row = _rows[index];
+		for (unsigned int j = 0; j < row.size(); j++)
+		{
+			removed.push_back(row[j].edge);
+			if (row[j].index == index)
+				continue;
+			sources.push_back(row[j].index);
+			removed.push_back(erase(row[j].index, index));
+		}
+	}
+	else
+	{
+		for (unsigned int i = 0; i <= last; i++)
+		{
+			if (i == index)
+				continue;
+			E* edge = erase(i, index);
+			if (edge != NULL)
+			{
+				sources.push_back(i);
+				removed.push_back(edge);
+			}
+		}
+		for (unsigned int j = 0; j < _rows[index].size(); j++)
+			removed.push_back(_rows[index][j].edge);
+	}
+	uniqueEdges(removed);
+	_rows[index].clear();
+
+	if (index != last)
+	{
+		// the last node gets the index of the removed node
+		_rows[index].swap(_rows[last]);
+		if (_unmirrored == 0)
+		{
+			// the renamed entries may move within the row, thus the neighbors are copied first
+			const Row& row = _rows[index];
+			std::vector<unsigned int> neighbors(row.size());
+			for (unsigned int j = 0; j < row.size(); j++)
+				neighbors[j] = row[j].index;
+			for (unsigned int j = 0; j < neighbors.size(); j++)
+				rename((neighbors[j] == last) ? index : neighbors[j], last, index);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < last; i++)
+				rename(i, last, index);
+		}
+	}
+	_rows.pop_back();
+
+	if (_unmirrored > 0)
+		countUnmirrored();
+}
+
+/** \brief removes the entry from x to y keeping the order of the remaining entries
+*
+* \return the edge of the removed entry or NULL if there was none
+*/
+template<typename E> E* SparseAdjacency<E>::erase(const unsigned int& x, const unsigned int& y)
+{
+	typename Row::iterator it = lowerBound(x, y);
+	if (it == _rows[x].end() || it->index != y)
+		return NULL;
+	E* edge = it->edge;
+	_rows[x].erase(it);
+	return edge;
+}
+
+/** \brief inserts the entry from x to y at its sorted position, it must not exist
+*/
+template<typename E> inline void SparseAdjacency<E>::insert(const unsigned int& x, const unsigned int& y, E* edge)
+{
+	_rows[x].insert(lowerBound(x, y), Entry(y, edge));
+}
+
+/** \brief changes the index of the entry of row x pointing to from into to
+*
+* The entry is moved to its sorted position, there must not be an entry to to.
+* Nothing is done if there is no entry to from.
+*/
+template<typename E> void SparseAdjacency<E>::rename(const unsigned int& x, const unsigned int& from, const unsigned int& to)
+{
+	typename Row::iterator it = lowerBound(x, from);
+	if (it == _rows[x].end() || it->index != from)
+		return;
+	E* edge = it->edge;
+	_rows[x].erase(it);
+	insert(x, to, edge);
+}
+
+/** \brief counts the entries x->y without an entry y->x
+*/
+template<typename E> void SparseAdjacency<E>::countUnmirrored()
+{
+	_unmirrored = 0;
+	for (unsigned int i = 0; i < _rows.size(); i++)
+		for (unsigned int j = 0; j < _rows[i].size(); j++)
+			if (_rows[i][j].index != i && find(_rows[i][j].index, i) == NULL)
+				_unmirrored++;
+}
+
+/** \brief returns the entry from x to y or NULL if there is none
+*/
+template<typename E> inline typename SparseAdjacency<E>::Entry* SparseAdjacency<E>::find(const unsigned int& x, const unsigned int& y)
+{
+	typename Row::iterator it = lowerBound(x, y);
+	return (it != _rows[x].end() && it->index == y) ? &(*it) : NULL;
+}
+
+/** \brief returns the entry from x to y or NULL if there is none
+*/
+template<typename E> inline const typename SparseAdjacency<E>::Entry* SparseAdjacency<E>::find(const unsigned int& x, const unsigned int& y) const
+{
+	const_iterator it = std::lower_bound(_rows[x].begin(), _rows[x].end(), y, EntryLess());
+	return (it != _rows[x].end() && it->index == y) ? &(*it) : NULL;
+}
+
+/** \brief sets the edge going from x to y, an existing entry is overwritten
+*/
+template<typename E> void SparseAdjacency<E>::link(const unsigned int& x, const unsigned int& y, E* edge)
+{
+	assert (x < _rows.size() && y < _rows.size());
+	Entry* entry = find(x, y);
+	if (entry != NULL)
+	{
+		entry->edge = edge;
+		return;
+	}
+	insert(x, y, edge);
+	if (x != y)
+	{
+		if (find(y, x) != NULL)
+			_unmirrored--;                // y->x got its reverse entry
+		else
+			_unmirrored++;
+	}
+}
+
+/** \brief removes the entry from x to y, keeping the order of the remaining entries
+*
+* \return the edge of the removed entry or NULL if there was none
+*/
+template<typename E> E* SparseAdjacency<E>::unlink(const unsigned int& x, const unsigned int& y)
+{
+	E* edge = erase(x, y);
+	if (edge != NULL && x != y)
+	{
+		if (find(y, x) != NULL)
+			_unmirrored++;                // y->x lost its reverse entry
+		else
+			_unmirrored--;
+	}
+	return edge;
+}
+
+/** \brief sets the edge going from x to y and from y to x
+*
+* Used by undirected graphs, no lookup is needed since both entries must not exist.
+*/
+template<typename E> void SparseAdjacency<E>::linkMutual(const unsigned int& x, const unsigned int& y, E* edge)
+{
+	assert (x < _rows.size() && y < _rows.size());
+	assert (find(x, y) == NULL && find(y, x) == NULL);
+	insert(x, y, edge);
+	if (x != y)
+		insert(y, x, edge);
+}
+
+/** \brief removes the entries from x to y and from y to x
+*
+* \return the edge of the entry from x to y or NULL if there was none
+*/
+template<typename E> E* SparseAdjacency<E>::unlinkMutual(const unsigned int& x, const unsigned int& y)
+{
+	E* edge = erase(x, y);
+	if (edge != NULL && x != y && erase(y, x) == NULL)
+		_unmirrored--;                    // x->y had no reverse entry
+	return edge;
+}
+
+/** \brief removes all nodes and collects all distinct edges
+*/
+template<typename E> void SparseAdjacency<E>::clear(std::vector<E*>& removed)
+{
+	for (unsigned int i = 0; i < _rows.size(); i++)
+		for (unsigned int j = 0; j < _rows[i].size(); j++)
+			removed.push_back(_rows[i][j].edge);
+	uniqueEdges(removed);
+	_rows.clear();
+	_unmirrored = 0;
+}
+
+/** \brief copies the entries of another backend, the backend has to be empty
+*
+* The entries stay sorted. If removed is a node of src, its entries are left out
+* and the last node of src takes its index, i.e. the result is the same as removing the
+* node from a copy by rmVertex. The edge ptrs are those of src, a graph cloning its edges
+* replaces them by remapEdges.
+* \param src backend to be copied from
+* \param removed node of src that is left out, no node is left out if it is not in src
+*/
+template<typename E> void SparseAdjacency<E>::assign(const SparseAdjacency& src, const unsigned int& removed)
+{
+	assert (_rows.empty());
+	const unsigned int nsize = src._rows.size();
+	if (removed >= nsize)
+	{
+		_rows       = src._rows;
+		_unmirrored = src._unmirrored;
+		return;
+	}
+	const unsigned int last = nsize - 1;
+	_rows.resize(last);
+	for (unsigned int i = 0; i < last; i++)
+	{
+		const Row& row = src._rows[(i == removed) ? last : i];
+		Row& copy = _rows[i];
+		copy.reserve(row.size());
+		for (unsigned int j = 0; j < row.size(); j++)
+			if (row[j].index != removed)
+				copy.push_back(row[j]);
+		rename(i, last, removed);
+	}
+	// removing a node keeps a mirrored backend mirrored
+	_unmirrored = 0;
+	if (src._unmirrored > 0)
+		countUnmirrored();
+}
+
+/** \brief replaces the edge ptrs of all entries
+*
+* \param from sorted array of all distinct edge ptrs of the entries
+* \param to new edge ptr for every element of from
+*/
+template<typename E> void SparseAdjacency<E>::remapEdges(const std::vector<E*>& from, const std::vector<E*>& to)
+{
+	assert (from.size() == to.size());
+	for (unsigned int i = 0; i < _rows.size(); i++)
+		for (unsigned int j = 0; j < _rows[i].size(); j++)
+		{
+			typename std::vector<E*>::const_iterator it = std::lower_bound(from.begin(), from.end(), _rows[i][j].edge);
+			assert (it != from.end() && *it == _rows[i][j].edge);
+			_rows[i][j].edge = to[it - from.begin()];
+		}
+}
+
+/** \brief adds an edgeless node at the end, i.e. a new row and a new empty slot in every row
+*/
+template<typename E> void DenseAdjacency<E>::addVertex()
+{
+	unsigned int nsize = _rows.size();
+	for (unsigned int i = 0; i < nsize; i++)
+		_rows[i].push_back(Entry(nsize, NULL));
+	_rows.push_back(Row());
+	_rows.back().reserve(nsize + 1);
+	for (unsigned int i = 0; i <= nsize; i++)
+		_rows.back().push_back(Entry(i, NULL));
+}
+
+/** \brief Removes a node by moving the row and the column of the last node into its place
+*
+* \param index node to be removed
+* \param sources gets the nodes (with their indices before the removal) that had an edge to index
+* \param removed gets all distinct edges the node was part of
+*/
+template<typename E> void DenseAdjacency<E>::rmVertex(const unsigned int& index, std::vector<unsigned int>& sources, std::vector<E*>& removed)
+{
+	assert (index < _rows.size());
+	unsigned int last = _rows.size() - 1;
+
+	for (unsigned int i = 0; i <= last; i++)
+	{
+		if (_rows[i][index].edge != NULL)
+		{
+			if (i != index)
+				sources.push_back(i);
+			removed.push_back(_rows[i][index].edge);
+		}
+		if (_rows[index][i].edge != NULL)
+			removed.push_back(_rows[index][i].edge);
+	}
+	uniqueEdges(removed);
+
+	if (index != last)
+	{
+		_rows[index].swap(_rows[last]);
+		for (unsigned int i = 0; i < last; i++)
+			_rows[i][index].edge = _rows[i][last].edge;
+	}
+	_rows.pop_back();
+	for (unsigned int i = 0; i < last; i++)
+		_rows[i].pop_back();
+}
+
+/** \brief returns the entry from x to y or NULL if there is none
+*/
+template<typename E> inline typename DenseAdjacency<E>::Entry* DenseAdjacency<E>::find(const unsigned int& x, const unsigned int& y)
+{
+	return (_rows[x][y].edge != NULL) ? &_rows[x][y] : NULL;
+}
+
+/** \brief returns the entry from x to y or NULL if there is none
+*/
+template<typename E> inline const typename DenseAdjacency<E>::Entry* DenseAdjacency<E>::find(const unsigned int& x, const unsigned int& y) const
+{
+	return (_rows[x][y].edge != NULL) ? &_rows[x][y] : NULL;
+}
+
+/** \brief sets the edge going from x to y
+*/
+template<typename E> void DenseAdjacency<E>::link(const unsigned int& x, const unsigned int& y, E* edge)
+{
+	assert (x < _rows.size() && y < _rows.size());
+	_rows[x][y].edge = edge;
+}
+
+/** \brief removes the entry from x to y
+*
+* \return the edge of the removed entry or NULL if there was none
+*/
+template<typename E> E* DenseAdjacency<E>::unlink(const unsigned int& x, const unsigned int& y)
+{
+	E* edge = _rows[x][y].edge;
+	_rows[x][y].edge = NULL;
+	return edge;
+}
+
+/** \brief sets the edge going from x to y and from y to x
+*/
+template<typename E> void DenseAdjacency<E>::linkMutual(const unsigned int& x, const unsigned int& y, E* edge)
+{
+	assert (x < _rows.size() && y < _rows.size());
+	_rows[x][y].edge = edge;
+	_rows[y][x].edge = edge;
+}
+
+/** \brief removes the entries from x to y and from y to x
+*
+* \return the edge of the entry from x to y or NULL if there was none
+*/
+template<typename E> E* DenseAdjacency<E>::unlinkMutual(const unsigned int& x, const unsigned int& y)
+{
+	E* edge = _rows[x][y].edge;
+	_rows[x][y].edge = NULL;
+	_rows[y][x].edge = NULL;
+	return edge;
+}
+
+/** \brief number of entries of node x
+*/
+template<typename E> unsigned int DenseAdjacency<E>::degree(const unsigned int& x) const
+{
+	unsigned int count = 0;
+	for (unsigned int j = 0; j < _rows[x].size(); j++)
+		if (_rows[x][j].edge != NULL)
+			count++;
+	return count;
+}
+
+/** \brief removes all nodes and collects all distinct edges
+*/
+template<typename E> void DenseAdjacency<E>::clear(std::vector<E*>& removed)
+{
+	for (unsigned int i = 0; i < _rows.size(); i++)
+		for (unsigned int j = 0; j < _rows[i].size(); j++)
+			if (_rows[i][j].edge != NULL)
+				removed.push_back(_rows[i][j].edge);
+	uniqueEdges(removed);
+	_rows.clear();
+}
+
+/** \brief copies the slots of another backend, the backend has to be empty
+*
+* If removed is a node of src, its row and column are left out and the row and the column
+* of the last node of src take their place as in rmVertex. The edge ptrs are those of src,
+* a graph cloning its edges replaces them by remapEdges.
+* \param src backend to be copied from
+* \param removed node of src that is left out, no node is left out if it is not in src
+*/
+template<typename E> void DenseAdjacency<E>::assign(const DenseAdjacency& src, const unsigned int& removed)
+{
+	assert (_rows.empty());
+	const unsigned int nsize = src._rows.size();
+	if (removed >= nsize)
+	{
+		_rows = src._rows;
+		return;
+	}
+	const unsigned int last = nsize - 1;
+	_rows.resize(last);
+	for (unsigned int i = 0; i < last; i++)
+	{
+		const Row& row = src._rows[(i == removed) ? last : i];
+		_rows[i].assign(row.begin(), row.begin() + last);
+		if (removed < last)
+			_rows[i][removed].edge = row[last].edge;
+	}
+}
+
+/** \brief replaces the edge ptrs of all non empty slots
+*
+* \param from sorted array of all distinct edge ptrs of the entries
+* \param to new edge ptr for every element of from
+*/
+template<typename E> void DenseAdjacency<E>::remapEdges(const std::vector<E*>& from, const std::vector<E*>& to)
+{
+	assert (from.size() == to.size());
+	for (unsigned int i = 0; i < _rows.size(); i++)
+		for (unsigned int j = 0; j < _rows[i].size(); j++)
+			if (_rows[i][j].edge != NULL)
+			{
+				typename std::vector<E*>::const_iterator it = std::lower_bound(from.begin(), from.end(), _rows[i][j].edge);
+				assert (it != from.end() && *it == _rows[i][j].edge);
+				_rows[i][j].edge = to[it - from.begin()];
+			}
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file AlignedAllocator.h
+* \brief Allocator of 64 byte aligned blocks padded to whole cache lines
+*
+*  \date    2026
+*/
+
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <new>
+
+// hints for loops over padded rows, they let the compiler vectorize without a scalar tail
+#if defined(__GNUC__)
+#define NEURALGAS_RESTRICT __restrict__
+#define NEURALGAS_ASSUME_ALIGNED(p) __builtin_assume_aligned((p), 64)
+#else
+#define NEURALGAS_RESTRICT
+#define NEURALGAS_ASSUME_ALIGNED(p) (p)
+#endif
+
+namespace neuralgas {
+
+/** \brief allocates size bytes starting at an address that is a multiple of alignment
+*
+* The block has to be released with alignedFree. alignment has to be a power of two.
+* \param size number of bytes
+* \param alignment alignment of the returned address in bytes
+*/
+inline void* alignedMalloc(const std::size_t& size, const std::size_t& alignment)
+{
+  // the original ptr is stored right in front of the aligned block
+  char* raw = static_cast<char*>( std::malloc(size + alignment + sizeof(void*)) );
+  if (raw == NULL)
+    return NULL;
+  std::size_t address = reinterpret_cast<std::size_t>(raw + sizeof(void*));
+  char* aligned = raw + sizeof(void*) + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+  reinterpret_cast<void**>(aligned)[-1] = raw;
+  return aligned;
+}
+
+/** \brief releases a block allocated by alignedMalloc
+*
+* \param p ptr returned by alignedMalloc, may be NULL
+*/
+inline void alignedFree(void* p)
+{
+  if (p != NULL)
+    std::free( reinterpret_cast<void**>(p)[-1] );
+}
+
+/** \brief returns the number of elements rounded up to whole cache lines of 64 bytes
+*
+* This is the stride of the rows of WeightMatrix and of the storage of Vector<T>.
+* Types whose size does not divide 64 bytes are not padded.
+* \param n number of elements
+*/
+template<typename T> inline unsigned int paddedLength(const unsigned int& n)
+{
+  const unsigned int per_line = (64 % sizeof(T) == 0) ? 64 / sizeof(T) : 1;
+  return ((n + per_line - 1) / per_line) * per_line;
+}
+
+/** \class AlignedAllocator
+ *  \brief Allocator whose blocks start at a 64 byte boundary and end at a whole cache line
+ *
+ * A block for n elements has room for paddedLength<T>(n) elements, the whole block is
+ * zeroed when it is allocated. Thus the elements behind the last one up to the padded
+ * length may be read by vectorized kernels and are zero as long as they were never used.
+ * Vector<T> keeps them zero when it shrinks.
+ */
+template<typename T> class AlignedAllocator
+{
+public:
+	typedef T              value_type;
+	typedef T*             pointer;
+	typedef const T*       const_pointer;
+	typedef T&             reference;
+	typedef const T&       const_reference;
+	typedef std::size_t    size_type;
+	typedef std::ptrdiff_t difference_type;
+	/// alignment of the blocks in bytes
+	enum { alignment = 64 };
+	/// the allocator for another type
+	template<typename U> struct rebind { typedef AlignedAllocator<U> other; };
+
+	/// std cto
+	AlignedAllocator() {}
+	/// cto from the allocator of another type, the allocators have no state
+	template<typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+	// allocates a zeroed block for n elements
+	pointer                allocate(size_type, const void* = 0);
+	/// releases a block
+	void                   deallocate(pointer p, size_type) { alignedFree(p); }
+	/// constructs an element in place
+	void                   construct(pointer p, const T& value) { new (static_cast<void*>(p)) T(value); }
+	/// destroys an element in place
+	void                   destroy(pointer p) { p->~T(); }
+	/// returns the address of an element
+	pointer                address(reference x) const { return &x; }
+	/// returns the address of a const element
+	const_pointer          address(const_reference x) const { return &x; }
+	/// returns the maximal number of elements
+	size_type              max_size() const { return size_type(-1) / sizeof(T) / 2; }
+	/// all allocators are equal, a block may be released by any of them
+	bool                   operator==(const AlignedAllocator&) const { return true; }
+	/// all allocators are equal
+	bool                   operator!=(const AlignedAllocator&) const { return false; }
+};
+
+/** \brief allocates a zeroed block for n elements that is padded to whole cache lines
+*
+* \param n number of elements
+*/
+template<typename T> typename AlignedAllocator<T>::pointer AlignedAllocator<T>::allocate(size_type n, const void*)
+{
+  if (n == 0)
+    return NULL;
+  const std::size_t size = std::size_t(paddedLength<T>(n)) * sizeof(T);
+  void* p = alignedMalloc(size, alignment);
+  if (p == NULL)
+    throw std::bad_alloc();
+  std::memset(p, 0, size);
+  return static_cast<pointer>(p);
+}
+
+} // namespace neuralgas
+
+#endif
@@ -31,34 +31,62 @@
 
 #include <vector>
 #include <map>
+#include <string>
 #include <fstream>
 #include "Vector.h"
 #include <iostream>
 #include <cstdlib>
 #include <tools/metrics.h>
 #include <tools/helpers.h>
+#include "Adjacency.h"
+#include "WeightMatrix.h"
+#include "EdgePool.h"
+#include "IndexedMaxHeap.h"
 
 namespace neuralgas {
 
-// TODO check edge deleting for derived classes (or better use shared_ptr)
-
 template < typename T , typename S > struct Base_Node;
 template < typename T , typename S> struct Base_Edge;
 
 template< typename T, typename S > class NeuralGas;
 
+/** \class NodeHandle
+ *  \brief Stable reference to a node of a graph
+ *
+ * Node indices are not stable, removing a node moves the last node into its place.
+ * A handle stays valid as long as its node is in the graph and keeps referring to it
+ * wherever the node is moved. The generation detects handles of removed nodes
+ * whose slot has been reused.
+ *
+ * \param slot slot of the node in the graph
+ * \param generation generation of the slot at the time the handle was taken
+ */
+struct NodeHandle
+{
+	NodeHandle() : slot(~0u), generation(0) {}
+	NodeHandle(const unsigned int& s, const unsigned int& g) : slot(s), generation(g) {}
+	inline bool operator==(const NodeHandle& h) const { return slot == h.slot && generation == h.generation; }
+	inline bool operator!=(const NodeHandle& h) const { return !(*this == h); }
+	// slot of the node in the graph
+	unsigned int slot;
+	// generation of the slot at the time the handle was taken
+	unsigned int generation;
+};
+
 /** \class Base_Node
  *  \brief The base class for nodes
  *
  * \param num_connections number of connected nodes to this node
- * \param weight vectors as data vector
+ * \param weight vectors as data vector, a view on the weight matrix of the graph
  * \param func user definded function called in the function update() for changing the node's values
- * \param edges a vector of ptrs to the node's edges 
+ *
+ * The edges of a node are not stored in the node but in the adjacency backend of the graph.
+ * The weight vector of a node that belongs to a graph is a row of the WeightMatrix
+ * of the graph, a node that does not belong to a graph stores its weight vector itself.
  */
 template < typename T , typename S > struct Base_Node
 {
 	friend class boost::serialization::access;
-	typedef boost::pool_allocator<Base_Edge<T, S>* > EdgePoolAlloc;
 	// typedef boost::pool_allocator<T> WeightAlloc;
 	Base_Node()
 	{
@@ -66,17 +94,7 @@ template < typename T , typename S > struct Base_Node
 		func=NULL;  
 	}
 
-	virtual ~Base_Node()
-	{ 
-		int esize = edges.size(); 
-		for(int i = 0; i < esize; i++)
-			if (edges[i]!=NULL)
-			{
-				delete edges[i];
-				// edges[i] = NULL;
-			}  
-    
-	}
+	virtual ~Base_Node(){}
 	/** \brief Calls the user defined function and applies it on this node
 	 */
 	virtual void update(const unsigned int& index=0){(*func)(this);}  
@@ -85,14 +103,11 @@ template < typename T , typename S > struct Base_Node
 	// number of connected nodes to this node
 	int num_connections;
 	// weight vectors as data vector
-	Vector<T> weight;
-	// edge vector containing the edges of the node  
-	std::vector< Base_Edge<S,T>*, EdgePoolAlloc > edges;
+	NodeWeight<T> weight;
 private:
 	template<class Archive>
 	void serialize(Archive & ar, const unsigned int) {
 		ar & BOOST_SERIALIZATION_NVP(weight);
-		ar & BOOST_SERIALIZATION_NVP(edges);
 		ar & BOOST_SERIALIZATION_NVP(num_connections);
 	}
 };  
@@ -100,17 +115,28 @@ private:
 /** \class Base_Edge
  *  \brief The base class for edges
  *
+ * The weight vector is empty unless the graph has a non-zero edge dimension,
+ * edges are taken from the slab allocator EdgePool.
+ *
  * \param weight vectors as data vector
  * \param in ptr to the ingoing node 
  * \param out ptr to the outgoing node
+ * \param in_handle handle of the ingoing node
+ * \param out_handle handle of the outgoing node
  */
 template < typename T , typename S> struct Base_Edge
 {
 	friend class boost::serialization::access;
   
-	Base_Edge(){in = NULL; out=NULL;}
+	Base_Edge() : weight(0) {in = NULL; out=NULL;}
 	virtual ~Base_Edge(){//in = NULL; out=NULL;
 	}
+	/// new operator taking the edge from the slab allocator
+	static inline void* operator new( std::size_t sz )
+	{ return EdgePool::allocate(sz) ; }
+	/// delete operator returning the edge to the slab allocator, sz is the size of the dynamic type
+	static inline void operator delete( void* p, std::size_t sz )
+	{ EdgePool::deallocate(p, sz) ; }
 
 	/** \brief Calls the user defined function and applies it on this edge
 	 */
@@ -123,6 +149,10 @@ template < typename T , typename S> struct Base_Edge
 	Base_Node<S,T>* in;
 	//ptr to the outgoing node
 	Base_Node<S,T>* out;
+	//handle of the ingoing node, stays valid when the node is moved
+	NodeHandle in_handle;
+	//handle of the outgoing node, stays valid when the node is moved
+	NodeHandle out_handle;
 
 	template<class Archive>
 	void serialize(Archive & ar, const unsigned int) {
@@ -149,6 +179,14 @@ template < typename T , typename S> struct Base_Edge
  * to the in node and corresponding out node. 
  * The first template parameter is the type of the node weigth vectors and the second template
  * parameter is the type of the edge weigth vectors.
+ * The third template parameter is the adjacency backend storing the edges, see Adjacency.h.
+ * The default SparseAdjacency only stores existing edges and iterates the neighbors of a node
+ * in O(degree), DenseAdjacency keeps the former N x N matrix of edge ptrs.
+ * The edges are owned by the graph, the backend only refers to them.
+ * The weight vectors of the nodes are stored contiguously in the WeightMatrix _weights,
+ * row i belongs to node i and the weight member of the node is a view on that row.
+ * Removing a node moves the last node into its place, thus the indices of the nodes are not
+ * stable. A NodeHandle obtained by getHandle keeps referring to its node across removals.
  * The following paragraph is important for derived classes. 
  * It is possible to use a user defined type of node for the graph.
  * In this case that newly defined node has to be derived from the struct Base_Node<T,S>
@@ -157,15 +195,23 @@ template < typename T , typename S> struct Base_Edge
  * The same holds for the edges.
  *
  * \param _nodes array of pointer to the nodes of the graph
+ * \param _adjacency the edges of the graph
+ * \param _weights the weight vectors of the nodes
+ * \param _slotOf slot of every node
+ * \param _slots node index and generation of every slot
+ * \param _freeSlots slots of removed nodes that can be reused
  * \param _dimNode dimension of the node's weight vectors
  * \param _dimEdge dimension of the edge's weight vectors
  */
-template<typename T, typename S> class Base_Graph
+template<typename T, typename S, typename A = SparseAdjacency< Base_Edge<S,T> > > class Base_Graph
 {
 	friend class boost::serialization::access;
 	
 public:
 	typedef T (Base_Graph::*Metric)(const Vector<T>&,const Vector<T>&) const;
+	typedef A Adjacency;
+	// index of no node, e.g. when no node is left out by a clone
+	enum { npos = ~0u };
 	//cto creating a graph with the same dimension for node and edge weight vectors
 	Base_Graph(const unsigned int&);
 	//dummy copy constructor. Copying procedures should be done in derived classes
@@ -183,7 +229,7 @@ public:
 	{ return pool.allocate() ; }
 	/// delete operator overloading
 	static inline void operator delete( void* p )
-	{ pool.deallocate( static_cast<Base_Graph<T,S>* >(p) ) ; }
+	{ pool.deallocate( static_cast<Base_Graph<T,S,A>* >(p) ) ; }
 	//returning a reference to the node indexed by the given index
 	Base_Node<T,S>&                     operator[](const unsigned int&);
 	//returning a const reference to the node indexed by the given index
@@ -192,24 +238,34 @@ public:
 	void                                initRandomGraph(const unsigned int&);
 	//adds a new uninitialized, edgeless node into the graph
 	void                                addNode(void);
-	// removes the node given by the index, removes its edges and updates the number of connections of its neighbors
+	// removes the node given by the index moving the last node into its place, removes its edges and updates the number of connections of its neighbors
 	virtual void                        rmNode(const unsigned int&); 
+	// returns a stable handle to the node given by the index
+	inline NodeHandle                   getHandle(const unsigned int&) const;
+	// returns whether the node referred to by the handle is still in the graph
+	inline bool                         isValid(const NodeHandle&) const;
+	// returns the current index of the node referred to by the handle
+	inline unsigned int                 getIndex(const NodeHandle&) const;
 	// adds an edge between the nodes given by their indeces      
 	virtual void                        addEdge(const unsigned int&,const unsigned int&)=0;
 	// removes an edge between the nodes given by their indeces if there exists one     
 	virtual void                        rmEdge(const unsigned int&,const unsigned int&)=0;
 	// saves the nodes weight in a file
 	bool                                save(const char*, bool t = false);
-	// loads nodes 
-	void                                setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes);
+	// loads nodes, the edges are taken from the given adjacency
+	void                                setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes, const A* adjacency = NULL);
 	//returns a vector of ints representing the indices of the neighboring nodes
 	std::vector<unsigned int>           getNeighbors(const unsigned int&) const;
 	// Returns neighbors set cardinality for some node
 	int                                 getNeighborsSize(const unsigned int&) const;
 	//returns whether the node of the given index has neighbors or not
 	inline bool                         isConnected(const unsigned int&) const;
+	//returns the number of nodes without connections
+	unsigned int                        numIsolatedNodes() const {return _isolated.size();}
+	//removes the nodes without connections as long as the graph has more than the given number of nodes
+	unsigned int                        rmIsolatedNodes(const unsigned int& min_size=0);
 	//applies the given func to all nodes
-	inline void                         applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float&);
+	virtual void                        applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float&);
 	//applies the given func to the neighboring nodes 
 	inline void                         applyFunc2Neighbors(const unsigned int&,void (*func)(Base_Node<T,S>*,const float&),const float&);
 	//calls the update function declared within the node struct
@@ -220,6 +276,8 @@ public:
 	inline void                         setMetric(Metric); 
 	// pre-specified metric is the standard L2 euclidean metric
 	virtual T                           metric(const Vector<T>&, const Vector<T>&) const;
+	// metric between a vector and the weight vector of a node
+	inline T                            metric(const Vector<T>&, const NodeWeight<T>&) const;
 
 	// Returns distances from a node to a set of nodes
 	std::map<unsigned int, T>           get1toMDistances (const unsigned int&, std::vector<unsigned int>&);
@@ -228,6 +286,10 @@ public:
 
 	// get nodes vector
 	inline std::vector< Base_Node<T,S>*, _NGPoolAlloc_ >* getNodes ();
+	/// returns the weight matrix, row i is the weight vector of node i
+	const WeightMatrix<T>&              weights() const{return _weights;}
+	/// returns the adjacency backend holding the edges of the graph
+	const A&                            adjacency() const{return _adjacency;}
 	/// sets the minimal limit values
 	inline void                         setLowLimits(Vector<T> low);
 	/// sets the maximal limit values
@@ -246,10 +308,57 @@ protected:
 	virtual Base_Node<T,S>*             newNode();
 	//returns a pointer to an edge of a type that is currently used by the graph
 	virtual Base_Edge<S,T>*             newEdge();
+	//deletes the node with the given index before it is removed from the graph
+	virtual void                        deleteNode(const unsigned int&);
+	//called after a node has been moved to another index
+	virtual void                        moveNode(const unsigned int&, const unsigned int&) {}
+	//deletes an edge that has been removed from the adjacency backend
+	virtual void                        deleteEdge(Base_Edge<S,T>*);
+	//rebuilds the indices derived graphs keep over the edges, called after loading
+	virtual void                        indexEdges() {}
+	//deletes all edges and empties the adjacency backend, the nodes have to be removed afterwards
+	void                                clearAdjacency();
+	//deletes all edges and nodes
+	void                                clearNodes();
+	//appends copies of the nodes of another graph leaving out one of them, the graph has to be empty
+	void                                cloneNodes(const Base_Graph&, const unsigned int& removed=npos);
+	//copies the edges of another graph after its nodes have been cloned
+	void                                cloneEdges(const Base_Graph&, const unsigned int& removed=npos);
+	//returns a copy of an edge of another graph, its nodes are set by cloneEdges
+	virtual Base_Edge<S,T>*             cloneEdge(const Base_Edge<S,T>&);
+	//assigns a slot to the node appended last
+	void                                addSlot();
+	//lets the weight vectors of the nodes from the given index on refer to their rows
+	void                                bindWeights(const unsigned int& from=0);
+	//increases the number of connections of a node
+	inline void                         incConnections(const unsigned int&);
+	//decreases the number of connections of a node
+	inline void                         decConnections(const unsigned int&);
+	// indices of the nodes without connections, all with the same key such that the smallest index is on top
+	IndexedMaxHeap<int>                 _isolated;
 	// array of pointer to the nodes of the graph
 	std::vector< Base_Node<T,S>*, _NGPoolAlloc_ >      _nodes;
+	// edges of the graph
+	A                                   _adjacency;
+	// weight vectors of the nodes
+	WeightMatrix<T>                     _weights;
+	/** \brief node index and generation of a slot */
+	struct Slot
+	{
+		Slot() : index(0), generation(0) {}
+		// index of the node in the slot
+		unsigned int index;
+		// incremented whenever the node of the slot is removed
+		unsigned int generation;
+	};
+	// slot of every node
+	std::vector<unsigned int>           _slotOf;
+	// node index and generation of every slot
+	std::vector<Slot>                   _slots;
+	// slots of removed nodes that can be reused
+	std::vector<unsigned int>           _freeSlots;
 	// memory pool for graph objects
-        static boost::fast_pool_allocator<Base_Graph<T,S> > pool;
+        static boost::fast_pool_allocator<Base_Graph<T,S,A> > pool;
 	// dimension of the node's weight vectors
 	unsigned int                        _dimNode;
 	// dimension of the edge's weight vectors
@@ -271,24 +380,25 @@ private:
 
 };
 
-template < typename T , typename S> void Base_Graph<T,S>::showGraph()
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::showGraph()
 {
  std::cout << "Graphsize " << _nodes.size() << std::endl;
 
  for(unsigned int i=0; i < _nodes.size(); i++)
  {        
-          for(unsigned int j=0; j < _nodes[i]->edges.size(); j++)
-                  std::cout <<( ( _nodes[i]->edges[j]==NULL) ? " " : "*");
-          std::cout<<std::endl;
+          std::string row(_nodes.size(), ' ');
+          for(typename A::const_iterator it = _adjacency.begin(i); it != _adjacency.end(i); ++it)
+                  row[it->index] = '*';
+          std::cout << row << std::endl;
  }
  std::cout << std::endl;
 }
 /*
-template<typename T,typename S> void Base_Graph<T,S>::addEdge(const unsigned int& a,const unsigned int& b)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::addEdge(const unsigned int& a,const unsigned int& b)
 {
 }  
 
-template<typename T,typename S> void Base_Graph<T,S>::rmEdge(const unsigned int& a,const unsigned int& b)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::rmEdge(const unsigned int& a,const unsigned int& b)
 {
 }  
 */
@@ -297,7 +407,7 @@ template<typename T,typename S> void Base_Graph<T,S>::rmEdge(const unsigned int&
 *
 * \param dim is the dimension of the weight vectors of the nodes in the graph
 */
-template<typename T,typename S> Base_Graph<T,S>::Base_Graph(const unsigned int& dim)
+template<typename T,typename S,typename A> Base_Graph<T,S,A>::Base_Graph(const unsigned int& dim)
 { 
   _dimNode = dim;
   _dimEdge = dim;
@@ -310,12 +420,13 @@ template<typename T,typename S> Base_Graph<T,S>::Base_Graph(const unsigned int&
 * edge vectors.
 *
 * \param dimNode is the dimension of the weight vectors of the nodes in the graph
-* \param dimEdge is the dimension of the weight vectors of the edges in the graph
+* \param dimEdge is the dimension of the weight vectors of the edges in the graph, 0 for edges without weight vector
 */
-template<typename T,typename S> Base_Graph<T,S>::Base_Graph(const unsigned int& dimNode,const unsigned int& dimEdge)
+template<typename T,typename S,typename A> Base_Graph<T,S,A>::Base_Graph(const unsigned int& dimNode,const unsigned int& dimEdge)
 {
   _dimNode = dimNode;
   _dimEdge = dimEdge; 
+  _metric_to_use  = NULL;   // no user defined metric is used, std metric is used
   ::srand( (unsigned)time( NULL ) );                    //inits the random function 
 }
 
@@ -323,32 +434,19 @@ template<typename T,typename S> Base_Graph<T,S>::Base_Graph(const unsigned int&
 *
 * \param graph the graph to be copied from
 */
-template<typename T,typename S> Base_Graph<T,S>::Base_Graph(const Base_Graph& g)
+template<typename T,typename S,typename A> Base_Graph<T,S,A>::Base_Graph(const Base_Graph& g)
 { 
 	_dimNode = g._dimNode;
 	_dimEdge = g._dimEdge;
-	unsigned int gsize = g.size();
-	
-	for (unsigned int i=0; i < gsize; i++)
-	{
-		addNode();
-		_nodes[i]->weight = g._nodes[i]->weight;
-		
-	}	
+	_metric_to_use = g._metric_to_use;
+	cloneNodes(g);
 }
 
 /** \brief std dto
 */
-template<typename T,typename S> Base_Graph<T,S>::~Base_Graph()
+template<typename T,typename S,typename A> Base_Graph<T,S,A>::~Base_Graph()
 {
-  int nsize  = size();
-  for(int i = 0; i < nsize; i++)
-  {
-    delete  _nodes[i];                                // delete ptrs to the nodes
-    //_nodes[i] = NULL;            
-    //_nodes.pop_back();
-  }
-  _nodes.clear();
+  clearNodes();
   boost::singleton_pool<boost::pool_allocator_tag, sizeof(typename _NGPoolAlloc_)>::release_memory();
 }
 
@@ -356,7 +454,7 @@ template<typename T,typename S> Base_Graph<T,S>::~Base_Graph()
 *
 * \param index of the node that shall be returned 
 */
-template<typename T,typename S> Base_Node<T,S>& Base_Graph<T,S>::operator[](const unsigned int& index)
+template<typename T,typename S,typename A> Base_Node<T,S>& Base_Graph<T,S,A>::operator[](const unsigned int& index)
 {
   assert (index < size () );
   return *(_nodes[index]);
@@ -366,7 +464,7 @@ template<typename T,typename S> Base_Node<T,S>& Base_Graph<T,S>::operator[](cons
 *
 * \param index of the node that shall be returned 
 */
-template<typename T,typename S> Base_Node<T,S>& Base_Graph<T,S>::operator[](const unsigned int& index) const
+template<typename T,typename S,typename A> Base_Node<T,S>& Base_Graph<T,S,A>::operator[](const unsigned int& index) const
 {
   assert (index < size());
   return *(_nodes[index]);
@@ -389,7 +487,7 @@ template<typename T,typename S> Base_Node<T,S>& Base_Graph<T,S>::operator[](cons
 * \param filename is the name of the file where to store the data to
 * \param text save the file in text format if true
 */
-template<typename T,typename S> bool Base_Graph<T,S>::save( const char* filename, bool text)
+template<typename T,typename S,typename A> bool Base_Graph<T,S,A>::save( const char* filename, bool text)
 {
   if (text)
     return neuralgas::saveNodesText (filename, &_nodes);
@@ -398,25 +496,35 @@ template<typename T,typename S> bool Base_Graph<T,S>::save( const char* filename
 }
 
 /** \brief Loads nodes
+*
+* The graph is replaced by nodes with the weights of the given nodes. The edges are not
+* part of the nodes but of the adjacency of their graph, thus the loaded graph has no
+* edges unless that adjacency, e.g. adjacency() of the graph the nodes are taken from,
+* is passed. Then an edge is added for every entry of it and gets the weight of the edge
+* of the entry.
     \param nodes
+    \param adjacency adjacency of the nodes or NULL
  */
-template<typename T, typename S> void Base_Graph<T,S>::setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes, const A* adjacency)
 {
-  for(unsigned int i = 0; i < size(); i++)
-    delete  _nodes[i];                                // delete ptrs to the nodes
-  _nodes.clear();
+  clearNodes();
 
   for (unsigned int i=0; i<nodes->size(); i++)
   {
     addNode();
     _nodes[i]->weight = (*nodes)[i]->weight;
   }
-  for (unsigned int i=0; i < nodes->size(); i++)
-    for (unsigned int j=0; j<(*nodes)[i]->edges.size(); j++)
-      if ( (*nodes)[i]->edges[j] != NULL )
+  if (adjacency == NULL)
+    return;
+  assert (adjacency->size() == nodes->size());
+  for (unsigned int i = 0; i < adjacency->size(); i++)
+    for (typename A::const_iterator it = adjacency->begin(i); it != adjacency->end(i); ++it)
+      if (_adjacency.find(i, it->index) == NULL)
       {
-        this->addEdge (i, j);
-        this->_nodes[i]->edges[j]->weight = (*nodes)[i]->edges[j]->weight;
+        addEdge(i, it->index);
+        typename A::Entry* entry = _adjacency.find(i, it->index);
+        if (entry != NULL)                           // derived graphs may refuse an edge
+          entry->edge->weight = it->edge->weight;
       }
 }
 
@@ -428,24 +536,17 @@ template<typename T, typename S> void Base_Graph<T,S>::setNodes( std::vector < B
 * \param num_of_nodes is the number of nodes with random valued weight vectors the graph is going to be initialized with
 */
   
-template<typename T,typename S> void Base_Graph<T,S>::initRandomGraph(const unsigned int& num_of_nodes)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::initRandomGraph(const unsigned int& num_of_nodes)
 {    
-  unsigned int nsize  = size();
-  for(unsigned int i = 0; i < nsize; i++)
-  {
-    delete  _nodes[i];                                // delete ptrs to the nodes
-    _nodes[i] = NULL;            
-    _nodes.pop_back();                                // rm ptr from the node array 
-  }  
+  clearNodes();
  
   for (unsigned int i = 0; i < num_of_nodes; i++)
   {
      addNode();                                     // adds a new node
-     (_nodes[i])->weight.resize(_dimNode);          // sets dimension of the weight vector
      
      for(unsigned int j = 0; j < _dimNode; j++)          
      {
-	     (_nodes[i])->weight[j] = (T) ((rand() / (static_cast<T>(RAND_MAX) + 1.0)) * (high_limits[j] - low_limits[j]) + low_limits[j] );   //sets the value of the weights to random values
+	     (_nodes[i])->weight[j] = (T) ((rand() / (static_cast<double>(RAND_MAX) + 1.0)) * (high_limits[j] - low_limits[j]) + low_limits[j] );   //sets the value of the weights to random values, computed in double since RAND_MAX is not exact in float
      }
   }  
 }   
@@ -463,7 +564,7 @@ template<typename T,typename S> void Base_Graph<T,S>::initRandomGraph(const unsi
 * addNode(),resulting in the use of the used defined node type as node for the graph structure.
 */
 
-template<typename T,typename S> Base_Node<T,S>* Base_Graph<T,S>::newNode(void)
+template<typename T,typename S,typename A> Base_Node<T,S>* Base_Graph<T,S,A>::newNode(void)
 {
   Base_Node<T,S>* n = new Base_Node<T,S>;
   return n;
@@ -481,96 +582,313 @@ template<typename T,typename S> Base_Node<T,S>* Base_Graph<T,S>::newNode(void)
 * addEdge(),resulting in the use of the used defined edge type as edge for the graph structure.
 */
 
-template<typename T,typename S> Base_Edge<S,T>* Base_Graph<T,S>::newEdge(void)
+template<typename T,typename S,typename A> Base_Edge<S,T>* Base_Graph<T,S,A>::newEdge(void)
 {
   Base_Edge<S,T>* e = new Base_Edge<S,T>;
   return e;
 } 
 
 
+/** \brief deletes all edges and empties the adjacency backend
+*
+* Used when all nodes of the graph are going to be removed.
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::clearAdjacency(void)
+{
+  std::vector< Base_Edge<S,T>* > edges;
+  _adjacency.clear(edges);
+  for(unsigned int i = 0; i < edges.size(); i++)
+    deleteEdge(edges[i]);                             // delete ptrs to the edges
+}
+
+/** \brief deletes the node with the given index before it is removed from the graph
+*
+* Derived graphs keeping aggregates or indices over their nodes reimplement this function
+* in order to remove the node from them before it is deleted. When a node is removed by
+* rmNode, moveNode is called afterwards for the node taking its place.
+* \param index of the node
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::deleteNode(const unsigned int& index)
+{
+  delete _nodes[index];
+}
+
+/** \brief deletes an edge that has been removed from the adjacency backend
+*
+* Derived graphs keeping an index over their edges reimplement this function
+* in order to remove the edge from their index before it is deleted.
+* \param edge ptr to the edge
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::deleteEdge(Base_Edge<S,T>* edge)
+{
+  delete edge;
+}
+
+/** \brief deletes all edges and nodes
+*
+* The slots of the nodes are released, i.e. all handles to the nodes become invalid.
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::clearNodes(void)
+{
+  clearAdjacency();
+
+  unsigned int nsize  = size();
+  for(unsigned int i = 0; i < nsize; i++)
+  {
+    deleteNode(i);                                    // delete ptrs to the nodes
+    _slots[ _slotOf[i] ].generation++;
+    _freeSlots.push_back(_slotOf[i]);
+  }
+  _nodes.clear();                                     // rm ptrs from the node array 
+  _slotOf.clear();
+  _weights.clear();
+  _isolated.clear();
+}
+
+/** \brief appends copies of the nodes of another graph
+*
+* The nodes are created by newNode, thus the derived graph has to copy its node
+* statistics itself. The weight vectors are copied by a single block copy of the
+* weight matrix. The nodes are edgeless, see cloneEdges.
+* If removed is a node of g it is left out and the last node of g takes its index,
+* i.e. the graph is the same as a copy of g after rmNode(removed).
+* \param g graph with the same dimension whose nodes are copied
+* \param removed node of g that is left out, no node is left out if it is not in g
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::cloneNodes(const Base_Graph& g, const unsigned int& removed)
+{
+  assert (size() == 0 && _dimNode == g._dimNode);
+  const unsigned int last  = g.size() - 1;
+  const unsigned int nsize = (removed < g.size()) ? last : g.size();
+  for (unsigned int i = 0; i < nsize; i++)
+  {
+    addNode();
+    _nodes[i]->func = g._nodes[(i == removed) ? last : i]->func;
+  }
+  if (nsize > 0)
+    _weights.copyRows(g._weights, removed);
+}
+
+/** \brief copies the edges of another graph whose nodes have been cloned by cloneNodes
+*
+* The adjacency backend is copied at once, keeping the order of the neighbors, then every
+* distinct edge is copied by cloneEdge and its nodes are set. The number of connections
+* of the nodes is taken from g.
+* \param g graph whose nodes have been cloned
+* \param removed node of g that has been left out by cloneNodes
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::cloneEdges(const Base_Graph& g, const unsigned int& removed)
+{
+  assert (size() == ((removed < g.size()) ? g.size() - 1 : g.size()));
+  const unsigned int last = g.size() - 1;
+  clearAdjacency();                                   // the cloned nodes are edgeless
+  _adjacency.assign(g._adjacency, removed);
+
+  // edges of g in the order they are met, and sorted without duplicates
+  std::vector< Base_Edge<S,T>* > met;
+  for (unsigned int i = 0; i < size(); i++)
+    for (typename A::const_iterator it = _adjacency.begin(i); it != _adjacency.end(i); ++it)
+      met.push_back(it->edge);
+  std::vector< Base_Edge<S,T>* > from(met);
+  uniqueEdges(from);
+  std::vector< Base_Edge<S,T>* > to(from.size(), NULL);
+  for (unsigned int k = 0; k < met.size(); k++)
+  {
+    unsigned int pos = std::lower_bound(from.begin(), from.end(), met[k]) - from.begin();
+    if (to[pos] != NULL)
+      continue;
+    unsigned int in  = g.getIndex(met[k]->in_handle);
+    unsigned int out = g.getIndex(met[k]->out_handle);
+    if (removed < last)
+    {
+      if (in == last)
+        in = removed;
+      if (out == last)
+        out = removed;
+    }
+    Base_Edge<S,T>* edge = cloneEdge(*met[k]);
+    edge->in         = _nodes[in];
+    edge->out        = _nodes[out];
+    edge->in_handle  = getHandle(in);
+    edge->out_handle = getHandle(out);
+    to[pos] = edge;
+  }
+  _adjacency.remapEdges(from, to);
+
+  for (unsigned int i = 0; i < size(); i++)
+    _nodes[i]->num_connections = g._nodes[(i == removed) ? last : i]->num_connections;
+  if (removed < g.size())
+    for (unsigned int i = 0; i < g.size(); i++)     // edge from i to the removed node
+      if (i != removed && g._adjacency.find(i, removed) != NULL)
+        _nodes[(i == last) ? removed : i]->num_connections--;
+  _isolated.clear();
+  for (unsigned int i = 0; i < size(); i++)
+    if (_nodes[i]->num_connections == 0)
+      _isolated.set(i, 0);
+}
+
+/** \brief returns a copy of an edge of another graph
+*
+* The edge is created by newEdge, derived graphs reimplement the function in order
+* to copy the values of their edge type. The nodes of the edge are set by cloneEdges.
+* \param e edge to be copied
+*/
+template<typename T,typename S,typename A> Base_Edge<S,T>* Base_Graph<T,S,A>::cloneEdge(const Base_Edge<S,T>& e)
+{
+  Base_Edge<S,T>* edge = newEdge();
+  edge->weight = e.weight;
+  return edge;
+}
+
+/** \brief assigns a slot to the node appended last, a released slot is reused if there is one
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::addSlot(void)
+{
+  unsigned int slot;
+  if (_freeSlots.empty())
+  {
+    slot = _slots.size();
+    _slots.push_back(Slot());
+  }
+  else
+  {
+    slot = _freeSlots.back();
+    _freeSlots.pop_back();
+  }
+  _slots[slot].index = _slotOf.size();
+  _slotOf.push_back(slot);
+}
+
+/** \brief lets the weight vectors of the nodes refer to their rows in the weight matrix
+*
+* Has to be called for all nodes after the matrix has been reallocated and for
+* the nodes behind a removed row since their rows have been moved.
+* \param from index of the first node whose weight vector is bound
+*/
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::bindWeights(const unsigned int& from)
+{
+  unsigned int nsize = size();
+  for(unsigned int i = from; i < nsize; i++)
+    _nodes[i]->weight.bind(_weights.row(i), _dimNode);
+}
+
 /** \brief adds a new uninitialized, edgeless node into the graph
 * The function uses the newNode function to get the currently (sub) class dependent 
 * Node type and adds this node to the graph.
-* There are no edges and the weight vectors are uninitialized, solely the dimension
-* of the weight vectors is set.
+* There are no edges and the weight vector is a zeroed row appended to the weight matrix,
+* which grows with amortized doubling.
 */
-template <typename T,typename S> void Base_Graph<T,S>::addNode(void)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::addNode(void)
 {
   // function does as follows
   // creates a new node of (sub)class specific type and adds it to the _node array
-  // a new slot for a possible edge is added to each node
-  unsigned int nsize=size();
-
+  // the adjacency backend gets an edgeless entry for the node
   Base_Node<T,S>*    n   =   newNode();  // gets the actual used node type
-  n->weight.reserve(_dimNode);
-  n->weight.resize(_dimNode);
-  for(unsigned int i=0; i < nsize; i++)
-  {
-   n->edges.push_back(NULL);    
-  }
+  if (_weights.rows() == 0 && _weights.dim() != _dimNode)
+    _weights.setDim(_dimNode);
+  bool moved = _weights.addRow();
   _nodes.push_back(n);                  // add the new node
- 
-  nsize++;
-    
-  for(unsigned int i=0; i < nsize; i++)
-  {
-   _nodes[i]->edges.push_back(NULL);    
-  }
- 
+  _adjacency.addVertex();
+  addSlot();
+  _isolated.set(size() - 1, 0);
+  if (moved)
+    bindWeights();                      // the rows have been reallocated
+  else
+    n->weight.bind(_weights.row(size() - 1), _dimNode);
 }
 
 /** \brief Removes the node given by the index, removes its edges and updates the number 
 * of connections of its neighbors
 *
+* The last node is moved into the place of the removed node, thus it gets the index
+* of the removed node while the indices of all other nodes are kept. Handles of the
+* remaining nodes stay valid. Apart from deleting the edges the removal is O(degree)
+* for undirected graphs.
 * \param index is the node that shall be deleted
 */
-template<typename T,typename S> void Base_Graph<T,S>::rmNode(const unsigned int& index)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::rmNode(const unsigned int& index)
 {
   // function does as follows
-  // checks whether the neighbors have an (directed) edge to index and deletes them
-  // deletes node in the _nodes array  
+  // removes the node from the adjacency backend, the nodes having an (directed) edge
+  // to index lose a connection, all edges of index are deleted
+  // deletes node and moves the last node, its row in the weight matrix and its slot into the hole
  
-  unsigned int     nsize=size();
-  assert ( index < nsize );
-  std::vector<unsigned int> neighbors = getNeighbors(index);
+  assert ( index < size() );
+  unsigned int last = size() - 1;
+  std::vector<unsigned int>          sources;
+  std::vector< Base_Edge<S,T>* >     edges;
+  _adjacency.rmVertex(index, sources, edges);
   
-  for(unsigned int i=0; i < neighbors.size(); i++)
-    if ( _nodes[ neighbors[i] ]->edges[index]!=NULL ) // edge from i to index
-    {
-      delete  _nodes[  neighbors[i] ]->edges[index];
-      _nodes[ neighbors[i] ]->edges[index]=NULL;   
-      _nodes[ neighbors[i] ]->num_connections--;
-    }  
+  for(unsigned int i=0; i < sources.size(); i++)
+    decConnections(sources[i]);                   // edge from sources[i] to index
   
-  for(unsigned int i=0; i < nsize; i++)
+  for(unsigned int i=0; i < edges.size(); i++)
+    deleteEdge(edges[i]);
+  
+  deleteNode(index);                                    // delete ptrs to the nodes
+  _slots[ _slotOf[index] ].generation++;                // invalidates the handles of the node
+  _isolated.erase(index);
+  _freeSlots.push_back(_slotOf[index]);
+
+  _nodes[index]  = _nodes[last];
+  _slotOf[index] = _slotOf[last];
+  _slots[ _slotOf[index] ].index = index;
+  _nodes.pop_back();
+  _slotOf.pop_back();
+  _weights.swapRemoveRow(index);
+  if (index < last)
   {
-    _nodes[ i ]->edges.erase( _nodes[ i ]->edges.begin() + index ); 
+    _nodes[index]->weight.bind(_weights.row(index), _dimNode);
+    _isolated.move(last, index);
+    moveNode(last, index);
   }
-  
-  delete _nodes[index];                                 // delete ptrs to the nodes
-  _nodes[index] = NULL;             
-  
-  _nodes.erase(_nodes.begin() + index);                 // erase node within the array 
- 
 }
 
+/** \brief returns a stable handle to the node given by the index
+*
+* \param index of the node
+*/
+template<typename T,typename S,typename A> inline NodeHandle Base_Graph<T,S,A>::getHandle(const unsigned int& index) const
+{
+  assert ( index < size() );
+  return NodeHandle(_slotOf[index], _slots[ _slotOf[index] ].generation);
+}
+
+/** \brief returns whether the node referred to by the handle is still in the graph
+*
+* \param handle of the node
+*/
+template<typename T,typename S,typename A> inline bool Base_Graph<T,S,A>::isValid(const NodeHandle& handle) const
+{
+  return handle.slot < _slots.size() && _slots[handle.slot].generation == handle.generation;
+}
+
+/** \brief returns the current index of the node referred to by the handle
+*
+* \param handle of a node that is still in the graph
+*/
+template<typename T,typename S,typename A> inline unsigned int Base_Graph<T,S,A>::getIndex(const NodeHandle& handle) const
+{
+  assert ( isValid(handle) );
+  return _slots[handle.slot].index;
+}
 
 /** \brief returns a vector of ints representing the indeces of the neighboring nodes
 *
 * \param index of the homie whose neighbors we are looking for
 */
-template<typename T,typename S> std::vector<unsigned int> Base_Graph<T,S>::getNeighbors(const unsigned int& index) const
+template<typename T,typename S,typename A> std::vector<unsigned int> Base_Graph<T,S,A>::getNeighbors(const unsigned int& index) const
 {
-  unsigned int nsize = size();
-  assert (index < nsize );
+  assert (index < size() );
 
   std::vector<unsigned int> result_v;
+  result_v.reserve(_adjacency.degree(index));
   int found_neighbors = 0;
   
-  for (unsigned int i=0; i < nsize /*&& found_neighbors < num_of_neighbors*/; i++)
-    if( _nodes[index]->edges[i] !=NULL && index!=i)
+  for (typename A::const_iterator it = _adjacency.begin(index); it != _adjacency.end(index); ++it)
+    if( it->index != index )
     {
-        result_v.push_back(i);   
+        result_v.push_back(it->index);   
         found_neighbors++;
     }
   //if the following is false, something must be wrong
@@ -581,14 +899,14 @@ template<typename T,typename S> std::vector<unsigned int> Base_Graph<T,S>::getNe
 /** \brief Returns neighbors set cardinality for some node
  * \param index
  */
-template<typename T,typename S> int Base_Graph<T,S>::getNeighborsSize(const unsigned int& index) const
+template<typename T,typename S,typename A> int Base_Graph<T,S,A>::getNeighborsSize(const unsigned int& index) const
 {
   assert ( index < size() );
   int num_of_neighbors = _nodes[index]->num_connections;
   int found_neighbors = 0;
 	
-  for (unsigned int i=0; i < size() /*&& found_neighbors < num_of_neighbors*/; i++)
-    if( _nodes[index]->edges[i] !=NULL && index!=i)
+  for (typename A::const_iterator it = _adjacency.begin(index); it != _adjacency.end(index); ++it)
+    if( it->index != index )
       found_neighbors++;
   //if the following is false, something must be wrong
   assert (found_neighbors <= num_of_neighbors);
@@ -601,7 +919,7 @@ template<typename T,typename S> int Base_Graph<T,S>::getNeighborsSize(const unsi
  *  \param index index of the node
  *  \param indices indices of the set of nodes
  */
-template<typename T, typename S> std::map<unsigned int, T> Base_Graph<T,S>::get1toMDistances (const unsigned int& index, std::vector<unsigned int>& indices)
+template<typename T,typename S,typename A> std::map<unsigned int, T> Base_Graph<T,S,A>::get1toMDistances (const unsigned int& index, std::vector<unsigned int>& indices)
 {
   assert ( index < size() );
   for (unsigned int i=0; i < indices.size(); i++ )
@@ -621,7 +939,7 @@ template<typename T, typename S> std::map<unsigned int, T> Base_Graph<T,S>::get1
 *
 * \param index is the index of the node in question for connectedness
 */
-template<typename T,typename S> inline bool Base_Graph<T,S>::isConnected(const unsigned int& index) const
+template<typename T,typename S,typename A> inline bool Base_Graph<T,S,A>::isConnected(const unsigned int& index) const
 {
  if ( index < size() ) 
      return ( _nodes[index]->num_connections > 0 ) ? true : false;
@@ -629,6 +947,47 @@ template<typename T,typename S> inline bool Base_Graph<T,S>::isConnected(const u
      return false; 
 }
 
+/** \brief removes the nodes without connections as long as the graph has more than min_size nodes
+*
+* The graph keeps the nodes without connections, thus only those are visited. They are
+* removed in the order of their indices, i.e. the same nodes are removed and the remaining
+* nodes get the same indices as if all nodes were visited in ascending order, removing
+* each isolated one. Since isolated nodes have no edges every removal is O(1) apart from
+* moving the weight vector of the last node.
+* \param min_size the number of nodes that is kept at least
+* \return number of removed nodes
+*/
+template<typename T,typename S,typename A> unsigned int Base_Graph<T,S,A>::rmIsolatedNodes(const unsigned int& min_size)
+{
+  unsigned int removed = 0;
+  while (!_isolated.empty() && size() > min_size)
+  {
+    rmNode(_isolated.top());
+    removed++;
+  }
+  return removed;
+}
+
+/** \brief increases the number of connections of a node
+*
+* \param index of the node
+*/
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::incConnections(const unsigned int& index)
+{
+  if (_nodes[index]->num_connections++ == 0)
+    _isolated.erase(index);
+}
+
+/** \brief decreases the number of connections of a node
+*
+* \param index of the node
+*/
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::decConnections(const unsigned int& index)
+{
+  if (--_nodes[index]->num_connections == 0)
+    _isolated.set(index, 0);
+}
+
 
 /** \brief applies the given func to all nodes
 *
@@ -636,7 +995,7 @@ template<typename T,typename S> inline bool Base_Graph<T,S>::isConnected(const u
 * is slower due to the range check.
 * \param func is a pointer to a function that shall be applied to all nodes
 */
-template<typename T,typename S> inline void Base_Graph<T,S>::applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float& value)
+template<typename T,typename S,typename A> void Base_Graph<T,S,A>::applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float& value)
 {
   unsigned int nsize = size();
   for(unsigned int i = 0; i < nsize; i++)
@@ -649,15 +1008,12 @@ template<typename T,typename S> inline void Base_Graph<T,S>::applyFunc2AllNodes(
 * is slower due to the range check.
 * \param func is a pointer to a function that shall be applied to all neighboring nodes
 */
-template<typename T,typename S> inline void Base_Graph<T,S>::applyFunc2Neighbors(const unsigned int& index,void (*func)(Base_Node<T,S>*,const float&),const float& value)
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::applyFunc2Neighbors(const unsigned int& index,void (*func)(Base_Node<T,S>*,const float&),const float& value)
 {
-  unsigned int nsize = size();
- 
-  if ( index < nsize )
+  if ( index < size() )
   {   
-    for (unsigned int i=0; i < nsize; i++)
-       if ( _nodes[index]->edges[i]!=NULL )
-          (*func)(_nodes[i],value);   //applies the func to the node since it is a neighbor          
+    for (typename A::const_iterator it = _adjacency.begin(index); it != _adjacency.end(index); ++it)
+          (*func)(_nodes[it->index],value);   //applies the func to the node since it is a neighbor          
   
   }
   
@@ -672,7 +1028,7 @@ template<typename T,typename S> inline void Base_Graph<T,S>::applyFunc2Neighbors
 * one has to take care before calling this function that to each node was
 * an update rule declared. Otherwise that will provoce unexpected progam behavior.
 */
-template<typename T,typename S> inline void Base_Graph<T,S>::update()
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::update()
 {
   unsigned int nsize = size();
   for(unsigned int i = 0; i < nsize; i++)
@@ -682,7 +1038,7 @@ template<typename T,typename S> inline void Base_Graph<T,S>::update()
 /** \brief returns the number of nodes currently in the graph
 *
 */
-template<typename T, typename S > inline unsigned int Base_Graph<T,S>::size(void) const
+template<typename T,typename S,typename A> inline unsigned int Base_Graph<T,S,A>::size(void) const
 {
  return _nodes.size();
 }
@@ -691,7 +1047,7 @@ template<typename T, typename S > inline unsigned int Base_Graph<T,S>::size(void
 /*! 
   \return the vector of nodes
 */
-template< typename T, typename S> inline std::vector< Base_Node<T,S>*, _NGPoolAlloc_ >* Base_Graph<T,S>::getNodes ()
+template<typename T,typename S,typename A> inline std::vector< Base_Node<T,S>*, _NGPoolAlloc_ >* Base_Graph<T,S,A>::getNodes ()
 {
 	return &_nodes;
 }
@@ -702,7 +1058,7 @@ template< typename T, typename S> inline std::vector< Base_Node<T,S>*, _NGPoolAl
 * \param x first vector
 * \param y second vector
 */
-template< typename T, typename S> T Base_Graph<T,S>::metric(const Vector<T>& x, const Vector<T>& y) const
+template<typename T,typename S,typename A> T Base_Graph<T,S,A>::metric(const Vector<T>& x, const Vector<T>& y) const
 {
  if (_metric_to_use==NULL) // is a non-standard metric set ?
    return euclidean<T,S> (x, y);
@@ -710,6 +1066,21 @@ template< typename T, typename S> T Base_Graph<T,S>::metric(const Vector<T>& x,
    return (this->*_metric_to_use)(x,y);   // use the non-standard user defined metric
 }  
 
+/** \brief metric between a vector and the weight vector of a node
+*
+* The pre-specified L2 euclidean metric is computed directly on the row of the weight matrix,
+* a user defined metric gets a copy of the weight vector.
+* \param x vector
+* \param y weight vector of a node
+*/
+template<typename T,typename S,typename A> inline T Base_Graph<T,S,A>::metric(const Vector<T>& x, const NodeWeight<T>& y) const
+{
+ if (_metric_to_use==NULL)
+   return euclidean<T,S> (x, y);
+ else
+   return (this->*_metric_to_use)(x,Vector<T>(y));
+}
+
 /** \brief Sets an user defined metric, used as distance of reference and data vector.
 *
 * The user can define an own metric to measure the distance or distortion of the reference vectors and the data vectors. 
@@ -723,12 +1094,12 @@ template< typename T, typename S> T Base_Graph<T,S>::metric(const Vector<T>& x,
 * metric is going to be used.
 * \param *metric_to_use is function ptr to an user defined metric
 */
-template < typename T, typename S > inline void Base_Graph<T,S>::setMetric(Metric metric_to_use=NULL )
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::setMetric(Metric metric_to_use=NULL )
 {
   _metric_to_use=metric_to_use;
 }
 
-template<typename T, typename S> inline void Base_Graph<T,S>::setHighLimits (Vector<T> high)
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::setHighLimits (Vector<T> high)
 {
 	high_limits = high;
 	high_limit = high_limits[0];
@@ -738,7 +1109,7 @@ template<typename T, typename S> inline void Base_Graph<T,S>::setHighLimits (Vec
 	
 }
 
-template<typename T, typename S> inline void Base_Graph<T,S>::setLowLimits (Vector<T> low)
+template<typename T,typename S,typename A> inline void Base_Graph<T,S,A>::setLowLimits (Vector<T> low)
 {
 	low_limits = low;
 	low_limit = low_limits[0];
@@ -748,14 +1119,40 @@ template<typename T, typename S> inline void Base_Graph<T,S>::setLowLimits (Vect
 	
 }
 
-template<typename T, typename S>
+template<typename T, typename S, typename A>
 template<class Archive>
 void 
-Base_Graph<T,S>::serialize(Archive & ar, const unsigned int /* file_version */) 
+Base_Graph<T,S,A>::serialize(Archive & ar, const unsigned int /* file_version */) 
 {
   ar & BOOST_SERIALIZATION_NVP(_nodes);
+  ar & BOOST_SERIALIZATION_NVP(_adjacency);
   ar & BOOST_SERIALIZATION_NVP(_dimNode);
   ar & BOOST_SERIALIZATION_NVP(_dimEdge);
+  if (Archive::is_loading::value)
+  {
+    // the loaded nodes store their weight vectors themselves, move them into the matrix
+    _weights.clear();
+    _weights.setDim(_dimNode);
+    _slotOf.clear();
+    _slots.clear();
+    _freeSlots.clear();
+    _isolated.clear();
+    for (unsigned int i = 0; i < size(); i++)
+    {
+      _weights.addRow();
+      addSlot();
+      if (_nodes[i]->num_connections == 0)
+        _isolated.set(i, 0);
+    }
+    bindWeights();
+    for (unsigned int i = 0; i < size(); i++)
+      for (typename A::const_iterator it = _adjacency.begin(i); it != _adjacency.end(i); ++it)
+      {
+        it->edge->in_handle  = getHandle(i);
+        it->edge->out_handle = getHandle(it->index);
+      }
+    indexEdges();
+  }
 }
 
 
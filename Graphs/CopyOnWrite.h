@@ -0,0 +1,82 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file CopyOnWrite.h
+* \brief Value shared by its copies until one of them is changed
+*
+*  \date    2026
+*/
+
+
+#ifndef COPYONWRITE_H
+#define COPYONWRITE_H
+
+#include <boost/shared_ptr.hpp>
+
+namespace neuralgas {
+
+/** \class CopyOnWrite
+ *  \brief Value that is shared by its copies until one of them is changed
+ *
+ * Copying a CopyOnWrite only shares the value, which is O(1). Reading is done by
+ * operator* and operator->, which never copy. Before changing the value write() has
+ * to be called, it copies the value if it is shared with another CopyOnWrite, thus
+ * a change is never seen by the copies. reset() replaces the value by a default
+ * constructed one without copying the old value.
+ * The graphs use it for large per node containers (errors, data indices), such that
+ * a graph snapshot only pays for the nodes that are changed after it was taken.
+ *
+ * \param _value shared value
+ */
+template<typename V> class CopyOnWrite
+{
+public:
+	//std cto creating a default constructed value
+	CopyOnWrite() : _value(new V) {}
+	//cto creating a copy of the given value
+	explicit CopyOnWrite(const V& value) : _value(new V(value)) {}
+	//returns the value for reading
+	inline const V&          operator*() const { return *_value; }
+	//returns the value for reading
+	inline const V*          operator->() const { return _value.get(); }
+	//returns the value for changing it, it is copied first if it is shared
+	inline V&                write();
+	//replaces the value by a default constructed one
+	inline void              reset() { _value.reset(new V); }
+	//returns whether the value is shared with another CopyOnWrite
+	inline bool              shared() const { return !_value.unique(); }
+
+private:
+	// shared value
+	boost::shared_ptr<V>     _value;
+};
+
+/** \brief returns the value for changing it
+*
+* If the value is shared it is copied first, the other CopyOnWrites keep the old value.
+*/
+template<typename V> inline V& CopyOnWrite<V>::write()
+{
+	if (!_value.unique())
+		_value.reset(new V(*_value));
+	return *_value;
+}
+
+} // namespace neuralgas
+
+#endif
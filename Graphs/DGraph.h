@@ -80,15 +80,16 @@ template < typename T , typename S > struct DNode : Base_Node<T,S>
  * and the virtual function newNode() has to be overloaded in the derived graph class such that 
  * it returns a pointer to that newly defined but derived node data type. 
  * The same holds for the edges.
+ * The third template parameter selects the adjacency backend of Base_Graph.
  *
  */
-template<typename T,typename S> class DGraph : public virtual Base_Graph<T,S>
+template<typename T,typename S,typename A = SparseAdjacency< Base_Edge<S,T> > > class DGraph : public virtual Base_Graph<T,S,A>
 {
   public:
     //cto creating a graph with the same dimension for node and edge weight vectors
-                               DGraph(const unsigned int& dim) : Base_Graph<T,S>(dim){}
+                               DGraph(const unsigned int& dim) : Base_Graph<T,S,A>(dim){}
     //cto creating a graph with the different dimension for node and edge weight vectors
-                               DGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge){}  
+                               DGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S,A>(dimNode,dimEdge){}  
     //std dto
                                ~DGraph(){}
     //returns whether the two nodes are connected by an edge
@@ -106,9 +107,9 @@ template<typename T,typename S> class DGraph : public virtual Base_Graph<T,S>
 
 /** \brief returns whether the two nodes are connected by an edge either from x to y or from y to x
 */
-template<typename T,typename S> inline bool DGraph<T,S>::areConnected(const unsigned int& x,const unsigned int& y)const
+template<typename T,typename S,typename A> inline bool DGraph<T,S,A>::areConnected(const unsigned int& x,const unsigned int& y)const
 {
-  return ( this->_nodes[x]->edges[y] != NULL && this->_nodes[y]->edges[x] != NULL);
+  return ( this->_adjacency.find(x,y) != NULL && this->_adjacency.find(y,x) != NULL);
 } 
 
 /** \brief Adds an edge between the nodes given by their indeces 
@@ -120,16 +121,19 @@ template<typename T,typename S> inline bool DGraph<T,S>::areConnected(const unsi
 *   \param x outgoing node
 *   \param y ingoing node
 */
-template<typename T,typename S> void DGraph<T,S>::addEdge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void DGraph<T,S,A>::addEdge(const unsigned int& x,const unsigned int& y)
 {
 
-  if ( this->_nodes[x]->edges[y] == NULL ) //self edges are allowed
+  if ( this->_adjacency.find(x,y) == NULL ) //self edges are allowed
   {
     Base_Edge<S,T>* new_edge = this->newEdge();
     new_edge->in             = this->_nodes[x];
     new_edge->out            = this->_nodes[y];
-    new_edge->weight.resize(this->_dimEdge);
-    this->_nodes[x]->edges[y]    =  new_edge;   
+    new_edge->in_handle      = this->getHandle(x);
+    new_edge->out_handle     = this->getHandle(y);
+    if (this->_dimEdge > 0)
+      new_edge->weight.resize(this->_dimEdge);
+    this->_adjacency.link(x, y, new_edge);
 
     (static_cast< DNode<T,S>* >(this->_nodes[x]))->incOutEdges(); 
     (static_cast< DNode<T,S>* >(this->_nodes[y]))->incInEdges(); 
@@ -146,12 +150,12 @@ template<typename T,typename S> void DGraph<T,S>::addEdge(const unsigned int& x,
 *   \param x outgoing node
 *   \param y ingoing node
 */
-template<typename T,typename S> void DGraph<T,S>::rmEdge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void DGraph<T,S,A>::rmEdge(const unsigned int& x,const unsigned int& y)
 {
-  if ( this->_nodes[x]->edges[y] != NULL ) //self edges are allowed
+  Base_Edge<S,T>* edge = this->_adjacency.unlink(x,y);
+  if ( edge != NULL ) //self edges are allowed
   {
-    delete this->_nodes[x]->edges[y];
-    this->_nodes[x]->edges[y]     =  NULL;
+    this->deleteEdge(edge);
 
     (static_cast< DNode<T,S>* >(this->_nodes[x]))->decOutEdges(); 
     (static_cast< DNode<T,S>* >(this->_nodes[y]))->decInEdges();     
@@ -170,13 +174,13 @@ template<typename T,typename S> void DGraph<T,S>::rmEdge(const unsigned int& x,c
 * addEdge(),resulting in the use of the used defined edge type as edge for the graph structure.
 */
 
-template<typename T,typename S> DNode<T,S>* DGraph<T,S>::newNode()
+template<typename T,typename S,typename A> DNode<T,S>* DGraph<T,S,A>::newNode()
 {
   DNode<T,S>* n = new DNode<T,S>;
   return n;
 }
 
-template<typename T,typename S> inline void DGraph<T,S>::getID()
+template<typename T,typename S,typename A> inline void DGraph<T,S,A>::getID()
 {
   std::cout << typeid((*this)[0]).name()<<std::endl;
 }  
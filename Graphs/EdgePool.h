@@ -0,0 +1,126 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file EdgePool.h
+* \brief Slab allocator the edges of the graphs are taken from
+*
+*  \date    2026
+*/
+
+
+#ifndef EDGEPOOL_H
+#define EDGEPOOL_H
+
+#include <new>
+#include <cstddef>
+#include <boost/pool/singleton_pool.hpp>
+
+namespace neuralgas {
+
+/** \brief tag of the singleton pools the edges are taken from
+*/
+struct EdgePoolTag {};
+
+/** \class EdgeSlab
+ *  \brief Fixed size pool for the edges of one size class
+ *
+ * \param C size class, the pool hands out blocks of C * G bytes
+ * \param G granularity of the size classes in bytes
+ */
+template<unsigned int C, unsigned int G> struct EdgeSlab
+{
+	typedef boost::singleton_pool<EdgePoolTag, C * G> Pool;
+	/// returns a block of the size class
+	static inline void* allocate()
+	{
+		void* p = Pool::malloc();
+		if (p == NULL)
+			throw std::bad_alloc();
+		return p;
+	}
+	/// returns a block to the pool
+	static inline void deallocate(void* p) { Pool::free(p); }
+};
+
+/** \class EdgePool
+ *  \brief Slab allocator for the edges of the graphs
+ *
+ * Edges are created and deleted in every learning step (setAge adds missing edges,
+ * rmOldEdges removes them), therefore they are not taken from the general purpose heap.
+ * Requests up to maxSize bytes are rounded up to a multiple of granularity and served
+ * from a fixed size pool per size class, larger ones fall back to the heap.
+ * The pools are shared by all graphs and keep their memory for later edges.
+ */
+class EdgePool
+{
+public:
+	enum { granularity = 16, classes = 8, maxSize = granularity * classes };
+	// returns a block of at least the given size
+	static inline void* allocate(const std::size_t&);
+	// returns a block obtained by allocate with the same size
+	static inline void  deallocate(void*, const std::size_t&);
+};
+
+/** \brief returns a block of at least the given size
+*
+* \param size number of bytes, i.e. the size of the edge type
+*/
+inline void* EdgePool::allocate(const std::size_t& size)
+{
+	switch ((size + granularity - 1) / granularity)
+	{
+		case 0:
+		case 1: return EdgeSlab<1, granularity>::allocate();
+		case 2: return EdgeSlab<2, granularity>::allocate();
+		case 3: return EdgeSlab<3, granularity>::allocate();
+		case 4: return EdgeSlab<4, granularity>::allocate();
+		case 5: return EdgeSlab<5, granularity>::allocate();
+		case 6: return EdgeSlab<6, granularity>::allocate();
+		case 7: return EdgeSlab<7, granularity>::allocate();
+		case 8: return EdgeSlab<8, granularity>::allocate();
+		default: return ::operator new(size);
+	}
+}
+
+/** \brief returns a block obtained by allocate with the same size
+*
+* \param p block to be released, may be NULL
+* \param size number of bytes that were requested from allocate
+*/
+inline void EdgePool::deallocate(void* p, const std::size_t& size)
+{
+	if (p == NULL)
+		return;
+	switch ((size + granularity - 1) / granularity)
+	{
+		case 0:
+		case 1: EdgeSlab<1, granularity>::deallocate(p); break;
+		case 2: EdgeSlab<2, granularity>::deallocate(p); break;
+		case 3: EdgeSlab<3, granularity>::deallocate(p); break;
+		case 4: EdgeSlab<4, granularity>::deallocate(p); break;
+		case 5: EdgeSlab<5, granularity>::deallocate(p); break;
+		case 6: EdgeSlab<6, granularity>::deallocate(p); break;
+		case 7: EdgeSlab<7, granularity>::deallocate(p); break;
+		case 8: EdgeSlab<8, granularity>::deallocate(p); break;
+		default: ::operator delete(p);
+	}
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file FrozenGraph.h
+* \brief Immutable CSR snapshot of a graph for inference
+*
+*  \date    2026
+*/
+
+
+#ifndef FROZENGRAPH_H
+#define FROZENGRAPH_H
+
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <cassert>
+#include "Base_Graph.h"
+#include "TGraph.h"
+#include <tools/distanceKernels.h>
+
+namespace neuralgas {
+
+/** \class FrozenGraph
+ *  \brief Immutable snapshot of a graph for inference
+ *
+ * The snapshot is taken from any Base_Graph once training is done and is read only
+ * afterwards, thus one instance can be shared by several threads answering queries.
+ * The weight vectors are copied into a contiguous matrix with the same padded rows
+ * as the graph, the edges are stored in compressed sparse row form: the neighbors of
+ * node i are _neighbors[_offsets[i]] ... _neighbors[_offsets[i+1]-1].
+ * If the edges of the graph are timed edges their ages are stored along the neighbors.
+ * Per node scalars (error, restricting distance) that are kept in the derived graphs
+ * can be handed over to the cto, e.g. by GNGGraph::getErrors.
+ * Building the snapshot is O(N*D + E).
+ *
+ * \param _weights weight vectors of the nodes, row i belongs to node i
+ * \param _offsets first position of the neighbors of every node in _neighbors, N+1 entries
+ * \param _neighbors indices of the adjacent nodes of all nodes
+ * \param _ages ages of the edges leading to the entries of _neighbors, empty if the edges are untimed
+ * \param _hasAges whether the edges are timed
+ * \param _errors error of every node, empty if none was given
+ * \param _restrictingDistances restricting distance of every node, empty if none was given
+ */
+template<typename T> class FrozenGraph
+{
+public:
+	//cto taking a snapshot of the given graph and the given per node scalars
+	template<typename S,typename A>
+	FrozenGraph(const Base_Graph<T,S,A>&, const std::vector<T>* errors = NULL, const std::vector<T>* restricting_distances = NULL);
+	//returns the number of nodes
+	inline unsigned int        size() const { return _weights.rows(); }
+	//returns the dimension of the weight vectors
+	inline unsigned int        dim() const { return _weights.dim(); }
+	//returns the weight vector of the given node
+	inline const T*            row(const unsigned int& index) const { return _weights.row(index); }
+	//returns the weight matrix
+	inline const WeightMatrix<T>& weights() const { return _weights; }
+	//returns the number of neighbors of the given node
+	inline unsigned int        degree(const unsigned int& index) const { return _offsets[index + 1] - _offsets[index]; }
+	//returns the number of stored adjacency entries
+	inline unsigned int        numEntries() const { return _neighbors.size(); }
+	//returns a ptr to the first neighbor of the given node
+	inline const unsigned int* neighborsBegin(const unsigned int& index) const { return begin(_neighbors, index); }
+	//returns a ptr behind the last neighbor of the given node
+	inline const unsigned int* neighborsEnd(const unsigned int& index) const { return begin(_neighbors, index) + degree(index); }
+	//returns whether the ages of the edges are stored
+	inline bool                hasAges() const { return _hasAges; }
+	//returns a ptr to the age of the edge leading to the first neighbor of the given node
+	inline const unsigned int* agesBegin(const unsigned int& index) const { assert(hasAges()); return begin(_ages, index); }
+	//returns whether the errors of the nodes are stored
+	inline bool                hasErrors() const { return !_errors.empty(); }
+	//returns the error of the given node
+	inline const T&            error(const unsigned int& index) const { assert(hasErrors()); return _errors[index]; }
+	//returns whether the restricting distances of the nodes are stored
+	inline bool                hasRestrictingDistances() const { return !_restrictingDistances.empty(); }
+	//returns the restricting distance of the given node
+	inline const T&            restrictingDistance(const unsigned int& index) const { assert(hasRestrictingDistances()); return _restrictingDistances[index]; }
+	//determines the two winner nodes for the given item like GNGModulGraph::getWinner
+	T                          getWinner(unsigned int&, unsigned int&, const Vector<T>&) const;
+
+private:
+	// copying would copy the whole snapshot, share it by reference instead
+	FrozenGraph(const FrozenGraph&);
+	FrozenGraph& operator=(const FrozenGraph&);
+	//returns a ptr to the entry of the first neighbor of the given node within the given array
+	inline const unsigned int* begin(const std::vector<unsigned int>& v, const unsigned int& index) const
+	{ return v.empty() ? NULL : &v[0] + _offsets[index]; }
+	// weight vectors of the nodes
+	WeightMatrix<T>            _weights;
+	// first position of the neighbors of every node, N+1 entries
+	std::vector<unsigned int>  _offsets;
+	// indices of the adjacent nodes
+	std::vector<unsigned int>  _neighbors;
+	// ages of the edges leading to the adjacent nodes
+	std::vector<unsigned int>  _ages;
+	// whether the edges are timed
+	bool                       _hasAges;
+	// error of every node
+	std::vector<T>             _errors;
+	// restricting distance of every node
+	std::vector<T>             _restrictingDistances;
+};
+
+/** \brief cto taking a snapshot of the given graph
+*
+* The ages are stored if every edge of the graph is a TEdge.
+* \param graph whose nodes and edges are copied
+* \param errors error of every node, ignored if NULL
+* \param restricting_distances restricting distance of every node, ignored if NULL
+*/
+template<typename T> template<typename S,typename A>
+FrozenGraph<T>::FrozenGraph(const Base_Graph<T,S,A>& graph, const std::vector<T>* errors, const std::vector<T>* restricting_distances)
+{
+  const unsigned int n   = graph.size();
+  const WeightMatrix<T>& w = graph.weights();
+  const A& adjacency     = graph.adjacency();
+  _weights.setDim(w.dim());
+  for (unsigned int i = 0; i < n; i++)
+  {
+    _weights.addRow();
+    std::memcpy(_weights.row(i), w.row(i), w.dim() * sizeof(T));
+  }
+  _offsets.resize(n + 1);
+  _offsets[0] = 0;
+  for (unsigned int i = 0; i < n; i++)
+    _offsets[i + 1] = _offsets[i] + adjacency.degree(i);
+  _neighbors.reserve(_offsets[n]);
+  _ages.reserve(_offsets[n]);
+  _hasAges = true;
+  for (unsigned int i = 0; i < n; i++)
+    for (typename A::const_iterator it = adjacency.begin(i); it != adjacency.end(i); ++it)
+    {
+      _neighbors.push_back(it->index);
+      const TEdge<S,T>* edge = _hasAges ? dynamic_cast< const TEdge<S,T>* >(it->edge) : NULL;
+      if (edge != NULL)
+        _ages.push_back(edge->age);
+      else
+        _hasAges = false;
+    }
+  assert (_neighbors.size() == _offsets[n]);
+  if (!_hasAges)
+    std::vector<unsigned int>().swap(_ages);
+  if (errors != NULL)
+  {
+    assert (errors->size() == n);
+    _errors = *errors;
+  }
+  if (restricting_distances != NULL)
+  {
+    assert (restricting_distances->size() == n);
+    _restrictingDistances = *restricting_distances;
+  }
+}
+
+/** \brief determines for the given item the two most similar nodes
+*
+* The weight matrix is scanned by nearestTwo like GNGModulGraph::getWinner does with the
+* pre-specified metric, thus both return the same winners for the same graph.
+* \param first_winner after func call the closest node
+* \param second_winner after func call the node that was closest before first_winner was found
+* \param item data vector
+* \return distance of the item to the first winner
+*/
+template<typename T>
+T FrozenGraph<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item) const
+{
+  assert (item.size() == dim());
+  return nearestTwo<T> (&item[0], _weights, first_winner, second_winner);
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file IndexedMaxHeap.h
+* \brief Binary max-heap over ids with a changeable key per id
+*
+*  \date    2026
+*/
+
+
+#ifndef INDEXEDMAXHEAP_H
+#define INDEXEDMAXHEAP_H
+
+#include <vector>
+#include <cassert>
+
+namespace neuralgas {
+
+/** \class IndexedMaxHeap
+ *  \brief Binary max-heap over ids with a changeable key per id
+ *
+ * The graphs use the heap for selecting the node with the maximal value of a node attribute
+ * (error, counter, insertion criterion) without scanning all nodes. The ids are the indices
+ * of the nodes, when a node is moved to another index its id is changed by move.
+ * An id may or may not be in the heap, set inserts it or changes its key in O(log n),
+ * top is O(1). Equal keys are ordered by their id, the smaller id is on top, thus top
+ * returns the same node as a linear scan for the first maximum.
+ *
+ * \param _heap ids in heap order
+ * \param _keys key of every id in the heap
+ * \param _pos position of every id in _heap, npos if the id is not in the heap
+ */
+template<typename K> class IndexedMaxHeap
+{
+public:
+	enum { npos = ~0u };
+	// returns whether the id is in the heap
+	bool                     contains(const unsigned int& id) const {return id < _pos.size() && _pos[id] != npos;}
+	// returns the number of ids in the heap
+	unsigned int             size() const {return _heap.size();}
+	// returns whether the heap is empty
+	bool                     empty() const {return _heap.empty();}
+	// returns the id with the maximal key
+	unsigned int             top() const {assert(!empty()); return _heap[0];}
+	// returns the maximal key
+	const K&                 topKey() const {assert(!empty()); return _keys[_heap[0]];}
+	// returns the key of an id in the heap
+	const K&                 key(const unsigned int& id) const {assert(contains(id)); return _keys[id];}
+	// inserts the id or changes its key
+	void                     set(const unsigned int&, const K&);
+	// removes the id if it is in the heap
+	void                     erase(const unsigned int&);
+	// gives the entry of an id to another id that is not in the heap
+	void                     move(const unsigned int&, const unsigned int&);
+	// multiplies all keys by a non negative factor, the order is kept
+	void                     scale(const K&);
+	// removes all ids
+	void                     clear();
+
+private:
+	// returns whether the id at position a has to be above the id at position b
+	inline bool              above(const unsigned int& a, const unsigned int& b) const;
+	// swaps the ids at the given positions
+	inline void              swapAt(const unsigned int&, const unsigned int&);
+	// moves the id at the given position up as far as needed
+	void                     siftUp(unsigned int);
+	// moves the id at the given position down as far as needed
+	void                     siftDown(unsigned int);
+	// ids in heap order
+	std::vector<unsigned int> _heap;
+	// key of every id
+	std::vector<K>           _keys;
+	// position of every id in _heap
+	std::vector<unsigned int> _pos;
+};
+
+/** \brief inserts the id with the given key or changes the key of the id
+*
+* \param id to be set
+* \param value new key of the id
+*/
+template<typename K> void IndexedMaxHeap<K>::set(const unsigned int& id, const K& value)
+{
+	if (id >= _pos.size())
+	{
+		_pos.resize(id + 1, npos);
+		_keys.resize(id + 1);
+	}
+	if (_pos[id] == npos)
+	{
+		_keys[id] = value;
+		_pos[id]  = _heap.size();
+		_heap.push_back(id);
+		siftUp(_pos[id]);
+	}
+	else if (value > _keys[id])
+	{
+		_keys[id] = value;
+		siftUp(_pos[id]);
+	}
+	else if (value < _keys[id])
+	{
+		_keys[id] = value;
+		siftDown(_pos[id]);
+	}
+}
+
+/** \brief removes the id from the heap, nothing is done if it is not in the heap
+*
+* \param id to be removed
+*/
+template<typename K> void IndexedMaxHeap<K>::erase(const unsigned int& id)
+{
+	if (!contains(id))
+		return;
+	unsigned int p    = _pos[id];
+	unsigned int last = _heap.size() - 1;
+	if (p != last)
+	{
+		swapAt(p, last);
+		_heap.pop_back();
+		_pos[id] = npos;
+		siftUp(p);
+		siftDown(p);
+	}
+	else
+	{
+		_heap.pop_back();
+		_pos[id] = npos;
+	}
+}
+
+/** \brief gives the entry of an id to another id that is not in the heap
+*
+* Nothing is done if the first id is not in the heap.
+* \param from id whose entry is moved
+* \param to new id of the entry
+*/
+template<typename K> void IndexedMaxHeap<K>::move(const unsigned int& from, const unsigned int& to)
+{
+	assert (!contains(to));
+	if (!contains(from))
+		return;
+	if (to >= _pos.size())
+	{
+		_pos.resize(to + 1, npos);
+		_keys.resize(to + 1);
+	}
+	unsigned int p = _pos[from];
+	_keys[to]  = _keys[from];
+	_pos[to]   = p;
+	_pos[from] = npos;
+	_heap[p]   = to;
+	siftUp(p);
+	siftDown(_pos[to]);
+}
+
+/** \brief multiplies all keys by a non negative factor
+*
+* A non negative factor keeps the order of the keys, thus the heap is not reordered.
+* \param factor by which the keys are multiplied
+*/
+template<typename K> void IndexedMaxHeap<K>::scale(const K& factor)
+{
+	assert (!(factor < 0));
+	for (unsigned int i = 0; i < _heap.size(); i++)
+		_keys[_heap[i]] *= factor;
+}
+
+/** \brief removes all ids
+*/
+template<typename K> void IndexedMaxHeap<K>::clear()
+{
+	_heap.clear();
+	_keys.clear();
+	_pos.clear();
+}
+
+/** \brief returns whether the id at position a has to be above the id at position b
+*/
+template<typename K> inline bool IndexedMaxHeap<K>::above(const unsigned int& a, const unsigned int& b) const
+{
+	const K& ka = _keys[_heap[a]];
+	const K& kb = _keys[_heap[b]];
+	return kb < ka || (!(ka < kb) && _heap[a] < _heap[b]);
+}
+
+/** \brief swaps the ids at the given positions
+*/
+template<typename K> inline void IndexedMaxHeap<K>::swapAt(const unsigned int& a, const unsigned int& b)
+{
+	unsigned int id = _heap[a];
+	_heap[a] = _heap[b];
+	_heap[b] = id;
+	_pos[_heap[a]] = a;
+	_pos[_heap[b]] = b;
+}
+
+/** \brief moves the id at the given position up as far as needed
+*/
+template<typename K> void IndexedMaxHeap<K>::siftUp(unsigned int p)
+{
+	while (p > 0)
+	{
+		unsigned int parent = (p - 1) / 2;
+		if (!above(p, parent))
+			break;
+		swapAt(p, parent);
+		p = parent;
+	}
+}
+
+/** \brief moves the id at the given position down as far as needed
+*/
+template<typename K> void IndexedMaxHeap<K>::siftDown(unsigned int p)
+{
+	unsigned int n = _heap.size();
+	for (;;)
+	{
+		unsigned int best  = p;
+		unsigned int left  = 2 * p + 1;
+		unsigned int right = left + 1;
+		if (left < n && above(left, best))
+			best = left;
+		if (right < n && above(right, best))
+			best = right;
+		if (best == p)
+			break;
+		swapAt(p, best);
+		p = best;
+	}
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,336 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file PartialDistanceSearch.h
+* \brief Exact winner search abandoning the distance of a node early
+*
+*  \date    2026
+*/
+
+
+#ifndef PARTIALDISTANCESEARCH_H
+#define PARTIALDISTANCESEARCH_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <math.h>
+#include "WeightMatrix.h"
+#include <tools/distanceKernels.h>
+
+namespace neuralgas {
+
+/** \class PartialDistanceSearch
+ *  \brief Exact nearest node search abandoning the distance of a node early
+ *
+ * The squared distances of a group of nodes are accumulated block by block of _blockSize
+ * dimensions by addSquaredDistances, i.e. by the vectorized kernels. After every block
+ * the nodes whose partial sum reached the squared distance of the current first winner
+ * are abandoned, they cannot become the first winner. While many nodes of the group are
+ * left the block is added to the whole group, otherwise node by node to the ones left.
+ * A node that is not abandoned has its root taken, which is compared like the scan does.
+ * The block size is rounded up to the elements in WeightMatrix::alignment bytes, such
+ * that the kernels start every block at the beginning of a vector.
+ *
+ * The search pays off for clustered data of 32 and more dimensions, where most nodes are
+ * abandoned after the first blocks. For few dimensions or for uniformly spread data the
+ * scan is faster. Passes over many items, e.g. ErrorTesting::calcErrors and
+ * LLRGNGAlgorithm::calculateModelEfficiency, use GNGModulGraph::assignBatch instead,
+ * which is faster still.
+ *
+ * The dimensions are added in ascending order, then the partial sums are prefixes of the
+ * sum of euclidean and abandoning never changes the winners. Optionally the dimensions
+ * are visited in descending order of the variance of the data (see setOrder), which lets
+ * the sums grow faster. The sums then differ from euclidean by rounding, so a node is
+ * only abandoned by a margin of the rounding error and the distance of a node that is not
+ * abandoned is accumulated again in ascending order. The ordered sums are plain C++ loops
+ * node by node, unless the kernels are scalar (see simdLevel) the ascending order is faster.
+ *
+ * getWinner returns the same winners and distance as the scan of GNGModulGraph::getWinner
+ * with the pre-specified metric. The counters tell the fraction of skipped dimensions.
+ * Copies only share the settings, the counters start empty.
+ *
+ * \param _blockSize number of dimensions accumulated between two checks, 0 disables the search
+ * \param _order dimensions in the order they are accumulated, empty for ascending order
+ * \param _stats counters of the searches
+ */
+template<typename T> class PartialDistanceSearch
+{
+public:
+	/// counters of the searches
+	struct Stats
+	{
+		Stats() : rows(0), dimensions(0), accumulated(0) {}
+		// fraction of the dimensions that were skipped
+		double skipped() const { return dimensions ? 1.0 - double(accumulated) / dimensions : 0.0; }
+		// number of rows whose distance was considered
+		unsigned long rows;
+		// number of dimensions a full computation of the distances would have added
+		unsigned long dimensions;
+		// number of dimensions that were added, including the ones added again in ascending order
+		unsigned long accumulated;
+	};
+	//std cto, the search is disabled
+	PartialDistanceSearch() : _blockSize(0) {}
+	//copy cto copying the settings only
+	PartialDistanceSearch(const PartialDistanceSearch& p) : _blockSize(p._blockSize), _order(p._order) {}
+	//assignment copying the settings only
+	PartialDistanceSearch& operator=(const PartialDistanceSearch&);
+	//sets the number of dimensions between two checks, 0 disables the search
+	void                     setBlockSize(const unsigned int& size) { _blockSize = size; }
+	//orders the dimensions by descending variance, an empty vector restores the ascending order
+	void                     setOrder(const Vector<T>&);
+	//returns whether the search is enabled
+	inline bool              enabled() const { return _blockSize > 0; }
+	//returns the number of dimensions between two checks
+	inline unsigned int      blockSize() const { return _blockSize; }
+	//returns whether the dimensions are ordered by variance
+	inline bool              ordered() const { return !_order.empty(); }
+	//returns the counters
+	inline const Stats&      stats() const { return _stats; }
+	//resets the counters
+	inline void              resetStats() { _stats = Stats(); }
+	//determines the two winner rows of the weight matrix for an item
+	T                        getWinner(unsigned int&, unsigned int&, const T*, const WeightMatrix<T>&);
+
+private:
+	// number of nodes whose distances are accumulated at once, below a share of 1/single live nodes
+	// of a group the blocks are added node by node instead of to the whole group
+	enum { group = 64, single = 4 };
+	//determines the two winner rows accumulating the dimensions in the order of the variances
+	T                        getWinnerOrdered(unsigned int&, unsigned int&, const T*, const WeightMatrix<T>&);
+	//accumulates the squared distance in ascending order, returns false if it reaches the bound
+	bool                     accumulate(const T*, const T*, const unsigned int&, const T&, T&);
+	//accumulates the squared distance in the order of the variances, returns false if it surely reaches the bound
+	bool                     accumulateOrdered(const T*, const T*, const unsigned int&, const T&);
+	unsigned int             _blockSize;
+	std::vector<unsigned int> _order;
+	Stats                    _stats;
+};
+
+/** \brief assignment copying the settings only
+*/
+template<typename T> PartialDistanceSearch<T>& PartialDistanceSearch<T>::operator=(const PartialDistanceSearch& p)
+{
+	_blockSize = p._blockSize;
+	_order     = p._order;
+	return *this;
+}
+
+/** \brief orders the dimensions by descending variance of the data
+*
+* Dimensions with a large variance contribute most to the distances, adding them first
+* lets the node be abandoned after fewer dimensions. Equal variances keep ascending order.
+*
+* \param variances variance of every dimension, an empty vector restores the ascending order
+*/
+template<typename T> void PartialDistanceSearch<T>::setOrder(const Vector<T>& variances)
+{
+	std::vector< std::pair<T,unsigned int> > keys (variances.size());
+	for (unsigned int k = 0; k < variances.size(); k++)
+		keys[k] = std::make_pair(-variances[k], k);
+	std::sort(keys.begin(), keys.end());
+	_order.resize(keys.size());
+	for (unsigned int k = 0; k < keys.size(); k++)
+		_order[k] = keys[k].second;
+}
+
+/** \brief determines the two winner rows of the weight matrix for an item
+*
+* \param first_winner after func call the closest row, the smallest index among equally close ones
+* \param second_winner after func call the row that was closest before first_winner was found
+* \param x item, dim elements
+* \param weights weight matrix
+* \return euclidean distance of the item to the first winner
+*/
+template<typename T> T PartialDistanceSearch<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const T* x, const WeightMatrix<T>& weights)
+{
+	const unsigned int dim  = weights.dim();
+	const unsigned int rows = weights.rows();
+	const unsigned int unit = WeightMatrix<T>::alignment / sizeof(T);
+	const unsigned int block = (_blockSize + unit - 1) / unit * unit;
+	T best_distance = std::numeric_limits<T>::max();
+	T best_squared  = std::numeric_limits<T>::max();
+	T squared[group];
+
+	assert (enabled());
+	if (!_order.empty())
+		return getWinnerOrdered(first_winner, second_winner, x, weights);
+	first_winner  = 1;
+	second_winner = 0;
+	_stats.rows       += rows;
+	_stats.dimensions += (unsigned long) rows * dim;
+
+	for (unsigned int begin = 0; begin < rows; begin += group)
+	{
+		const unsigned int count = (rows - begin < group) ? rows - begin : (unsigned int) group;
+		unsigned int live[group];
+		unsigned int n = count;
+		for (unsigned int i = 0; i < count; i++)
+			live[i] = i;
+		for (unsigned int k = 0; k < dim && n > 0;)
+		{
+			const unsigned int end = (dim - k < block) ? dim : k + block;
+			if (n * single > count)
+			{
+				addSquaredDistances<T> (x, weights, begin, count, k, end, squared);
+				_stats.accumulated += (unsigned long) count * (end - k);
+			}
+			else
+			{
+				for (unsigned int j = 0; j < n; j++)
+					addSquaredDistances<T> (x, weights, begin + live[j], 1, k, end, squared + live[j]);
+				_stats.accumulated += (unsigned long) n * (end - k);
+			}
+			k = end;
+			unsigned int m = 0;
+			for (unsigned int j = 0; j < n; j++)
+				if (squared[live[j]] < best_squared)
+					live[m++] = live[j];
+			n = m;
+		}
+		for (unsigned int j = 0; j < n; j++)
+		{
+			const unsigned int i = live[j];
+			if (squared[i] < best_squared)
+			{
+				// different squares may have the same root
+				const T distance = T(sqrt(squared[i]));
+				if (distance < best_distance)
+				{
+					second_winner = first_winner;
+					first_winner  = begin + i;
+					best_distance = distance;
+					best_squared  = squared[i];
+				}
+			}
+		}
+	}
+	return best_distance;
+}
+
+/** \brief determines the two winner rows accumulating the dimensions in the order of the variances
+*
+* \param first_winner after func call the closest row, the smallest index among equally close ones
+* \param second_winner after func call the row that was closest before first_winner was found
+* \param x item, dim elements
+* \param weights weight matrix
+* \return euclidean distance of the item to the first winner
+*/
+template<typename T> T PartialDistanceSearch<T>::getWinnerOrdered(unsigned int& first_winner, unsigned int& second_winner, const T* x, const WeightMatrix<T>& weights)
+{
+	const unsigned int dim = weights.dim();
+	T best_distance = std::numeric_limits<T>::max();
+	T best_squared  = std::numeric_limits<T>::max();
+	T squared;
+
+	assert (_order.size() == dim);
+	first_winner  = 1;
+	second_winner = 0;
+	_stats.rows       += weights.rows();
+	_stats.dimensions += (unsigned long) weights.rows() * dim;
+
+	for (unsigned int j = 0; j < weights.rows(); j++)
+	{
+		const T* y = weights.row(j);
+		if (!accumulateOrdered(x, y, dim, best_squared))
+			continue;
+		if (!accumulate(x, y, dim, best_squared, squared))
+			continue;
+		// different squares may have the same root
+		const T distance = T(sqrt(squared));
+		if (distance < best_distance)
+		{
+			second_winner = first_winner;
+			first_winner  = j;
+			best_distance = distance;
+			best_squared  = squared;
+		}
+	}
+	return best_distance;
+}
+
+/** \brief accumulates the squared distance in ascending order of the dimensions
+*
+* Adding non-negative terms never decreases a sum, thus the full sum is at least any
+* partial sum and the root of the full sum is at least the root of the bound.
+*
+* \param x item
+* \param y row of the weight matrix
+* \param dim number of dimensions
+* \param bound squared distance of the current first winner
+* \param squared after func call the squared distance if it stays below the bound
+* \return false if the partial sum reached the bound
+*/
+template<typename T> inline bool PartialDistanceSearch<T>::accumulate(const T* x, const T* y, const unsigned int& dim, const T& bound, T& squared)
+{
+	T sum = 0;
+	unsigned int k = 0;
+	while (k < dim)
+	{
+		const unsigned int end = (dim - k < _blockSize) ? dim : k + _blockSize;
+		for (; k < end; k++)
+		{
+			const T value = x[k] - y[k];
+			sum += value * value;
+		}
+		if (sum >= bound)
+		{
+			_stats.accumulated += k;
+			return false;
+		}
+	}
+	_stats.accumulated += dim;
+	squared = sum;
+	return true;
+}
+
+/** \brief accumulates the squared distance in the order of the variances
+*
+* The partial sum is compared with the bound reduced by the rounding error of both
+* summation orders, it only rejects nodes whose sum in ascending order reaches the bound.
+*
+* \return false if the partial sum surely reached the bound
+*/
+template<typename T> inline bool PartialDistanceSearch<T>::accumulateOrdered(const T* x, const T* y, const unsigned int& dim, const T& bound)
+{
+	const T margin = 1 - 8 * dim * std::numeric_limits<T>::epsilon();
+	T sum = 0;
+	unsigned int k = 0;
+	while (k < dim)
+	{
+		const unsigned int end = (dim - k < _blockSize) ? dim : k + _blockSize;
+		for (; k < end; k++)
+		{
+			const T value = x[_order[k]] - y[_order[k]];
+			sum += value * value;
+		}
+		if (sum * margin >= bound)
+		{
+			_stats.accumulated += k;
+			return false;
+		}
+	}
+	_stats.accumulated += dim;
+	return true;
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file QuantizedPrefilter.h
+* \brief Approximate winner search scanning an 8 bit copy of the weights
+*
+*  \date    2026
+*/
+
+
+#ifndef QUANTIZEDPREFILTER_H
+#define QUANTIZEDPREFILTER_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <math.h>
+#include <tools/metrics.h>
+#include <tools/distanceKernels.h>
+#include "WeightMatrix.h"
+
+namespace neuralgas {
+
+/** \class QuantizedPrefilter
+ *  \brief Approximate winner search scanning an 8 bit copy of the weights
+ *
+ * Every weight is stored as a signed 8 bit code relative to the center of the range of
+ * its dimension, w = _center + code * _scale, thus a scan reads an eighth of the memory of
+ * the double weights. The item is quantized the same way and the _candidates nodes whose
+ * codes are closest to the codes of the item (see quantizedDistances) are compared by
+ * euclidean on the weights.
+ * The first winner is the closest candidate, the second winner the closest candidate
+ * with a smaller index, like the scan of GNGModulGraph::getWinner restricted to the
+ * candidates.
+ *
+ * The ranges of the dimensions get _headroom times their span on both sides when the
+ * codes are built. Changed weights are announced by weightChanged and quantized again,
+ * if a weight leaves its range all codes are rebuilt by the next search. Added nodes are
+ * quantized by the next search, removed and moved nodes are announced by eraseNode and
+ * moveNode (see Base_Graph::rmNode).
+ *
+ * Scanning the codes and keeping the closest ones only pays off for many dimensions,
+ * below _minDim dimensions (64 by default, the scan of nearestTwo is faster up to about
+ * 48 dimensions of double and float weights) the winners are determined exactly by
+ * nearestTwo instead and the codes are not built.
+ *
+ * The exact first winner may fall outside the candidates. A search is certified if the
+ * quantization errors of the item and of the weights prove that no other node is as
+ * close as the first winner. Every _verification-th search is checked against the exact
+ * search, the counters tell how often its first winner was not a candidate.
+ * Copies only share the settings, their codes are built on demand.
+ *
+ * \param _candidates number of nodes compared on the weights, 0 disables the search
+ * \param _verification period of the searches that are verified by the exact search, 0 for none
+ * \param _headroom fraction of the span of a dimension added to both ends of its range
+ * \param _minDim least dimension for which the codes are scanned, below the exact scan is used
+ * \param _dim dimension of the weights
+ * \param _size number of nodes whose codes are known
+ * \param _rebuild whether all codes have to be built by the next search
+ * \param _center center of the range of every dimension
+ * \param _scale difference of the weights of two consecutive codes in every dimension
+ * \param _scale2 squared scale of every dimension in single precision
+ * \param _codes codes of the nodes, row by row
+ * \param _error largest distance of a node to its quantized weight vector
+ * \param _slack bound of the rounding error of a quantized weight vector
+ * \param _pending known nodes whose place has been taken by an added node
+ * \param _item codes of the current item
+ * \param _distances squared distances of the codes of the nodes to the codes of the current item
+ * \param _best closest candidates of the current search
+ * \param _stats counters of the searches
+ */
+template<typename T> class QuantizedPrefilter
+{
+public:
+	/// counters of the searches
+	struct Stats
+	{
+		Stats() : queries(0), scans(0), certified(0), verified(0), misses(0), rebuilds(0) {}
+		// fraction of the verified searches whose exact first winner was not a candidate
+		double missRate() const { return verified ? double(misses) / verified : 0.0; }
+		// number of searches
+		unsigned long queries;
+		// number of searches answered by the exact scan since there are less than _minDim dimensions
+		unsigned long scans;
+		// number of searches that provably found the exact first winner
+		unsigned long certified;
+		// number of searches checked by the exact search
+		unsigned long verified;
+		// number of checked searches whose exact first winner was not a candidate
+		unsigned long misses;
+		// number of times all codes were built
+		unsigned long rebuilds;
+	};
+	//std cto, the search is disabled
+	QuantizedPrefilter() : _candidates(0), _verification(0), _headroom(0.25), _minDim(64), _dim(0), _size(0), _rebuild(true), _error(0), _slack(0) {}
+	//copy cto copying the settings only
+	QuantizedPrefilter(const QuantizedPrefilter& q) : _candidates(q._candidates), _verification(q._verification), _headroom(q._headroom), _minDim(q._minDim), _dim(0), _size(0), _rebuild(true), _error(0), _slack(0) {}
+	//assignment copying the settings only
+	QuantizedPrefilter& operator=(const QuantizedPrefilter&);
+	//sets the number of candidates compared on the weights, 0 disables the search
+	void                     setCandidates(const unsigned int& candidates) { _candidates = candidates; }
+	//sets the period of the searches verified by the exact search, 0 for none
+	void                     setVerification(const unsigned int& period) { _verification = period; }
+	//sets the fraction of the span added to both ends of the ranges
+	void                     setHeadroom(const T& headroom) { assert (!(headroom < 0)); _headroom = headroom; _rebuild = true; }
+	//sets the least dimension for which the codes are scanned, below the exact scan is used
+	void                     setMinDim(const unsigned int& dim) { _minDim = dim; }
+	//returns whether the search is enabled
+	inline bool              enabled() const { return _candidates > 0; }
+	//returns the number of candidates
+	inline unsigned int      candidates() const { return _candidates; }
+	//returns the counters
+	inline const Stats&      stats() const { return _stats; }
+	//resets the counters
+	inline void              resetStats() { _stats = Stats(); }
+	//removes a node that is deleted from the graph
+	void                     eraseNode(const unsigned int&);
+	//changes the index of a moved node
+	void                     moveNode(const unsigned int&, const unsigned int&);
+	//quantizes the changed weight vector of a node
+	void                     weightChanged(const unsigned int&, const WeightMatrix<T>&);
+	//determines the two winner nodes among the candidates for the given item
+	T                        getWinner(unsigned int&, unsigned int&, const T*, const WeightMatrix<T>&);
+
+private:
+	typedef std::pair<float,unsigned int> Entry;
+	//orders the candidates by their index
+	static bool              byIndex(const Entry& a, const Entry& b) { return a.second < b.second; }
+	//quantizes the nodes added or taken over since the last search
+	void                     update(const WeightMatrix<T>&);
+	//determines the ranges and quantizes all nodes
+	void                     build(const WeightMatrix<T>&);
+	//quantizes a node, returns false if a weight is out of range
+	bool                     quantize(const unsigned int&, const WeightMatrix<T>&);
+	//returns the code of a value of a dimension, clipped to the range
+	inline int               code(const T&, const unsigned int&) const;
+	unsigned int             _candidates;
+	unsigned int             _verification;
+	T                        _headroom;
+	unsigned int             _minDim;
+	unsigned int             _dim;
+	unsigned int             _size;
+	bool                     _rebuild;
+	std::vector<T>           _center;
+	std::vector<T>           _scale;
+	std::vector<float>       _scale2;
+	std::vector<signed char> _codes;
+	T                        _error;
+	T                        _slack;
+	std::vector<unsigned int> _pending;
+	std::vector<signed char> _item;
+	std::vector<float>       _distances;
+	std::vector<Entry>       _best;
+	Stats                    _stats;
+};
+
+/** \brief assignment copying the settings only, the codes are built by the next search
+*/
+template<typename T> QuantizedPrefilter<T>& QuantizedPrefilter<T>::operator=(const QuantizedPrefilter& q)
+{
+	_candidates   = q._candidates;
+	_verification = q._verification;
+	_headroom     = q._headroom;
+	_minDim       = q._minDim;
+	_size         = 0;
+	_rebuild      = true;
+	return *this;
+}
+
+/** \brief removes a node that is deleted from the graph
+*
+* If it is not the last node, moveNode is called afterwards for the last node.
+* \param index of the node
+*/
+template<typename T> void QuantizedPrefilter<T>::eraseNode(const unsigned int& index)
+{
+	if (index + 1 == _size)
+		_size--;
+}
+
+/** \brief changes the index of a moved node
+*
+* The node taking the place of an erased one is the last node.
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T> void QuantizedPrefilter<T>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+	if (to >= _size)
+		return;
+	if (from >= _size)
+	{
+		// an added node that is not quantized yet takes the place
+		_pending.push_back(to);
+		return;
+	}
+	assert (from + 1 == _size);
+	std::copy(_codes.begin() + from * _dim, _codes.begin() + (from + 1) * _dim, _codes.begin() + to * _dim);
+	_size--;
+}
+
+/** \brief quantizes the changed weight vector of a node
+*
+* \param index of the node
+* \param weights weight matrix holding the new weight vector
+*/
+template<typename T> void QuantizedPrefilter<T>::weightChanged(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	if (_rebuild || index >= _size)
+		return;
+	if (!quantize(index, weights))
+		_rebuild = true;
+}
+
+/** \brief determines the two winner nodes among the candidates for the given item
+*
+* Below _minDim dimensions the winners are determined exactly by nearestTwo. The codes of the nodes are compared with the codes of the item by the squared
+* distance sum_k _scale2[k] (c_k - d_k)^2 of the quantized vectors in single precision, the _candidates
+* closest nodes are compared by euclidean on the weights in ascending order.
+*
+* \param first_winner after func call the closest candidate, the smallest index among equally close ones
+* \param second_winner after func call the candidate that was closest before first_winner was found
+* \param x item
+* \param weights weight matrix of the graph
+* \return euclidean distance of the item to the first winner
+*/
+template<typename T> T QuantizedPrefilter<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const T* x, const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	const unsigned int k = std::min(_candidates, n);
+	T best_distance = std::numeric_limits<T>::max();
+
+	assert (enabled());
+	assert (n >= 2);
+	_stats.queries++;
+	if (weights.dim() < _minDim)
+	{
+		_stats.scans++;
+		_rebuild = true;
+		return nearestTwo<T> (x, weights, first_winner, second_winner);
+	}
+	update(weights);
+
+	// the distance of the item to its quantized vector
+	T item_error = 0;
+	for (unsigned int d = 0; d < _dim; d++)
+	{
+		const int c = code(x[d], d);
+		_item[d] = (signed char) c;
+		const T value = x[d] - (_center[d] + c * _scale[d]);
+		item_error += value * value;
+	}
+	item_error = T(sqrt(item_error));
+
+	// the k closest codes are kept in a max-heap
+	_distances.resize(n);
+	quantizedDistances (&_item[0], &_codes[0], &_scale2[0], _dim, n, &_distances[0]);
+	_best.clear();
+	for (unsigned int j = 0; j < n; j++)
+	{
+		const float sum = _distances[j];
+		if (_best.size() < k)
+		{
+			_best.push_back(Entry(sum, j));
+			if (_best.size() == k)
+				std::make_heap(_best.begin(), _best.end());
+		}
+		else if (Entry(sum, j) < _best.front())
+		{
+			std::pop_heap(_best.begin(), _best.end());
+			_best.back() = Entry(sum, j);
+			std::push_heap(_best.begin(), _best.end());
+		}
+	}
+	const double threshold = (k < n) ? std::max_element(_best.begin(), _best.end())->first : 0;
+
+	first_winner  = 1;
+	second_winner = 0;
+	std::sort(_best.begin(), _best.end(), byIndex);
+	for (unsigned int c = 0; c < _best.size(); c++)
+	{
+		const unsigned int j = _best[c].second;
+		const T distance = euclidean<T> (x, weights.row(j), _dim);
+		if (distance < best_distance)
+		{
+			second_winner = first_winner;
+			first_winner  = j;
+			best_distance = distance;
+		}
+	}
+
+	// every other node is at least as far from the quantized item as the threshold,
+	// up to the rounding of the single precision sums
+	const double margin = (_dim + 4) * double(std::numeric_limits<float>::epsilon());
+	if (k == n || sqrt(threshold) * (1 - margin) - (item_error + _error + _slack) * (1 + margin) > best_distance)
+		_stats.certified++;
+
+	if (_verification > 0 && _stats.queries % _verification == 0)
+	{
+		unsigned int first, second;
+		nearestTwo<T> (x, weights, first, second);
+		_stats.verified++;
+		if (!std::binary_search(_best.begin(), _best.end(), Entry(0, first), byIndex))
+			_stats.misses++;
+	}
+	return best_distance;
+}
+
+/** \brief quantizes the nodes added or taken over since the last search
+*/
+template<typename T> void QuantizedPrefilter<T>::update(const WeightMatrix<T>& weights)
+{
+	if (_rebuild || _dim != weights.dim() || _size > weights.rows())
+	{
+		build(weights);
+		return;
+	}
+	for (unsigned int i = 0; i < _pending.size(); i++)
+		if (_pending[i] < _size && !quantize(_pending[i], weights))
+		{
+			build(weights);
+			return;
+		}
+	_pending.clear();
+	_codes.resize(weights.rows() * _dim);
+	for (; _size < weights.rows(); _size++)
+		if (!quantize(_size, weights))
+		{
+			build(weights);
+			return;
+		}
+}
+
+/** \brief determines the ranges of the dimensions and quantizes all nodes
+*
+* A dimension whose weights are all equal gets a small range around the weight.
+*/
+template<typename T> void QuantizedPrefilter<T>::build(const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	_dim = weights.dim();
+	_center.assign(_dim, 0);
+	_scale.assign(_dim, 1);
+	_scale2.assign(_dim, 1.0f);
+	_item.resize(_dim);
+	_codes.resize(n * _dim);
+	_pending.clear();
+	_error = 0;
+	_slack = 0;
+	for (unsigned int d = 0; d < _dim && n > 0; d++)
+	{
+		T low = weights.row(0)[d], high = low;
+		for (unsigned int j = 1; j < n; j++)
+		{
+			low  = std::min(low, weights.row(j)[d]);
+			high = std::max(high, weights.row(j)[d]);
+		}
+		T span = high - low;
+		if (!(span > 0))
+			span = T(1e-3) * (T(fabs(low)) + 1);
+		_center[d] = low + (high - low) / 2;
+		_scale[d]  = span * (1 + 2 * _headroom) / 254;
+		_scale2[d] = float(_scale[d] * _scale[d]);
+		// rounding error of center + code * scale
+		const T bound = 4 * std::numeric_limits<T>::epsilon() * (T(fabs(_center[d])) + 127 * _scale[d]);
+		_slack += bound * bound;
+	}
+	_slack = T(sqrt(_slack));
+	for (_size = 0; _size < n; _size++)
+		// the ranges include every weight
+		quantize(_size, weights);
+	_rebuild = false;
+	_stats.rebuilds++;
+}
+
+/** \brief quantizes a node
+*
+* \param index of the node
+* \param weights weight matrix of the graph
+* \return false if a weight is out of range, the code is clipped then
+*/
+template<typename T> bool QuantizedPrefilter<T>::quantize(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	const T* w = weights.row(index);
+	signed char* c = &_codes[index * _dim];
+	bool inside = true;
+	T error = 0;
+	for (unsigned int d = 0; d < _dim; d++)
+	{
+		const T position = (w[d] - _center[d]) / _scale[d];
+		if (!(fabs(position) <= 127))
+			inside = false;
+		c[d] = (signed char) code(w[d], d);
+		const T value = w[d] - (_center[d] + c[d] * _scale[d]);
+		error += value * value;
+	}
+	_error = std::max(_error, T(sqrt(error)));
+	return inside;
+}
+
+/** \brief returns the code of a value of a dimension, clipped to the range
+*/
+template<typename T> inline int QuantizedPrefilter<T>::code(const T& value, const unsigned int& d) const
+{
+	const T position = (value - _center[d]) / _scale[d];
+	if (!(position > -127))
+		return -127;
+	if (!(position < 127))
+		return 127;
+	return int(floor(position + T(0.5)));
+}
+
+} // namespace neuralgas
+
+#endif
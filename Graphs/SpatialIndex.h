@@ -0,0 +1,718 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file SpatialIndex.h
+* \brief Exact kd-tree and ball tree winner search over a weight matrix
+*
+*  \date    2026
+*/
+
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <tools/metrics.h>
+#include <tools/distanceKernels.h>
+#include "WeightMatrix.h"
+
+namespace neuralgas {
+
+/** \class SpatialIndex
+ *  \brief Exact nearest node search over the rows of a weight matrix
+ *
+ * The index is a binary space partitioning tree over the weight vectors of the nodes,
+ * either a kd-tree whose cells are bounded by boxes, which suits low dimensions, or a
+ * ball tree whose cells are bounded by spheres, which prunes better for moderate
+ * dimensions. A node visited by the tree costs about as much as 30 nodes of the vectorized
+ * scan of nearestTwo, thus the tree only pays off if it computes the distances of a small
+ * share of the nodes, in practice for up to about 4 dimensions and some thousand nodes.
+ * AUTO uses a kd-tree only for at most autoMaxDim dimensions and at least autoMinNodes
+ * nodes, and after every build it measures the share of the nodes evaluated by the first
+ * probeQueries searches. If it exceeds 1/autoMaxShare, i.e. the tree is slower than the
+ * scan, the tree is dropped and the scan
+ * is used for the next autoRescan times the number of nodes searches before the tree is
+ * tried again. Independent of the kind a search that has computed the distances of
+ * _maxEvaluations times the number of nodes, by default 2/autoMaxShare, is given up and
+ * the scan is used instead, thus a search costs at most about three times the scan.
+ *
+ * The tree is built from the positions the weights have at build time. Moving a node
+ * afterwards has to be announced by weightChanged, its distance to the built position
+ * is added as drift to the bounds of its cells such that the search stays exact. When
+ * the drift exceeds _maxDrift times the mean radius of the leaves, or too many nodes
+ * were added or removed, the tree is rebuilt lazily by the next search.
+ * Nodes added after the build are kept in a list that is scanned, removed and moved
+ * nodes are announced by eraseNode and moveNode (see Base_Graph::rmNode).
+ *
+ * getWinner returns the same winners as the linear scan of GNGModulGraph::getWinner:
+ * the first winner is the closest node, the one with the smallest index among equally
+ * close ones, the second winner is the node that was closest before the first winner
+ * was found by the scan, i.e. the closest node among the nodes with a smaller index.
+ * Both are found by one traversal of the tree which keeps the front of the visited
+ * nodes, i.e. the nodes to which no visited node with a smaller index is at least as
+ * close, ordered by their distance. The first two nodes of the final front are the
+ * winners. The cells that are farther than the closest node of the front can only hold
+ * the second winner, they are searched after the others, once the first winner is known.
+ * The distances are computed by the same euclidean function, thus also the returned
+ * distance is the same. Copies only share the settings, their tree is built on demand.
+ *
+ * \param _kind kind of the tree
+ * \param _leafSize maximal number of nodes in a leaf
+ * \param _maxDrift tolerated drift relative to the mean leaf radius before rebuilding
+ * \param _maxEvaluations share of the nodes whose distances a search computes before the scan is used
+ * \param _valid whether the tree matches the weights
+ * \param _ball whether the built tree is a ball tree
+ * \param _dim dimension of the weights
+ * \param _cells cells of the tree, the root is the first cell
+ * \param _bounds box (lower and upper corner) or sphere center of every cell
+ * \param _points positions of the nodes at build time in tree order
+ * \param _ids node of every position, npos if the node was removed
+ * \param _slot position of every node, npos if the node is not in the tree
+ * \param _leafOf leaf containing every position
+ * \param _loose nodes that are not in the tree
+ * \param _removed number of removed positions
+ * \param _driftLimit tolerated drift of the root
+ * \param _front visited nodes not dominated by a closer node with a smaller index, as (distance, index)
+ * \param _deferred cells with their bounds that are searched once the first winner is known
+ * \param _budget number of distances the current search may still compute
+ * \param _scanning whether AUTO has dropped the tree
+ * \param _probes number of searches since the last build or rescans while scanning
+ * \param _probeEvaluations number of distances computed by the probed searches
+ * \param _rebuilds number of builds
+ * \param _evaluations number of computed distances
+ * \param _scans number of searches answered by the scan
+ */
+template<typename T> class SpatialIndex
+{
+public:
+	enum { npos = ~0u };
+	enum Kind { NONE, KDTREE, BALLTREE, AUTO };
+	/// limits of AUTO, see the class description
+	enum { autoMaxDim = 4, autoMinNodes = 1024, autoMaxShare = 32, autoRescan = 16, probeQueries = 64 };
+	//std cto, the index is disabled
+	SpatialIndex();
+	//copy cto copying the settings only
+	SpatialIndex(const SpatialIndex&);
+	//assignment copying the settings only
+	SpatialIndex& operator=(const SpatialIndex&);
+	//sets the kind of the tree, NONE disables the index
+	void                     setKind(const Kind&);
+	//returns the kind of the tree
+	inline Kind              kind() const { return _kind; }
+	//returns whether the index is enabled
+	inline bool              enabled() const { return _kind != NONE; }
+	//sets the maximal number of nodes in a leaf
+	void                     setLeafSize(const unsigned int&);
+	//sets the tolerated drift relative to the mean leaf radius
+	void                     setMaxDrift(const T&);
+	//sets the share of the nodes whose distances a search computes before the scan is used
+	void                     setMaxEvaluations(const T&);
+	//forces a rebuild by the next search
+	inline void              invalidate() { _valid = false; }
+	//removes a node that is deleted from the graph
+	void                     eraseNode(const unsigned int&);
+	//changes the index of a moved node
+	void                     moveNode(const unsigned int&, const unsigned int&);
+	//adds the drift of a node whose weight vector has been changed
+	void                     weightChanged(const unsigned int&, const WeightMatrix<T>&);
+	//takes added nodes into account and rebuilds the tree if needed
+	void                     update(const WeightMatrix<T>&);
+	//determines the two winner nodes for the given item like GNGModulGraph::getWinner
+	T                        getWinner(unsigned int&, unsigned int&, const T*, const WeightMatrix<T>&);
+	//returns the number of builds
+	inline unsigned long     rebuilds() const { return _rebuilds; }
+	//returns the number of computed distances
+	inline unsigned long     evaluations() const { return _evaluations; }
+	//returns the number of searches answered by the scan
+	inline unsigned long     scans() const { return _scans; }
+
+private:
+	/// cell of the tree, the positions begin ... end-1 lie in it
+	struct Cell
+	{
+		unsigned int begin;
+		unsigned int end;
+		unsigned int left;
+		unsigned int right;
+		unsigned int parent;
+		// smallest node index within the cell
+		unsigned int minId;
+		// radius of the sphere, for kd-trees half of the box diagonal
+		T            radius;
+		// maximal drift of the nodes within the cell
+		T            drift;
+	};
+	/// orders node indices by a coordinate of their weight vectors
+	struct CoordinateLess
+	{
+		CoordinateLess(const WeightMatrix<T>& weights, const unsigned int& k) : w(weights), d(k) {}
+		bool operator()(const unsigned int& a, const unsigned int& b) const { return w.row(a)[d] < w.row(b)[d]; }
+		const WeightMatrix<T>& w;
+		unsigned int d;
+	};
+	//builds the tree over all rows
+	void                     build(const WeightMatrix<T>&);
+	//builds the cell for the given positions and returns its index
+	unsigned int             buildCell(const unsigned int&, const unsigned int&, const unsigned int&, const WeightMatrix<T>&);
+	//returns a lower bound of the distance of the item to the built positions in the cell
+	T                        bound(const unsigned int&, const T*) const;
+	//visits the nodes of the cell that may be winners
+	void                     search(const unsigned int&, const T&, const T*, const WeightMatrix<T>&, const bool&);
+	//puts the given node into the front unless a visited node dominates it
+	inline void              visit(const unsigned int&, const T*, const WeightMatrix<T>&);
+	//inserts a node into the front unless a node of the front dominates it
+	void                     insert(const T&, const unsigned int&);
+	//returns whether the search has to be answered by the scan
+	bool                     scanning(const WeightMatrix<T>&);
+	//counts the distances of a search for the decision of AUTO
+	void                     probe(const unsigned long&, const WeightMatrix<T>&);
+	//adds the nodes up to the given index as loose nodes
+	void                     grow(const unsigned int&);
+	Kind                     _kind;
+	unsigned int             _leafSize;
+	T                        _maxDrift;
+	T                        _maxEvaluations;
+	bool                     _valid;
+	bool                     _ball;
+	unsigned int             _dim;
+	std::vector<Cell>        _cells;
+	std::vector<T>           _bounds;
+	std::vector<T>           _points;
+	std::vector<unsigned int> _ids;
+	std::vector<unsigned int> _slot;
+	std::vector<unsigned int> _leafOf;
+	std::vector<unsigned int> _loose;
+	unsigned int             _removed;
+	T                        _driftLimit;
+	std::vector< std::pair<T, unsigned int> > _front;
+	std::vector< std::pair<T, unsigned int> > _deferred;
+	unsigned long            _budget;
+	bool                     _scanning;
+	unsigned long            _probes;
+	unsigned long            _probeEvaluations;
+	unsigned long            _rebuilds;
+	unsigned long            _evaluations;
+	unsigned long            _scans;
+};
+
+/** \brief std cto, the index is disabled until a kind is set
+*/
+template<typename T> SpatialIndex<T>::SpatialIndex() :
+	_kind(NONE), _leafSize(8), _maxDrift(1), _maxEvaluations(T(2) / autoMaxShare), _valid(false), _ball(false), _dim(0),
+	_removed(0), _driftLimit(0), _budget(0), _scanning(false), _probes(0), _probeEvaluations(0),
+	_rebuilds(0), _evaluations(0), _scans(0)
+{
+}
+
+/** \brief copy cto copying the settings only, the tree is built by the first search
+*/
+template<typename T> SpatialIndex<T>::SpatialIndex(const SpatialIndex& s) :
+	_kind(s._kind), _leafSize(s._leafSize), _maxDrift(s._maxDrift), _maxEvaluations(s._maxEvaluations), _valid(false),
+	_ball(false), _dim(0), _removed(0), _driftLimit(0), _budget(0), _scanning(false), _probes(0), _probeEvaluations(0),
+	_rebuilds(0), _evaluations(0), _scans(0)
+{
+}
+
+/** \brief assignment copying the settings only, the tree is built by the next search
+*/
+template<typename T> SpatialIndex<T>& SpatialIndex<T>::operator=(const SpatialIndex& s)
+{
+	_kind           = s._kind;
+	_leafSize       = s._leafSize;
+	_maxDrift       = s._maxDrift;
+	_maxEvaluations = s._maxEvaluations;
+	_valid          = false;
+	_scanning       = false;
+	return *this;
+}
+
+/** \brief sets the kind of the tree
+*
+* \param kind KDTREE, BALLTREE, AUTO for a kd-tree where it beats the scan or NONE for disabling the index
+*/
+template<typename T> void SpatialIndex<T>::setKind(const Kind& kind)
+{
+	_kind     = kind;
+	_valid    = false;
+	_scanning = false;
+}
+
+/** \brief sets the maximal number of nodes in a leaf
+*/
+template<typename T> void SpatialIndex<T>::setLeafSize(const unsigned int& size)
+{
+	assert (size > 0);
+	_leafSize = size;
+	_valid    = false;
+}
+
+/** \brief sets the drift, relative to the mean leaf radius, that is tolerated before rebuilding
+*
+* A larger value rebuilds less often but prunes less.
+*/
+template<typename T> void SpatialIndex<T>::setMaxDrift(const T& drift)
+{
+	assert (!(drift < 0));
+	_maxDrift = drift;
+	_valid    = false;
+}
+
+/** \brief sets the share of the nodes whose distances a search computes before the scan is used
+*
+* The distances computed so far are lost, thus a search costs at most the scan and the
+* distances of this share of the nodes. 1 or more lets the tree always finish the search.
+*/
+template<typename T> void SpatialIndex<T>::setMaxEvaluations(const T& share)
+{
+	assert (share > 0);
+	_maxEvaluations = share;
+}
+
+/** \brief removes a node that is deleted from the graph
+*
+* \param index of the node
+*/
+template<typename T> void SpatialIndex<T>::eraseNode(const unsigned int& index)
+{
+	if (!_valid)
+		return;
+	grow(index + 1);
+	unsigned int p = _slot[index];
+	if (p == npos)
+	{
+		std::vector<unsigned int>::iterator it = std::find(_loose.begin(), _loose.end(), index);
+		if (it != _loose.end())
+		{
+			*it = _loose.back();
+			_loose.pop_back();
+		}
+		return;
+	}
+	_ids[p]      = npos;
+	_slot[index] = npos;
+	_removed++;
+}
+
+/** \brief changes the index of a moved node
+*
+* The new index has to be free, i.e. its node has been erased before.
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T> void SpatialIndex<T>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+	if (!_valid)
+		return;
+	grow(from + 1);
+	assert (_slot[to] == npos);
+	unsigned int p = _slot[from];
+	if (p == npos)
+	{
+		std::replace(_loose.begin(), _loose.end(), from, to);
+		return;
+	}
+	_ids[p]     = to;
+	_slot[to]   = p;
+	_slot[from] = npos;
+	for (unsigned int c = _leafOf[p]; c != npos && _cells[c].minId > to; c = _cells[c].parent)
+		_cells[c].minId = to;
+}
+
+/** \brief adds the distance of the node to its built position as drift to its cells
+*
+* \param index of the node whose weight vector has been changed
+* \param weights weight matrix of the graph
+*/
+template<typename T> void SpatialIndex<T>::weightChanged(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	if (!_valid || index >= _slot.size() || _slot[index] == npos)
+		return;
+	unsigned int p = _slot[index];
+	T drift = euclidean<T> (weights.row(index), &_points[p * _dim], _dim);
+	for (unsigned int c = _leafOf[p]; c != npos && _cells[c].drift < drift; c = _cells[c].parent)
+		_cells[c].drift = drift;
+	if (_cells[0].drift > _driftLimit)
+		_valid = false;
+}
+
+/** \brief adds the nodes up to the given index that are unknown as loose nodes
+*/
+template<typename T> void SpatialIndex<T>::grow(const unsigned int& size)
+{
+	while (_slot.size() < size)
+	{
+		_loose.push_back(_slot.size());
+		_slot.push_back(npos);
+	}
+}
+
+/** \brief takes the nodes added since the last call into account and rebuilds the tree if needed
+*
+* The tree is rebuilt if it is invalid, the loose nodes exceed an eighth of all nodes
+* or a quarter of the positions belong to removed nodes.
+* \param weights weight matrix of the graph
+*/
+template<typename T> void SpatialIndex<T>::update(const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	if (_valid && _dim == weights.dim())
+	{
+		grow(n);
+		// the indices behind the last node belong to removed or moved nodes
+		_slot.resize(n);
+		if (_loose.size() <= std::max(_leafSize, n / 8) && _removed <= _ids.size() / 4)
+			return;
+	}
+	build(weights);
+}
+
+/** \brief builds the tree over all rows of the weight matrix
+*/
+template<typename T> void SpatialIndex<T>::build(const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	_dim  = weights.dim();
+	_ball = (_kind == BALLTREE);
+	_probes           = 0;
+	_probeEvaluations = 0;
+	_cells.clear();
+	_bounds.clear();
+	_loose.clear();
+	_removed = 0;
+	_ids.resize(n);
+	for (unsigned int i = 0; i < n; i++)
+		_ids[i] = i;
+	_slot.assign(n, npos);
+	_leafOf.assign(n, npos);
+	_points.resize(n * _dim);
+	_driftLimit = 0;
+	_valid      = true;
+	_rebuilds++;
+	if (n == 0)
+	{
+		_valid = false;
+		return;
+	}
+	buildCell(0, n, npos, weights);
+
+	unsigned int leaves = 0;
+	for (unsigned int c = 0; c < _cells.size(); c++)
+		if (_cells[c].left == npos)
+		{
+			leaves++;
+			_driftLimit += _cells[c].radius;
+			for (unsigned int p = _cells[c].begin; p < _cells[c].end; p++)
+				_leafOf[p] = c;
+		}
+	_driftLimit = _maxDrift * _driftLimit / leaves;
+	for (unsigned int p = 0; p < n; p++)
+	{
+		_slot[_ids[p]] = p;
+		std::copy(weights.row(_ids[p]), weights.row(_ids[p]) + _dim, &_points[p * _dim]);
+	}
+}
+
+/** \brief builds the cell for the positions begin ... end-1 and its subtree
+*
+* The positions are split at the median of the coordinate with the largest extent.
+* \return index of the cell
+*/
+template<typename T>
+unsigned int SpatialIndex<T>::buildCell(const unsigned int& begin, const unsigned int& end, const unsigned int& parent, const WeightMatrix<T>& weights)
+{
+	const unsigned int c = _cells.size();
+	_cells.push_back(Cell());
+	_cells[c].begin  = begin;
+	_cells[c].end    = end;
+	_cells[c].left   = npos;
+	_cells[c].right  = npos;
+	_cells[c].parent = parent;
+	_cells[c].drift  = 0;
+	_cells[c].minId  = *std::min_element(_ids.begin() + begin, _ids.begin() + end);
+
+	// bounding box of the positions
+	std::vector<T> lower(weights.row(_ids[begin]), weights.row(_ids[begin]) + _dim);
+	std::vector<T> upper(lower);
+	for (unsigned int p = begin + 1; p < end; p++)
+	{
+		const T* x = weights.row(_ids[p]);
+		for (unsigned int k = 0; k < _dim; k++)
+		{
+			lower[k] = std::min(lower[k], x[k]);
+			upper[k] = std::max(upper[k], x[k]);
+		}
+	}
+	unsigned int split = 0;
+	for (unsigned int k = 1; k < _dim; k++)
+		if (upper[k] - lower[k] > upper[split] - lower[split])
+			split = k;
+
+	const unsigned int offset = _bounds.size();
+	if (_ball)
+	{
+		// the center is the mean of the positions, the radius reaches the farthest one
+		_bounds.resize(offset + _dim, 0);
+		for (unsigned int p = begin; p < end; p++)
+			for (unsigned int k = 0; k < _dim; k++)
+				_bounds[offset + k] += weights.row(_ids[p])[k];
+		for (unsigned int k = 0; k < _dim; k++)
+			_bounds[offset + k] /= T(end - begin);
+		T radius = 0;
+		for (unsigned int p = begin; p < end; p++)
+			radius = std::max(radius, euclidean<T> (weights.row(_ids[p]), &_bounds[offset], _dim));
+		_cells[c].radius = radius;
+	}
+	else
+	{
+		_bounds.insert(_bounds.end(), lower.begin(), lower.end());
+		_bounds.insert(_bounds.end(), upper.begin(), upper.end());
+		_cells[c].radius = euclidean<T> (&lower[0], &upper[0], _dim) / 2;
+	}
+
+	if (end - begin <= _leafSize || !(lower[split] < upper[split]))
+		return c;
+	const unsigned int middle = begin + (end - begin) / 2;
+	std::nth_element(_ids.begin() + begin, _ids.begin() + middle, _ids.begin() + end, CoordinateLess(weights, split));
+	const unsigned int left  = buildCell(begin, middle, c, weights);
+	const unsigned int right = buildCell(middle, end, c, weights);
+	_cells[c].left  = left;
+	_cells[c].right = right;
+	return c;
+}
+
+/** \brief returns a lower bound of the distance of the item to the built positions in the cell
+*/
+template<typename T> inline T SpatialIndex<T>::bound(const unsigned int& c, const T* item) const
+{
+	if (_ball)
+	{
+		const unsigned int offset = c * _dim;
+		return euclidean<T> (item, &_bounds[offset], _dim) - _cells[c].radius;
+	}
+	const T* lower = &_bounds[2 * c * _dim];
+	const T* upper = lower + _dim;
+	T result = 0;
+	for (unsigned int k = 0; k < _dim; k++)
+	{
+		T value = 0;
+		if (item[k] < lower[k])
+			value = lower[k] - item[k];
+		else if (upper[k] < item[k])
+			value = item[k] - upper[k];
+		result += value * value;
+	}
+	return T(sqrt(result));
+}
+
+/** \brief puts the given node into the front unless a visited node dominates it
+*
+* The front is ordered by the distance, equal distances by the index, thus its indices
+* decrease. A node is dominated by a node with a smaller index that is at least as close,
+* most nodes are dominated by the first node of the front. Otherwise the node is inserted
+* by insert.
+*/
+template<typename T>
+inline void SpatialIndex<T>::visit(const unsigned int& id, const T* item, const WeightMatrix<T>& weights)
+{
+	_evaluations++;
+	_budget--;
+	const T distance = euclidean<T> (item, weights.row(id), _dim);
+	if (_front.empty() || _front[0].second > id || distance < _front[0].first)
+		insert(distance, id);
+}
+
+/** \brief inserts a node into the front unless a node of the front dominates it
+*
+* The node removes the nodes of the front that it dominates itself.
+*/
+template<typename T> void SpatialIndex<T>::insert(const T& distance, const unsigned int& id)
+{
+	unsigned int p = 0;
+	while (p < _front.size() && (_front[p].first < distance || (_front[p].first == distance && _front[p].second < id)))
+		p++;
+	// the node before has the smallest index of the closer nodes
+	if (p > 0 && _front[p - 1].second < id)
+		return;
+	unsigned int q = p;
+	while (q < _front.size() && _front[q].second > id)
+		q++;
+	if (q > p)
+	{
+		_front[p] = std::make_pair(distance, id);
+		_front.erase(_front.begin() + p + 1, _front.begin() + q);
+	}
+	else
+		_front.insert(_front.begin() + p, std::make_pair(distance, id));
+}
+
+/** \brief visits the nodes of the cell that may be winners
+*
+* A node farther than the closest node of the front, whose index is not smaller than the
+* index of that node, is neither the first nor the second winner. Until the first winner
+* is known, cells farther than the closest node of the front can only contain the second
+* winner and are deferred. Afterwards a node has to be closer than the second node of the
+* front, which is the closest node with a smaller index than the first winner, to be the
+* second winner. The children are searched in the order of their bounds, the search stops
+* when the budget of distances is used up.
+* \param c cell
+* \param lower_bound lower bound of the distance of the item to the built positions in the cell
+* \param first_known whether the first node of the front is the first winner
+*/
+template<typename T>
+void SpatialIndex<T>::search(const unsigned int& c, const T& lower_bound, const T* item, const WeightMatrix<T>& weights, const bool& first_known)
+{
+	if (_budget == 0)
+		return;
+	const Cell& cell = _cells[c];
+	// the bound is lowered by the drift and by the rounding errors of the distances
+	T reachable = (lower_bound - cell.drift) * (1 - 8 * _dim * std::numeric_limits<T>::epsilon());
+	if (!_front.empty() && reachable > _front[0].first)
+	{
+		if (cell.minId >= _front[0].second)
+			return;
+		if (!first_known)
+		{
+			_deferred.push_back(std::make_pair(lower_bound, c));
+			return;
+		}
+		if (_front.size() > 1 && reachable > _front[1].first)
+			return;
+	}
+	if (cell.left == npos)
+	{
+		for (unsigned int p = cell.begin; p < cell.end && _budget > 0; p++)
+			if (_ids[p] != npos)
+				visit(_ids[p], item, weights);
+		return;
+	}
+	const unsigned int left  = cell.left;
+	const unsigned int right = cell.right;
+	const T left_bound  = bound(left, item);
+	const T right_bound = bound(right, item);
+	if (left_bound <= right_bound)
+	{
+		search(left, left_bound, item, weights, first_known);
+		search(right, right_bound, item, weights, first_known);
+	}
+	else
+	{
+		search(right, right_bound, item, weights, first_known);
+		search(left, left_bound, item, weights, first_known);
+	}
+}
+
+/** \brief returns whether the search has to be answered by the scan
+*
+* AUTO scans for too many dimensions or too few nodes, and after dropping the tree for
+* autoRescan times the number of nodes searches.
+*/
+template<typename T> bool SpatialIndex<T>::scanning(const WeightMatrix<T>& weights)
+{
+	if (_kind != AUTO)
+		return false;
+	if (weights.dim() > autoMaxDim || weights.rows() < autoMinNodes)
+	{
+		_valid = false;
+		return true;
+	}
+	if (_scanning && ++_probes >= (unsigned long) autoRescan * weights.rows())
+		_scanning = false;
+	return _scanning;
+}
+
+/** \brief counts the distances of a search for the decision of AUTO
+*
+* After probeQueries searches the tree is dropped if they computed the distances of more
+* than 1/autoMaxShare of the nodes on average, which is about the cost of the scan.
+* \param evaluations number of distances computed by the search, a search given up for the
+*        scan adds 1/autoMaxShare of the nodes
+*/
+template<typename T> void SpatialIndex<T>::probe(const unsigned long& evaluations, const WeightMatrix<T>& weights)
+{
+	if (_kind != AUTO || _probes >= probeQueries)
+		return;
+	_probeEvaluations += evaluations;
+	if (++_probes < probeQueries)
+		return;
+	if (_probeEvaluations * autoMaxShare > (unsigned long) probeQueries * weights.rows())
+	{
+		_scanning = true;
+		_probes   = 0;
+		_valid    = false;
+	}
+}
+
+/** \brief determines for the given item the two winner nodes
+*
+* \param first_winner after func call the closest node
+* \param second_winner after func call the closest node among the nodes with a smaller index than first_winner, 1 if first_winner is 0
+* \param item data vector
+* \param weights weight matrix of the graph, the rows are the nodes
+* \return distance of the item to the first winner
+*/
+template<typename T>
+T SpatialIndex<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const T* item, const WeightMatrix<T>& weights)
+{
+	assert (weights.rows() >= 2);
+	if (scanning(weights))
+	{
+		_scans++;
+		return nearestTwo<T> (item, weights, first_winner, second_winner);
+	}
+	update(weights);
+
+	const T share = _maxEvaluations * weights.rows();
+	_budget = (share < T(weights.rows())) ? std::max<unsigned long> ((unsigned long) share, 1) : weights.rows();
+	const unsigned long budget = _budget;
+	_front.clear();
+	for (unsigned int i = 0; i < _loose.size() && _budget > 0; i++)
+		visit(_loose[i], item, weights);
+	_deferred.clear();
+	if (!_cells.empty())
+		search(0, bound(0, item), item, weights, false);
+	std::sort(_deferred.begin(), _deferred.end());
+	for (unsigned int i = 0; i < _deferred.size(); i++)
+		search(_deferred[i].second, _deferred[i].first, item, weights, true);
+	if (_budget == 0 && share < T(weights.rows()))
+	{
+		// the search may have been stopped before visiting all candidates
+		probe(budget + weights.rows() / autoMaxShare, weights);
+		_scans++;
+		return nearestTwo<T> (item, weights, first_winner, second_winner);
+	}
+	probe(budget - _budget, weights);
+
+	assert (!_front.empty());
+	first_winner = _front[0].second;
+	if (first_winner == 0)
+		second_winner = 1;
+	else
+	{
+		assert (_front.size() > 1);
+		second_winner = _front[1].second;
+	}
+	return _front[0].first;
+}
+
+} // namespace neuralgas
+
+#endif
@@ -32,6 +32,7 @@
 
 #include "Base_Graph.h"
 #include <typeinfo>
+#include <algorithm>
 
 namespace neuralgas {
 
@@ -40,18 +41,23 @@ namespace neuralgas {
  *
  *   The edge permits giving each edge a time / age which can be
  *   decreased, increased, set and get directly by correspondig functions.
+ *   Within a TGraph the age has to be changed by the functions of the graph
+ *   which keep the age index of the graph up to date.
  *
  * \param age represents the age of the edge which is initialised to 0.0
+ * \param bucket_pos position of the edge within its age bucket of the graph
  */
 template<typename A,typename B> struct TEdge : Base_Edge<A,B>
 {
   friend class boost::serialization::access;
 
   TEdge()
-  {age=0;}
+  {age=0; bucket_pos=0;}
 
   //represents the age of the edge which is initialised to 0.0
   unsigned int age;
+  //position of the edge within its age bucket of the graph
+  unsigned int bucket_pos;
   
   // sets the age of the edge
   void setAge(const unsigned int new_age){age=new_age;}
@@ -88,16 +94,21 @@ private:
  * and the virtual function newNode() has to be overloaded in the derived graph class such that 
  * it returns a pointer to that newly defined but derived node data type. 
  * The same holds for the edges.
+ * The third template parameter selects the adjacency backend of Base_Graph.
+ * The edges are indexed by their age, _ageBuckets[a] holds the edges of age a,
+ * such that rmOldEdges finds the edges exceeding a maximal age in O(expired)
+ * instead of visiting all edges. Edges older than maxAgeBuckets - 1 share the last bucket.
+ * An edge enters the index in newEdge and leaves it in deleteEdge.
  *
- * 
+ * \param _ageBuckets the edges of the graph grouped by their age
  */
-template<typename T,typename S> class TGraph : public virtual Base_Graph<T,S>
+template<typename T,typename S,typename A = SparseAdjacency< Base_Edge<S,T> > > class TGraph : public virtual Base_Graph<T,S,A>
 { 
   public:
     //cto creating a graph with the same dimension for node and edge weight vectors
-    TGraph(const unsigned int& dim):Base_Graph<T,S>(dim){}
+    TGraph(const unsigned int& dim):Base_Graph<T,S,A>(dim){}
     //cto creating a graph with the different dimension for node and edge weight vectors
-    TGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge){}
+    TGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S,A>(dimNode,dimEdge){}
     /// dummy cto
     TGraph () {};
 
@@ -109,6 +120,8 @@ template<typename T,typename S> class TGraph : public virtual Base_Graph<T,S>
     void                             incAge(const unsigned int&,const unsigned int&);
     //dec the age of the edge going from the first parameter to the second
     void                             decAge(const unsigned int&,const unsigned int&);
+    //removes all edges with an age greater than the given one, returns the number of removed edges
+    unsigned int                     rmOldEdges(const unsigned int&);
     //returns a pointer to an edge of a type that is currently used by the graph
     virtual TEdge<S,T>*              newEdge();
     //abstract addEdge  
@@ -116,6 +129,24 @@ template<typename T,typename S> class TGraph : public virtual Base_Graph<T,S>
     //abstract rmEdge
     virtual void                     rmEdge(const unsigned int&, const unsigned int&)=0;
     void                             getID(const unsigned int&, const unsigned int&);
+
+  protected:
+    // number of age buckets, the last one gathers all older edges
+    enum { maxAgeBuckets = 4096 };
+    //removes the edge from the age index and deletes it
+    virtual void                     deleteEdge(Base_Edge<S,T>*);
+    //rebuilds the age index from the edges of the graph
+    virtual void                     indexEdges();
+    //returns a copy of an edge of another graph including its age
+    virtual Base_Edge<S,T>*          cloneEdge(const Base_Edge<S,T>&);
+    //changes the age of an edge and moves it to the corresponding bucket
+    inline void                      setEdgeAge(TEdge<S,T>*, const unsigned int&);
+    //adds an edge to the bucket of its age
+    inline void                      indexEdge(TEdge<S,T>*);
+    //removes an edge from the bucket of its age
+    inline void                      unindexEdge(TEdge<S,T>*);
+    // the edges of the graph grouped by their age
+    std::vector< std::vector< TEdge<S,T>* > > _ageBuckets;
 };  
 /*
 template<typename T,typename S> void TGraph<T,S>::addEdge(const unsigned int& x,const unsigned int& y)
@@ -139,12 +170,15 @@ template<typename T,typename S> void TGraph<T,S>::rmEdge(const unsigned int& a,c
 *   \param x source of the edge
 *   \param y destination of the edge
 */
-template<typename T,typename S> inline float TGraph<T,S>::getAge(const unsigned int& x, const unsigned int& y) const
+template<typename T,typename S,typename A> inline float TGraph<T,S,A>::getAge(const unsigned int& x, const unsigned int& y) const
 {
- if ( this->_nodes[x]->edges[y] !=NULL && 0 <= x && x < this->size() && 0 <= y && y < this->size() )
-     return (static_cast< TEdge<S,T>* >(this->_nodes[x]->edges[y]) )->getAge();
- else
-     return -1;
+ if ( x < this->size() && y < this->size() )
+ {
+     const typename A::Entry* entry = this->_adjacency.find(x,y);
+     if ( entry != NULL )
+         return (static_cast< TEdge<S,T>* >(entry->edge) )->getAge();
+ }
+ return -1;
 }
 
 /** Set the age of the edge going from x to y if it does exists
@@ -152,12 +186,12 @@ template<typename T,typename S> inline float TGraph<T,S>::getAge(const unsigned
 *   \param x source of the edge
 *   \param y destination of the edge
 */
-template<typename T,typename S> void TGraph<T,S>::setAge(const unsigned int& x, const unsigned int& y,const unsigned int& value)
+template<typename T,typename S,typename A> void TGraph<T,S,A>::setAge(const unsigned int& x, const unsigned int& y,const unsigned int& value)
 {
   if ( x < this->size() && y < this->size() )
   {
    addEdge(x,y);
-   (static_cast< TEdge<S,T>* >(this->_nodes[x]->edges[y]) )->setAge(value); 
+   setEdgeAge( static_cast< TEdge<S,T>* >(this->_adjacency.find(x,y)->edge), value ); 
   }
   //else rmEdge(x,y); // ?????? why?
 }
@@ -167,12 +201,13 @@ template<typename T,typename S> void TGraph<T,S>::setAge(const unsigned int& x,
 *   \param x source of the edge
 *   \param y destination of the edge
 */
-template<typename T,typename S> void TGraph<T,S>::decAge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void TGraph<T,S,A>::decAge(const unsigned int& x,const unsigned int& y)
 {
   if ( x < this->size() && y < this->size() )
   {
      addEdge(x,y);
-     (static_cast< TEdge<S,T>* >(this->_nodes[x]->edges[y]) )->decAge();
+     TEdge<S,T>* edge = static_cast< TEdge<S,T>* >(this->_adjacency.find(x,y)->edge);
+     setEdgeAge( edge, edge->age - 1 );
   }
 }
 
@@ -181,12 +216,13 @@ template<typename T,typename S> void TGraph<T,S>::decAge(const unsigned int& x,c
 *   \param x source of the edge
 *   \param y destination of the edge
 */
-template<typename T,typename S> void TGraph<T,S>::incAge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void TGraph<T,S,A>::incAge(const unsigned int& x,const unsigned int& y)
 {
   if ( x < this->size() && y < this->size() )
   {
      addEdge(x,y);
-     (static_cast< TEdge<S,T>* >(this->_nodes[x]->edges[y]) )->incAge();
+     TEdge<S,T>* edge = static_cast< TEdge<S,T>* >(this->_adjacency.find(x,y)->edge);
+     setEdgeAge( edge, edge->age + 1 );
   }
 }
 
@@ -200,16 +236,112 @@ template<typename T,typename S> void TGraph<T,S>::incAge(const unsigned int& x,c
 * This function has to be called by the function addEdge() and inheritance rules guarantee
 * that the function of the subclass and not of the superclass is called within the function
 * addEdge(),resulting in the use of the used defined edge type as edge for the graph structure.
+* The new edge is put into the age index, a reimplementation has to call indexEdge for its edge.
 */
-template<typename T,typename S> TEdge<S,T>* TGraph<T,S>::newEdge()
+template<typename T,typename S,typename A> TEdge<S,T>* TGraph<T,S,A>::newEdge()
 {
   TEdge<S,T>* edge = new TEdge<S,T>;
+  indexEdge(edge);
   return edge;
 }  
 
-template<typename T,typename S> inline void TGraph<T,S>::getID(const unsigned int& x, const unsigned int& y)
+/** \brief returns a copy of a timed edge of another graph, the copy is put into the age index
+*
+* \param e edge to be copied, has to be a TEdge
+*/
+template<typename T,typename S,typename A> Base_Edge<S,T>* TGraph<T,S,A>::cloneEdge(const Base_Edge<S,T>& e)
+{
+  TEdge<S,T>* edge = static_cast< TEdge<S,T>* >( Base_Graph<T,S,A>::cloneEdge(e) );
+  setEdgeAge( edge, static_cast< const TEdge<S,T>& >(e).age );
+  return edge;
+}
+
+/** \brief removes the edge from the age index and deletes it
+*
+* \param edge ptr to an edge that has been removed from the adjacency backend
+*/
+template<typename T,typename S,typename A> void TGraph<T,S,A>::deleteEdge(Base_Edge<S,T>* edge)
+{
+  unindexEdge( static_cast< TEdge<S,T>* >(edge) );
+  delete edge;
+}
+
+/** \brief rebuilds the age index from the edges of the graph
+*/
+template<typename T,typename S,typename A> void TGraph<T,S,A>::indexEdges()
+{
+  _ageBuckets.clear();
+  std::vector< TEdge<S,T>* > edges;
+  for (unsigned int i = 0; i < this->size(); i++)
+    for (typename A::const_iterator it = this->_adjacency.begin(i); it != this->_adjacency.end(i); ++it)
+      edges.push_back( static_cast< TEdge<S,T>* >(it->edge) );
+  uniqueEdges(edges);
+  for (unsigned int i = 0; i < edges.size(); i++)
+    indexEdge(edges[i]);
+}
+
+/** \brief changes the age of an edge and moves it to the bucket of its new age
+*
+* \param edge ptr to the edge
+* \param age new age
+*/
+template<typename T,typename S,typename A> inline void TGraph<T,S,A>::setEdgeAge(TEdge<S,T>* edge, const unsigned int& age)
+{
+  unindexEdge(edge);
+  edge->setAge(age);
+  indexEdge(edge);
+}
+
+/** \brief adds an edge to the bucket of its age
+*
+* \param edge ptr to the edge
+*/
+template<typename T,typename S,typename A> inline void TGraph<T,S,A>::indexEdge(TEdge<S,T>* edge)
+{
+  unsigned int b = std::min<unsigned int>(edge->age, maxAgeBuckets - 1);
+  if (b >= _ageBuckets.size())
+    _ageBuckets.resize(b + 1);
+  edge->bucket_pos = _ageBuckets[b].size();
+  _ageBuckets[b].push_back(edge);
+}
+
+/** \brief removes an edge from the bucket of its age, the last edge of the bucket takes its place
+*
+* \param edge ptr to the edge
+*/
+template<typename T,typename S,typename A> inline void TGraph<T,S,A>::unindexEdge(TEdge<S,T>* edge)
+{
+  std::vector< TEdge<S,T>* >& bucket = _ageBuckets[ std::min<unsigned int>(edge->age, maxAgeBuckets - 1) ];
+  assert (edge->bucket_pos < bucket.size() && bucket[edge->bucket_pos] == edge);
+  bucket[edge->bucket_pos] = bucket.back();
+  bucket[edge->bucket_pos]->bucket_pos = edge->bucket_pos;
+  bucket.pop_back();
+}
+
+/** \brief Removes all edges that have an age greater than the given one
+*
+* Only the buckets above max_age are visited, the edges are removed by the rmEdge
+* function of the derived graph such that the connections of the nodes are updated.
+* \param max_age is the maximal age that is permitted for an edge to have
+* \return number of removed edges
+*/
+template<typename T,typename S,typename A> unsigned int TGraph<T,S,A>::rmOldEdges(const unsigned int& max_age)
+{
+  std::vector< TEdge<S,T>* > expired;
+  unsigned int first = (max_age < maxAgeBuckets - 1) ? max_age + 1 : maxAgeBuckets - 1;
+  for (unsigned int b = first; b < _ageBuckets.size(); b++)
+    for (unsigned int j = 0; j < _ageBuckets[b].size(); j++)
+      if (_ageBuckets[b][j]->age > max_age)
+        expired.push_back(_ageBuckets[b][j]);
+
+  for (unsigned int i = 0; i < expired.size(); i++)
+    rmEdge( this->getIndex(expired[i]->in_handle), this->getIndex(expired[i]->out_handle) );
+  return expired.size();
+}
+
+template<typename T,typename S,typename A> inline void TGraph<T,S,A>::getID(const unsigned int& x, const unsigned int& y)
 {
-  std::cout << typeid( (*this->_nodes[x]->edges[y])).name()<<std::endl;
+  std::cout << typeid( (*this->_adjacency.find(x,y)->edge)).name()<<std::endl;
 }  
 
 } // namespace neuralgas
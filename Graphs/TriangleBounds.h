@@ -0,0 +1,478 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file TriangleBounds.h
+* \brief Exact winner search skipping nodes by the triangle inequality
+*
+*  \date    2026
+*/
+
+
+#ifndef TRIANGLEBOUNDS_H
+#define TRIANGLEBOUNDS_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <tools/metrics.h>
+#include <tools/distanceKernels.h>
+#include "WeightMatrix.h"
+
+namespace neuralgas {
+
+/** \class TriangleBounds
+ *  \brief Exact winner search skipping nodes by the triangle inequality
+ *
+ * The nodes are scanned in ascending order like GNGModulGraph::getWinner does, block by
+ * block of nodes. Let b be the closest node so far at distance d. A node j with
+ * d(b,j) >= 2d cannot be closer to the item than b, its distance is not computed (Elkan).
+ * If d is at most half the distance of b to its nearest other node, no remaining node can
+ * be closer and the scan stops (Hamerly). The nodes of a block that are not skipped are
+ * evaluated by squaredDistances, the whole block at once unless only a few nodes are
+ * left, and compared like nearestTwo does. Since a skipped node would not have replaced
+ * the first winner, the winners and the returned distance are exactly those of the scan.
+ *
+ * The distances between the nodes are computed row by row by squaredDistances when the
+ * nodes are first seen. The computed distances stay lower bounds when nodes move: every
+ * node accumulates the length of its moves (weightChanged) and a pair subtracts the
+ * moves of both nodes since it was computed. The half distance of every node to its
+ * nearest node is kept as the least of these bounds, a move of a node lowers the bounds
+ * of its pairs only. The row of the first winner is computed again after a search if its
+ * node moved more than _maxDrift times the half distance to its nearest node since then.
+ * Nodes added to known ones have their rows computed by the next search. The nodes of a
+ * new or copied graph start without known distances. Removed and moved nodes are
+ * announced by eraseNode and moveNode (see Base_Graph::rmNode), if an added node takes
+ * the place of a removed one before it is known, its row is computed by the next search.
+ *
+ * Every move costs a pass over the row of the node without distances, thus the bounds
+ * only pay off for graphs whose nodes rarely move between the searches and for many
+ * dimensions, e.g. when a trained graph is evaluated. While training, and in general for
+ * few dimensions, the vectorized scan of nearestTwo is faster, hence the search is
+ * disabled by default. The pair distances need memory quadratic in the number of nodes,
+ * for more than _maxNodes nodes the bounds are dropped and nearestTwo is used.
+ * Copies only share the settings, their bounds are computed on demand.
+ *
+ * \param _enabled whether the search is enabled
+ * \param _maxNodes maximal number of nodes for which bounds are kept
+ * \param _maxDrift tolerated move of a node, relative to the half distance to its nearest node, before its row is computed again
+ * \param _dim dimension of the weights
+ * \param _size number of nodes that are known
+ * \param _capacity number of nodes the storage is allocated for
+ * \param _distances distances of the pairs of nodes when they were computed, 0 if unknown
+ * \param _stamps sum of the moves of both nodes when the distance of a pair was computed
+ * \param _positions weight vectors of the nodes when their moves were last accumulated
+ * \param _drift accumulated length of the moves of every node
+ * \param _rowDrift accumulated moves of every node when its row was computed
+ * \param _rowHalf half distance to the nearest node when the row was computed
+ * \param _refreshed whether the row of every node is known
+ * \param _unknown whether the position of a node is not known since an added node took its place
+ * \param _replaced whether an added node took the place of a removed one since the last search
+ * \param _half lower bound of the half distance of every node to its nearest node
+ * \param _squared squared distances of a row
+ * \param _stats counters of the searches
+ */
+template<typename T> class TriangleBounds
+{
+public:
+	/// counters of the searches
+	struct Stats
+	{
+		Stats() : queries(0), scanned(0), evaluations(0), skipped(0), refreshes(0) {}
+		// number of distances a scan would have computed per computed distance
+		double speedup() const { return evaluations ? double(scanned) / evaluations : 1.0; }
+		// number of searches
+		unsigned long queries;
+		// number of distances a scan of all nodes would have computed
+		unsigned long scanned;
+		// number of computed distances, including the refreshed rows
+		unsigned long evaluations;
+		// number of nodes skipped by the bounds
+		unsigned long skipped;
+		// number of refreshed rows
+		unsigned long refreshes;
+	};
+	//std cto, the search is disabled
+	TriangleBounds() : _enabled(false), _maxNodes(2048), _maxDrift(0.5), _dim(0), _size(0), _capacity(0), _replaced(false) {}
+	//copy cto copying the settings only
+	TriangleBounds(const TriangleBounds& t) : _enabled(t._enabled), _maxNodes(t._maxNodes), _maxDrift(t._maxDrift), _dim(0), _size(0), _capacity(0), _replaced(false) {}
+	//assignment copying the settings only
+	TriangleBounds& operator=(const TriangleBounds&);
+	//enables or disables the search
+	void                     setEnabled(const bool& enabled) { _enabled = enabled; _size = 0; }
+	//sets the maximal number of nodes for which bounds are kept
+	void                     setMaxNodes(const unsigned int& nodes) { _maxNodes = nodes; _size = 0; }
+	//sets the tolerated move of a node before its row is refreshed
+	void                     setMaxDrift(const T& drift) { assert (!(drift < 0)); _maxDrift = drift; }
+	//returns whether the search is enabled
+	inline bool              enabled() const { return _enabled; }
+	//returns the counters
+	inline const Stats&      stats() const { return _stats; }
+	//resets the counters
+	inline void              resetStats() { _stats = Stats(); }
+	//removes a node that is deleted from the graph
+	void                     eraseNode(const unsigned int&);
+	//changes the index of a moved node
+	void                     moveNode(const unsigned int&, const unsigned int&);
+	//accumulates the move of a node whose weight vector has been changed
+	void                     weightChanged(const unsigned int&, const WeightMatrix<T>&);
+	//determines the two winner nodes for the given item like GNGModulGraph::getWinner
+	T                        getWinner(unsigned int&, unsigned int&, const T*, const WeightMatrix<T>&);
+
+private:
+	// number of nodes checked and evaluated at once, below a share of 1/single nodes left
+	// in a block they are evaluated one by one
+	enum { block = 64, single = 4 };
+	//takes the nodes added since the last search into account
+	void                     update(const WeightMatrix<T>&);
+	//computes the distances of the node to all other nodes
+	void                     refresh(const unsigned int&, const WeightMatrix<T>&);
+	//enlarges the storage for the given number of nodes
+	void                     reserve(const unsigned int&);
+	//returns the distance of a pair when it was computed
+	inline T&                distance(const unsigned int& i, const unsigned int& j) { return _distances[i * _capacity + j]; }
+	//returns the sum of the moves of both nodes when the distance of the pair was computed
+	inline double&           stamp(const unsigned int& i, const unsigned int& j) { return _stamps[i * _capacity + j]; }
+	//returns a lower bound of the distance of a pair
+	inline double            lowerBound(const unsigned int&, const unsigned int&);
+	bool                     _enabled;
+	unsigned int             _maxNodes;
+	T                        _maxDrift;
+	unsigned int             _dim;
+	unsigned int             _size;
+	unsigned int             _capacity;
+	std::vector<T>           _distances;
+	std::vector<double>      _stamps;
+	std::vector<T>           _positions;
+	std::vector<double>      _drift;
+	std::vector<double>      _rowDrift;
+	std::vector<double>      _rowHalf;
+	std::vector<bool>        _refreshed;
+	std::vector<bool>        _unknown;
+	bool                     _replaced;
+	std::vector<double>      _half;
+	std::vector<T>           _squared;
+	Stats                    _stats;
+};
+
+/** \brief assignment copying the settings only, the bounds are computed by the next search
+*/
+template<typename T> TriangleBounds<T>& TriangleBounds<T>::operator=(const TriangleBounds& t)
+{
+	_enabled  = t._enabled;
+	_maxNodes = t._maxNodes;
+	_maxDrift = t._maxDrift;
+	_size     = 0;
+	return *this;
+}
+
+/** \brief removes a node that is deleted from the graph
+*
+* If it is not the last node, moveNode is called afterwards for the last node.
+* \param index of the node
+*/
+template<typename T> void TriangleBounds<T>::eraseNode(const unsigned int& index)
+{
+	if (index + 1 == _size)
+		_size--;
+}
+
+/** \brief changes the index of a moved node
+*
+* The node taking the place of an erased one is the last node. Removing a node
+* never decreases a distance, thus all bounds stay valid.
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T> void TriangleBounds<T>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+	if (to >= _size)
+		return;
+	if (from >= _size)
+	{
+		// an added node that is not known yet takes the place, it may be closer to any node
+		for (unsigned int j = 0; j < _size; j++)
+		{
+			distance(to, j) = distance(j, to) = 0;
+			_half[j] = std::min(_half[j], 0.0);
+		}
+		_half[to]      = 0;
+		_refreshed[to] = false;
+		_unknown[to]   = true;
+		_replaced      = true;
+		return;
+	}
+	assert (from + 1 == _size);
+	for (unsigned int j = 0; j < _size; j++)
+	{
+		distance(to, j) = distance(from, j);
+		stamp(to, j)    = stamp(from, j);
+	}
+	for (unsigned int j = 0; j < _size; j++)
+	{
+		distance(j, to) = distance(j, from);
+		stamp(j, to)    = stamp(j, from);
+	}
+	distance(to, to) = 0;
+	std::copy(_positions.begin() + from * _dim, _positions.begin() + (from + 1) * _dim, _positions.begin() + to * _dim);
+	_drift[to]     = _drift[from];
+	_rowDrift[to]  = _rowDrift[from];
+	_rowHalf[to]   = _rowHalf[from];
+	_refreshed[to] = _refreshed[from];
+	_half[to]      = _half[from];
+	_unknown[to]   = _unknown[from];
+	_size--;
+}
+
+/** \brief accumulates the move of a node whose weight vector has been changed
+*
+* The distance of the node to every other node changes by at most the length of the
+* move, thus the bounds of its pairs are lowered by it. The half distance of the node
+* becomes the least of its bounds, the ones of the other nodes are lowered to their
+* bound to the node if it is less.
+* \param index of the node
+* \param weights weight matrix holding the new weight vector
+*/
+template<typename T> void TriangleBounds<T>::weightChanged(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	if (index >= _size)
+		return;
+	T* position = &_positions[index * _dim];
+	if (_unknown[index])
+	{
+		// its distances are unknown, only its position has to be taken
+		std::copy(weights.row(index), weights.row(index) + _dim, position);
+		_unknown[index] = false;
+		return;
+	}
+	const T move = euclidean<T> (weights.row(index), position, _dim);
+	std::copy(weights.row(index), weights.row(index) + _dim, position);
+	if (!(move > 0))
+		return;
+	_drift[index] += move;
+	double nearest = std::numeric_limits<double>::max();
+	for (unsigned int j = 0; j < _size; j++)
+		if (j != index)
+		{
+			const double bound = lowerBound(index, j);
+			nearest  = std::min(nearest, bound);
+			_half[j] = std::min(_half[j], 0.5 * bound);
+		}
+	_half[index] = 0.5 * nearest;
+}
+
+/** \brief determines the two winner nodes for the given item like GNGModulGraph::getWinner
+*
+* \param first_winner after func call the closest node, the smallest index among equally close ones
+* \param second_winner after func call the node that was closest before first_winner was found
+* \param x item
+* \param weights weight matrix of the graph
+* \return euclidean distance of the item to the first winner
+*/
+template<typename T> T TriangleBounds<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const T* x, const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	assert (_enabled);
+	if (n > _maxNodes)
+	{
+		_size = 0;
+		return nearestTwo<T> (x, weights, first_winner, second_winner);
+	}
+	update(weights);
+
+	// the bounds are computed distances, the margin covers their rounding errors
+	const T margin = 1 - 8 * _dim * std::numeric_limits<T>::epsilon();
+	T best_distance = std::numeric_limits<T>::max();
+	T best_squared  = std::numeric_limits<T>::max();
+	T squared[block];
+	unsigned int live[block];
+	unsigned int best = n;
+	first_winner  = 1;
+	second_winner = 0;
+	_stats.queries++;
+	_stats.scanned += n;
+
+	for (unsigned int begin = 0; begin < n; begin += block)
+	{
+		const unsigned int count = (n - begin < block) ? n - begin : (unsigned int) block;
+		if (best < n && best_distance <= _half[best] * margin)
+		{
+			_stats.skipped += n - begin;
+			break;
+		}
+		unsigned int left = 0;
+		for (unsigned int i = 0; i < count; i++)
+			if (best < n && (lowerBound(best, begin + i) - best_distance) * margin > best_distance)
+				_stats.skipped++;
+			else
+				live[left++] = i;
+		if (left * single > count)
+		{
+			squaredDistances<T> (x, weights, begin, count, squared);
+			_stats.evaluations += count;
+		}
+		else
+		{
+			for (unsigned int k = 0; k < left; k++)
+				squaredDistances<T> (x, weights, begin + live[k], 1, squared + live[k]);
+			_stats.evaluations += left;
+		}
+		for (unsigned int k = 0; k < left; k++)
+		{
+			const unsigned int i = live[k];
+			if (squared[i] < best_squared)
+			{
+				// different squares may have the same root
+				const T distance = T(sqrt(squared[i]));
+				if (distance < best_distance)
+				{
+					second_winner = first_winner;
+					first_winner  = begin + i;
+					best          = begin + i;
+					best_distance = distance;
+					best_squared  = squared[i];
+				}
+			}
+		}
+	}
+	if (_drift[first_winner] - _rowDrift[first_winner] > _maxDrift * _rowHalf[first_winner])
+		refresh(first_winner, weights);
+	return best_distance;
+}
+
+/** \brief takes the nodes added since the last search into account
+*
+* The rows of the added nodes and of the nodes that took the place of a removed one
+* before they were known are computed, which also lowers the half distances of the
+* other nodes to them.
+*/
+template<typename T> void TriangleBounds<T>::update(const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	if (weights.dim() != _dim || n < _size)
+	{
+		_dim      = weights.dim();
+		_size     = 0;
+		_capacity = 0;
+		_positions.clear();
+	}
+	if (n == _size && !_replaced)
+		return;
+	for (unsigned int i = 0; i < _size; i++)
+		if (_unknown[i])
+		{
+			std::copy(weights.row(i), weights.row(i) + _dim, _positions.begin() + i * _dim);
+			_unknown[i] = false;
+		}
+	_replaced = false;
+	if (n > _size)
+	{
+		reserve(n);
+		for (unsigned int i = _size; i < n; i++)
+		{
+			std::copy(weights.row(i), weights.row(i) + _dim, _positions.begin() + i * _dim);
+			_drift[i] = _rowDrift[i] = _rowHalf[i] = _half[i] = 0;
+			_refreshed[i] = false;
+			_unknown[i]   = false;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				distance(i, j) = distance(j, i) = 0;
+				stamp(i, j)    = stamp(j, i)    = 0;
+			}
+		}
+		_size = n;
+	}
+	for (unsigned int i = 0; i < _size; i++)
+		if (!_refreshed[i])
+			refresh(i, weights);
+}
+
+/** \brief computes the distances of the node to all other nodes
+*
+* The half distance of the node becomes exact, the ones of the other nodes are lowered
+* if the node is closer than their bound.
+* \param index of the node
+* \param weights weight matrix of the graph
+*/
+template<typename T> void TriangleBounds<T>::refresh(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	T nearest = std::numeric_limits<T>::max();
+	squaredDistances<T> (weights.row(index), weights, 0, _size, &_squared[0]);
+	for (unsigned int j = 0; j < _size; j++)
+	{
+		if (j == index)
+			continue;
+		const T d = T(sqrt(_squared[j]));
+		distance(index, j) = distance(j, index) = d;
+		stamp(index, j)    = stamp(j, index)    = _drift[index] + _drift[j];
+		_half[j] = std::min(_half[j], 0.5 * d);
+		nearest = std::min(nearest, d);
+	}
+	_stats.evaluations += _size - 1;
+	_stats.refreshes++;
+	_half[index]      = 0.5 * nearest;
+	_rowHalf[index]   = 0.5 * nearest;
+	_rowDrift[index]  = _drift[index];
+	_refreshed[index] = true;
+}
+
+/** \brief enlarges the storage for the given number of nodes, keeping the known pairs
+*/
+template<typename T> void TriangleBounds<T>::reserve(const unsigned int& nodes)
+{
+	if (nodes <= _capacity)
+	{
+		_positions.resize(_capacity * _dim);
+		return;
+	}
+	const unsigned int capacity = std::max(nodes, 2 * _capacity);
+	std::vector<T> distances (capacity * capacity, 0);
+	std::vector<double> stamps (capacity * capacity, 0);
+	for (unsigned int i = 0; i < _size; i++)
+		for (unsigned int j = 0; j < _size; j++)
+		{
+			distances[i * capacity + j] = distance(i, j);
+			stamps[i * capacity + j]    = stamp(i, j);
+		}
+	_distances.swap(distances);
+	_stamps.swap(stamps);
+	_capacity = capacity;
+	_positions.resize(capacity * _dim);
+	_drift.resize(capacity);
+	_rowDrift.resize(capacity);
+	_rowHalf.resize(capacity);
+	_refreshed.resize(capacity);
+	_unknown.resize(capacity);
+	_half.resize(capacity);
+	_squared.resize(capacity);
+}
+
+/** \brief returns a lower bound of the distance of a pair
+*
+* The moves of both nodes since the distance was computed are subtracted, the drifts
+* are large sums, their rounding error is subtracted as well.
+*/
+template<typename T> inline double TriangleBounds<T>::lowerBound(const unsigned int& i, const unsigned int& j)
+{
+	const double drift = _drift[i] + _drift[j];
+	return distance(i, j) - (drift - stamp(i, j)) - 4 * std::numeric_limits<double>::epsilon() * drift;
+}
+
+} // namespace neuralgas
+
+#endif
@@ -46,16 +46,17 @@ namespace neuralgas {
  * and the virtual function newNode() has to be overloaded in the derived graph class such that 
  * it returns a pointer to that newly defined but derived node data type. 
  * The same holds for the edges.
+ * The third template parameter selects the adjacency backend of Base_Graph.
  *
  * 
  */
-template<typename T,typename S> class UGraph : virtual public Base_Graph<T,S>
+template<typename T,typename S,typename A = SparseAdjacency< Base_Edge<S,T> > > class UGraph : virtual public Base_Graph<T,S,A>
 {
   public:
     //cto creating a graph with the same dimension for node and edge weight vectors
-                        UGraph(const unsigned int& dim) : Base_Graph<T,S>(dim){}
+                        UGraph(const unsigned int& dim) : Base_Graph<T,S,A>(dim){}
     //cto creating a graph with the different dimension for node and edge weight vectors
-                        UGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge){}
+                        UGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S,A>(dimNode,dimEdge){}
     /// dummy cto
                         UGraph () {};
     // copy cto
@@ -76,39 +77,26 @@ template<typename T,typename S> class UGraph : virtual public Base_Graph<T,S>
 *
 * \param graph the graph to be copied from
 */
-template<typename T,typename S> UGraph<T,S>::UGraph(const UGraph& g) :
-	Base_Graph<T,S> (g)
+template<typename T,typename S,typename A> UGraph<T,S,A>::UGraph(const UGraph& g) :
+	Base_Graph<T,S,A> (g)
 {
-	for (unsigned int i=0; i < g.size(); i++)
-		for (unsigned int j=0; j<g._nodes[i]->edges.size(); j++)
-			if ( g._nodes[i]->edges[j] != NULL )
-			{
-				this->addEdge (i, j);
-				this->_nodes[i]->edges[j]->weight = g._nodes[i]->edges[j]->weight;
-			}
+	this->cloneEdges (g);
 }
 
 /** \brief dto Graph deletion
  */
-template<typename T, typename S>
-UGraph<T,S>::~UGraph ()
+template<typename T, typename S, typename A>
+UGraph<T,S,A>::~UGraph ()
 {
-	for (unsigned int i=0; i<this->size(); i++)
-		for (unsigned int j=i+1; j<this->_nodes[i]->edges.size(); j++)
-			if (this->_nodes[i]->edges[j] != NULL)
-				delete this->_nodes[i]->edges[j];
-	
-	for (unsigned int i=0; i<this->size(); i++)
-		this->_nodes[i]->edges.clear();
-			     
+	// the edges are deleted by Base_Graph
 }
 
 
 /** \brief returns whether the two nodes are connected by an edge
 */
-template<typename T,typename S> inline bool UGraph<T,S>::areConnected(const unsigned int& x,const unsigned int& y)const
+template<typename T,typename S,typename A> inline bool UGraph<T,S,A>::areConnected(const unsigned int& x,const unsigned int& y)const
 {
-  return ( this->_nodes[x]->edges[y] != NULL );
+  return ( this->_adjacency.find(x,y) != NULL );
 } 
 
 
@@ -121,20 +109,22 @@ template<typename T,typename S> inline bool UGraph<T,S>::areConnected(const unsi
 *   \param x outgoing node, plays no role in the undirected graph
 *   \param y ingoing node, plays no role in the undirected graph
 */
-template<typename T,typename S> void UGraph<T,S>::addEdge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void UGraph<T,S,A>::addEdge(const unsigned int& x,const unsigned int& y)
 {
-  if ( this->_nodes[x]->edges[y] == NULL ) //self edges are allowed
+  if ( this->_adjacency.find(x,y) == NULL ) //self edges are allowed
   {
     Base_Edge<S,T>* new_edge = this->newEdge();
     new_edge->in             = this->_nodes[x]; //sets the ingoing node
     new_edge->out            = this->_nodes[y]; //sets the outgoing node
-    new_edge->weight.resize(this->_dimEdge);    //resizes the dim of the edge weight vec
+    new_edge->in_handle      = this->getHandle(x);
+    new_edge->out_handle     = this->getHandle(y);
+    if (this->_dimEdge > 0)
+      new_edge->weight.resize(this->_dimEdge);  //resizes the dim of the edge weight vec
     
-    this->_nodes[x]->edges[y]    =  new_edge;   //shares the same edge since its undirected
-    this->_nodes[y]->edges[x]    =  new_edge;
+    this->_adjacency.linkMutual(x, y, new_edge); //shares the same edge since its undirected
     
-    this->_nodes[x]->num_connections++;      // number of connections are increased
-    this->_nodes[y]->num_connections++;  
+    this->incConnections(x);                 // number of connections are increased
+    this->incConnections(y);
   }      
   
 }  
@@ -148,18 +138,17 @@ template<typename T,typename S> void UGraph<T,S>::addEdge(const unsigned int& x,
 *   \param x outgoing node, plays no role in the undirected graph
 *   \param y ingoing node, plays no role in the undirected graph
 */
-template<typename T,typename S> void UGraph<T,S>::rmEdge(const unsigned int& x,const unsigned int& y)
+template<typename T,typename S,typename A> void UGraph<T,S,A>::rmEdge(const unsigned int& x,const unsigned int& y)
 {
 
-  if ( this->_nodes[x]->edges[y] != NULL ) //self edges are allowed
+  Base_Edge<S,T>* edge = this->_adjacency.unlinkMutual(x,y);
+  if ( edge != NULL ) //self edges are allowed
   {
-    delete this->_nodes[x]->edges[y];
-    this->_nodes[x]->edges[y]     =  NULL;
-    this->_nodes[y]->edges[x]     =  NULL;
-    this->_nodes[x]->num_connections--;
-    this->_nodes[y]->num_connections--;
-    assert (this->_nodes[x]->num_connections >= 0);
-    assert (this->_nodes[y]->num_connections >= 0);
+    this->deleteEdge(edge);
+    assert (this->_nodes[x]->num_connections > 0);
+    assert (this->_nodes[y]->num_connections > 0);
+    this->decConnections(x);
+    this->decConnections(y);
   }  
 }
 
@@ -30,24 +30,129 @@
 #define VECTOR_H
 
 #include <vector>
+#include <cassert>
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/serialization/serialization.hpp>
 #include <boost/pool/pool_alloc.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include "AlignedAllocator.h"
 
 namespace neuralgas {
 
 // #define _VPoolAlloc_ boost::pool_allocator<T, boost::default_user_allocator_new_delete, boost::details::pool::null_mutex>
 
+/** \brief type of the sums over many values of type T
+*
+* Sums that run over the whole data set or over many updates, e.g. the global error,
+* the MDL terms or the harmonic means of the errors, are kept in double when the
+* weights and the data are float. For the other types the sums have the type T.
+*/
+template<typename T> struct Accumulator
+{
+  typedef T type;
+};
+
+/// float values are summed in double
+template<> struct Accumulator<float>
+{
+  typedef double type;
+};
+
+/** \brief fused kernel y += factor * x in one pass without temporaries
+*
+* The products are rounded like those of operator* of Vector, i.e. x * (T)factor,
+* the result is the same as of y += factor * x.
+* \param y is the vector that is changed in place
+* \param factor is the scalar by which x is multiplied
+* \param x is the vector that is added
+* \param n is the dimension of both vectors
+*/
+template<typename T,typename S> inline void axpy(T* y, const S& factor, const T* x, const unsigned int& n)
+{
+  const T scalar = (T)factor;
+  for (unsigned int i=0; i < n; i++)
+    y[i] += x[i] * scalar;
+}
+
+/** \brief fused kernel y += rate * (x - y) moving y toward x in one pass without temporaries
+*
+* This is the update rule of the weight vectors, the result is the same
+* as of y += rate * (x - y).
+* \param y is the vector that is moved in place
+* \param x is the vector toward which y is moved
+* \param rate is the fraction of the difference by which y is moved
+* \param n is the dimension of both vectors
+*/
+template<typename T,typename S> inline void moveToward(T* y, const T* x, const S& rate, const unsigned int& n)
+{
+  const T scalar = (T)rate;
+  for (unsigned int i=0; i < n; i++)
+    y[i] += (x[i] - y[i]) * scalar;
+}
+
+/** \brief moveToward for vectors stored at 64 byte boundaries with zero padding
+*
+* The loop runs over the padded length, thus it needs no scalar tail and is
+* vectorized with aligned loads. The padding of y stays zero, since the one of x is zero.
+* \param y is the vector that is moved in place, 64 byte aligned
+* \param x is the vector toward which y is moved, 64 byte aligned
+* \param rate is the fraction of the difference by which y is moved
+* \param stride is the padded length of both vectors, see paddedLength
+*/
+template<typename T,typename S> inline void moveTowardPadded(T* NEURALGAS_RESTRICT y, const T* NEURALGAS_RESTRICT x, const S& rate, const unsigned int& stride)
+{
+  T* a = static_cast<T*>(NEURALGAS_ASSUME_ALIGNED(y));
+  const T* b = static_cast<const T*>(NEURALGAS_ASSUME_ALIGNED(x));
+  const T scalar = (T)rate;
+  for (unsigned int i=0; i < stride; i++)
+    a[i] += (b[i] - a[i]) * scalar;
+}
+
+/** \brief fused kernel y = a * x + b * z in one pass without temporaries
+*
+* The result is the same as of y = a * x; y += b * z.
+* \param y is the vector that is overwritten, it may be x or z
+* \param a is the scalar by which x is multiplied
+* \param x is the first vector
+* \param b is the scalar by which z is multiplied
+* \param z is the second vector
+* \param n is the dimension of the vectors
+*/
+template<typename T,typename S> inline void linearCombination(T* y, const S& a, const T* x, const S& b, const T* z, const unsigned int& n)
+{
+  const T first  = (T)a;
+  const T second = (T)b;
+  for (unsigned int i=0; i < n; i++)
+    y[i] = x[i] * first + z[i] * second;
+}
+
+// vector of the fixed dimension N with inline storage, N = 0 is the vector of a dimension set at runtime
+template<typename T, unsigned int N = 0> class Vector;
+
 //! \class Vector
 /*! \brief Implements operations for n-dimensional vectors. Caution! Default constructor
            produces a one-dimensional vector
+
+    This is Vector<T>, i.e. Vector<T,0>, the values are stored on the heap and the
+    dimension is set at runtime. Vector<T,N> has a fixed dimension instead.
+    The storage comes from AlignedAllocator, it starts at a 64 byte boundary and
+    is padded to stride() elements. The padding is zero only as long as the vector
+    is changed through the members of Vector: every member that shrinks it (resize,
+    pop_back, clear, erase, assign and the assignment) zeroes the removed values,
+    thus kernels may run over the whole stride like over the rows of a WeightMatrix.
+    The members of the base std::vector are not virtual, thus resize, erase, assign
+    etc. called through a reference or pointer to the base leave the removed values
+    in the padding. Code that changes a Vector through its base has to zero the
+    padding itself before a kernel runs over the stride.
  */
-template<typename T> class Vector : public std::vector<T>
+template<typename T> class Vector<T,0> : public std::vector<T, AlignedAllocator<T> >
 {
   	friend class boost::serialization::access;
 public:
+	/// container of the values
+	typedef std::vector<T, AlignedAllocator<T> > Base;
 	/// default constructor
 	inline Vector(){this->resize(1);}
 	/// constructor specifying dimension
@@ -56,14 +161,36 @@ public:
 	inline Vector(const int& dim,const T& value){this->resize(dim,value);}
 	// copy constructor
 	inline Vector(const std::vector<T>& v);
-	//operator+= based on the operations = and +
+	/// returns the number of elements of the padded storage, a multiple of 64 bytes
+	inline unsigned int stride() const { return paddedLength<T>(this->size()); }
+	// sets the dimension keeping the padding zero
+	inline void resize(const typename Base::size_type&, const T& value = T());
+	/// removes the last value keeping the padding zero
+	inline void pop_back() { this->back() = T(); Base::pop_back(); }
+	/// removes all values keeping the padding zero
+	inline void clear() { std::fill(this->begin(), this->end(), T()); Base::clear(); }
+	// assigns the values of another vector keeping the padding zero
+	inline Vector<T>& operator=(const Vector<T>&);
+	// assigns copies of a value keeping the padding zero
+	inline void assign(const typename Base::size_type&, const T&);
+	// assigns the values of a range keeping the padding zero
+	template<typename I> inline void assign(I, I);
+	// removes a value keeping the padding zero
+	inline typename Base::iterator erase(typename Base::iterator);
+	// removes a range of values keeping the padding zero
+	inline typename Base::iterator erase(typename Base::iterator, typename Base::iterator);
+	//operator+= adding a vector in place
 	inline Vector<T>& operator+=(const Vector<T>&);
-	//operator-= based on the operations = and -
+	//operator-= subtracting a vector in place
 	inline Vector<T>& operator-=(const Vector<T>&);
-	//operator*= for scalars based on the operations = and *
+	//operator*= for scalars multiplying in place
 	template<typename S> inline Vector<T>& operator*=(const S&);
-	//operator/= for scalars based on the operations = and /
+	//operator/= for scalars dividing in place
 	template<typename S> inline Vector<T>& operator/=(const S&);
+	//adds a multiple of a vector in place, i.e. *this += factor * x
+	template<typename S> inline Vector<T>& axpy(const S&, const Vector<T>&);
+	//moves the vector toward another one in place, i.e. *this += rate * (x - *this)
+	template<typename S> inline Vector<T>& moveToward(const Vector<T>&, const S&);
 	// operator+ adding two vectors and returning a new result vector         
 	inline Vector<T> operator+(const Vector<T>&);
 	// const operator+ adding two const vectors and returning a new result vector         
@@ -95,53 +222,187 @@ public:
 	}
         
 private:
-	// dummy variable for operator[] that is returned if given index is out of range
-	T _dummy;
 	template<class Archive>
 	void serialize(Archive & ar, const unsigned int);
+	/// returns the start of the storage, NULL if the vector is empty
+	inline T* storage() { return this->empty() ? NULL : &(*this)[0]; }
+	// zeroes the values removed from the storage by shrinking from the given size
+	inline void zeroRemoved(T*, const typename Base::size_type&);
 
 };
 
-/** operator+= based on the operations = and +
+/** operator+= adding a vector in place
 *
+* A vector of a different dimension is not added.
 * \param to_add_assign is what has to be added
 */
 template<typename T> inline Vector<T>& Vector<T>::operator+=(const Vector<T>& to_add_assign)
 {
-  (*this) = (*this) + to_add_assign;
+  if (this->size() == to_add_assign.size())
+    for (unsigned int i=0; i < this->size(); i++)
+      (*this)[i] += to_add_assign[i];
   return *this;
 }  
 
-/** operator-= based on the operations = and -
+/** operator-= subtracting a vector in place
 *
+* A vector of a different dimension is not subtracted.
 * \param to_subtract_assign is what has to be subtracted 
 */
 template<typename T> inline Vector<T>& Vector<T>::operator-=(const Vector<T>& to_subtract_assign)
 {
-  (*this) = (*this) - to_subtract_assign;
+  if (this->size() == to_subtract_assign.size())
+    for (unsigned int i=0; i < this->size(); i++)
+      (*this)[i] -= to_subtract_assign[i];
   return *this;
 }  
 
-/** operator*= for scalars based on the operations = and *
+/** operator*= for scalars multiplying in place
 *
 * \param to_mul_assign is the factor by which the vector has to be multiplied
 */
 template<typename T> template<typename S> inline Vector<T>& Vector<T>::operator*=(const S& to_mul_assign)
 {
-  (*this) = (*this) * to_mul_assign;
+  const T scalar = (T)to_mul_assign;
+  for (unsigned int i=0; i < this->size(); i++)
+    (*this)[i] *= scalar;
   return *this;
 }  
 
-/** operator/= for scalars based on the operations = and /
+/** operator/= for scalars dividing in place
 *
 * \param to_div_assign is the factor by which the vector has to be divided
 */
 template<typename T> template<typename S> inline Vector<T>& Vector<T>::operator/=(const S& to_div_assign)
 {
-  (*this) = (*this) / to_div_assign;
+  const T scalar = (T)to_div_assign;
+  for (unsigned int i=0; i < this->size(); i++)
+    (*this)[i] /= scalar;
   return *this;
 }  
 
+/** \brief adds a multiple of a vector in place, i.e. *this += factor * x
+*
+* Unlike the expression with operators no temporary vectors are created.
+* \param factor is the scalar by which x is multiplied
+* \param x is the vector that is added, it has to have the same dimension
+*/
+template<typename T> template<typename S> inline Vector<T>& Vector<T>::axpy(const S& factor, const Vector<T>& x)
+{
+  assert (x.size() == this->size());
+  if (!this->empty())
+    neuralgas::axpy(&(*this)[0], factor, &x[0], this->size());
+  return *this;
+}
+
+/** \brief moves the vector toward another one in place, i.e. *this += rate * (x - *this)
+*
+* Unlike the expression with operators no temporary vectors are created.
+* \param x is the vector toward which the vector is moved, it has to have the same dimension
+* \param rate is the fraction of the difference by which the vector is moved
+*/
+template<typename T> template<typename S> inline Vector<T>& Vector<T>::moveToward(const Vector<T>& x, const S& rate)
+{
+  assert (x.size() == this->size());
+  if (!this->empty())
+    moveTowardPadded(&(*this)[0], &x[0], rate, stride());
+  return *this;
+}
+
+/** \brief zeroes the values removed from the storage by shrinking from the given size
+*
+* Shrinking never reallocates, thus the removed values are still part of the storage.
+* \param data start of the storage before the vector was changed
+* \param former_size size before the vector was changed
+*/
+template<typename T> inline void Vector<T>::zeroRemoved(T* data, const typename Base::size_type& former_size)
+{
+  if (this->size() < former_size)
+    std::fill(data + this->size(), data + former_size, T());
+}
+
+/** \brief assigns the values of another vector keeping the padding zero
+*
+* \param v vector whose values are copied
+*/
+template<typename T> inline Vector<T>& Vector<T>::operator=(const Vector<T>& v)
+{
+  typename Base::size_type former_size = this->size();
+  T* data = storage();
+  Base::operator=(v);
+  zeroRemoved(data, former_size);
+  return *this;
+}
+
+/** \brief assigns copies of a value keeping the padding zero
+*
+* \param dim new dimension
+* \param value of all values
+*/
+template<typename T> inline void Vector<T>::assign(const typename Base::size_type& dim, const T& value)
+{
+  typename Base::size_type former_size = this->size();
+  T* data = storage();
+  Base::assign(dim, value);
+  zeroRemoved(data, former_size);
+}
+
+/** \brief assigns the values of a range keeping the padding zero
+*
+* \param first start of the range
+* \param last end of the range
+*/
+template<typename T> template<typename I> inline void Vector<T>::assign(I first, I last)
+{
+  typename Base::size_type former_size = this->size();
+  T* data = storage();
+  Base::assign(first, last);
+  zeroRemoved(data, former_size);
+}
+
+/** \brief removes a value keeping the padding zero
+*
+* \param position of the removed value
+* \return position of the value behind the removed one
+*/
+template<typename T> inline typename Vector<T>::Base::iterator Vector<T>::erase(typename Base::iterator position)
+{
+  typename Base::size_type former_size = this->size();
+  T* data = storage();
+  typename Base::iterator next = Base::erase(position);
+  zeroRemoved(data, former_size);
+  return next;
+}
+
+/** \brief removes a range of values keeping the padding zero
+*
+* \param first start of the removed range
+* \param last end of the removed range
+* \return position of the value behind the removed ones
+*/
+template<typename T> inline typename Vector<T>::Base::iterator Vector<T>::erase(typename Base::iterator first, typename Base::iterator last)
+{
+  typename Base::size_type former_size = this->size();
+  T* data = storage();
+  typename Base::iterator next = Base::erase(first, last);
+  zeroRemoved(data, former_size);
+  return next;
+}
+
+/** \brief sets the dimension keeping the padding zero
+*
+* The values removed by shrinking are zeroed before, so that they are zero
+* as part of the padding.
+* \param dim new dimension
+* \param value of the added values
+*/
+template<typename T> inline void Vector<T>::resize(const typename Base::size_type& dim, const T& value)
+{
+  if (dim < this->size())
+    std::fill(this->begin() + dim, this->end(), T());
+  Base::resize(dim, value);
+}
+
 /** \brief const operator+ adding two const vectors and returning a new result vector
 *
 *   The const operator+ adds two const vectors of an arbitray type, creates a result vector
@@ -373,7 +634,206 @@ template<class Archive>
 void 
 Vector<T>::serialize(Archive & ar, const unsigned int /* file_version */) 
 {
-  ar & boost::serialization::base_object<std::vector<T> >(*this);
+  ar & boost::serialization::base_object<Base>(*this);
+}
+
+//! \class Vector<T,N>
+/*! \brief Implements the operations of Vector<T> for vectors of the fixed dimension N
+
+    The values are stored inline, thus constructing, copying and the binary operators
+    do not allocate. It is meant for low dimensional data like the one of MackeyGlass or
+    GaussianNoise, where the heap allocation costs more than the arithmetic. The
+    operators round like those of Vector<T>, a Vector<T,N> converts into a Vector<T>
+    and back. The default constructor sets all N values to zero.
+ */
+template<typename T, unsigned int N> class Vector
+{
+  	friend class boost::serialization::access;
+public:
+	typedef T        value_type;
+	typedef T*       iterator;
+	typedef const T* const_iterator;
+	/// default constructor setting all values to zero
+	inline Vector() { std::fill(_data, _data + N, T()); }
+	/// constructor setting all values to value
+	inline explicit Vector(const T& value) { std::fill(_data, _data + N, value); }
+	// constructor copying a vector of dimension N
+	inline Vector(const std::vector<T>&);
+	// conversion into a vector of a dimension set at runtime
+	inline operator Vector<T>() const;
+	/// returns the dimension N
+	inline unsigned int size() const { return N; }
+	/// returns false, there are N values
+	inline bool empty() const { return false; }
+	/// the dimension is fixed, only a call with N is permitted like for Vector<T>
+	inline void resize(const unsigned int& dim) { assert(dim == N); }
+	/// returns a reference to the i-th value
+	inline T& operator[](const unsigned int& i) { assert(i < N); return _data[i]; }
+	/// returns a const reference to the i-th value
+	inline const T& operator[](const unsigned int& i) const { assert(i < N); return _data[i]; }
+	/// returns a ptr to the first value
+	inline iterator begin() { return _data; }
+	/// returns a ptr behind the last value
+	inline iterator end() { return _data + N; }
+	/// returns a const ptr to the first value
+	inline const_iterator begin() const { return _data; }
+	/// returns a const ptr behind the last value
+	inline const_iterator end() const { return _data + N; }
+	//operator+= adding a vector in place
+	inline Vector& operator+=(const Vector&);
+	//operator-= subtracting a vector in place
+	inline Vector& operator-=(const Vector&);
+	//operator*= for scalars multiplying in place
+	template<typename S> inline Vector& operator*=(const S&);
+	//operator/= for scalars dividing in place
+	template<typename S> inline Vector& operator/=(const S&);
+	//adds a multiple of a vector in place, i.e. *this += factor * x
+	template<typename S> inline Vector& axpy(const S&, const Vector&);
+	//moves the vector toward another one in place, i.e. *this += rate * (x - *this)
+	template<typename S> inline Vector& moveToward(const Vector&, const S&);
+	/// operator+ adding two vectors and returning the sum
+	inline Vector operator+(const Vector& to_add) const { Vector result(*this); return result += to_add; }
+	/// operator- subtracting two vectors and returning the difference
+	inline Vector operator-(const Vector& to_subtract) const { Vector result(*this); return result -= to_subtract; }
+	/// operator* multiplying by a scalar from the right and returning the product
+	template<typename S> inline Vector operator*(const S& factor) const { Vector result(*this); return result *= factor; }
+	/// operator/ dividing by a scalar from the right and returning the quotient
+	template<typename S> inline Vector operator/(const S& factor) const { Vector result(*this); return result /= factor; }
+
+	/** \brief friend operator* permitting a multiplication from the left with an arbitrary type
+	 *
+	 * \param factor is the scalar by which the vector is multiplied
+	 * \param v is the vector that is multiplied by the scalar
+	 */
+	template<typename S> friend inline Vector operator*(const S& factor,const Vector& v)
+	{
+		return v*factor;
+	}
+
+private:
+	// values
+	T _data[N];
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int);
+};
+
+/** \brief constructor copying a vector of dimension N
+*
+* \param v vector to be copied from, it has to have the dimension N
+*/
+template<typename T, unsigned int N> inline Vector<T,N>::Vector(const std::vector<T>& v)
+{
+  assert (v.size() == N);
+  std::copy(v.begin(), v.begin() + N, _data);
+}
+
+/** \brief conversion into a vector of a dimension set at runtime copying the values
+*/
+template<typename T, unsigned int N> inline Vector<T,N>::operator Vector<T>() const
+{
+  Vector<T> result(N);
+  std::copy(_data, _data + N, result.begin());
+  return result;
+}
+
+/** operator+= adding a vector in place
+*
+* \param to_add_assign is what has to be added
+*/
+template<typename T, unsigned int N> inline Vector<T,N>& Vector<T,N>::operator+=(const Vector& to_add_assign)
+{
+  for (unsigned int i=0; i < N; i++)
+    _data[i] += to_add_assign._data[i];
+  return *this;
+}
+
+/** operator-= subtracting a vector in place
+*
+* \param to_subtract_assign is what has to be subtracted
+*/
+template<typename T, unsigned int N> inline Vector<T,N>& Vector<T,N>::operator-=(const Vector& to_subtract_assign)
+{
+  for (unsigned int i=0; i < N; i++)
+    _data[i] -= to_subtract_assign._data[i];
+  return *this;
+}
+
+/** operator*= for scalars multiplying in place
+*
+* \param to_mul_assign is the factor by which the vector has to be multiplied
+*/
+template<typename T, unsigned int N> template<typename S> inline Vector<T,N>& Vector<T,N>::operator*=(const S& to_mul_assign)
+{
+  const T scalar = (T)to_mul_assign;
+  for (unsigned int i=0; i < N; i++)
+    _data[i] *= scalar;
+  return *this;
+}
+
+/** operator/= for scalars dividing in place
+*
+* \param to_div_assign is the factor by which the vector has to be divided
+*/
+template<typename T, unsigned int N> template<typename S> inline Vector<T,N>& Vector<T,N>::operator/=(const S& to_div_assign)
+{
+  const T scalar = (T)to_div_assign;
+  for (unsigned int i=0; i < N; i++)
+    _data[i] /= scalar;
+  return *this;
+}
+
+/** \brief adds a multiple of a vector in place, i.e. *this += factor * x
+*
+* \param factor is the scalar by which x is multiplied
+* \param x is the vector that is added
+*/
+template<typename T, unsigned int N> template<typename S> inline Vector<T,N>& Vector<T,N>::axpy(const S& factor, const Vector& x)
+{
+  neuralgas::axpy(_data, factor, x._data, N);
+  return *this;
+}
+
+/** \brief moves the vector toward another one in place, i.e. *this += rate * (x - *this)
+*
+* \param x is the vector toward which the vector is moved
+* \param rate is the fraction of the difference by which the vector is moved
+*/
+template<typename T, unsigned int N> template<typename S> inline Vector<T,N>& Vector<T,N>::moveToward(const Vector& x, const S& rate)
+{
+  neuralgas::moveToward(_data, x._data, rate, N);
+  return *this;
+}
+
+template<typename T, unsigned int N>
+template<class Archive>
+void
+Vector<T,N>::serialize(Archive & ar, const unsigned int /* file_version */)
+{
+  for (unsigned int i=0; i < N; i++)
+    ar & _data[i];
+}
+
+/** \brief calls the member template run of a functor with the data dimension as template argument
+*
+* The algorithms are instantiated with the dimension set at runtime. A functor whose
+* member template run<N>() is instantiated for the fixed dimensions 1, 2, 3, 4, 8 and 16
+* lets the dimension dependent part of a step work on Vector<T,N>; run<0>() is called for
+* the other dimensions and works on Vector<T>, i.e. Vector<T,0>, like before.
+* \param dim is the dimension of the data
+* \param f is the functor
+*/
+template<typename F> inline void dispatchDimension(const unsigned int& dim, F& f)
+{
+  switch (dim)
+  {
+  case 1:  f.template run<1>(); break;
+  case 2:  f.template run<2>(); break;
+  case 3:  f.template run<3>(); break;
+  case 4:  f.template run<4>(); break;
+  case 8:  f.template run<8>(); break;
+  case 16: f.template run<16>(); break;
+  default: f.template run<0>();
+  }
 }
 
 
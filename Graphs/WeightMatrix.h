@@ -0,0 +1,615 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file WeightMatrix.h
+* \brief Contiguous row-major storage of the node weight vectors of a graph
+*
+*  \date    2026
+*/
+
+
+#ifndef WEIGHTMATRIX_H
+#define WEIGHTMATRIX_H
+
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include "AlignedAllocator.h"
+#include "Vector.h"
+
+namespace neuralgas {
+
+/** \class WeightMatrix
+ *  \brief Contiguous row-major storage of the node weight vectors of a graph
+ *
+ * Row i holds the weight vector of node i. Every row starts at a 64 byte
+ * boundary, the stride between two rows is the dimension rounded up to
+ * a multiple of 64 bytes and the padding at the end of each row is kept zero,
+ * so that distance kernels may stream over full cache lines.
+ * Rows are appended with amortized doubling growth. Removing a row either
+ * keeps the order of the remaining rows (eraseRow, O(N*D)) or moves the last
+ * row into the hole (swapRemoveRow, O(D)).
+ * Since the storage may be moved by addRow, ptrs into the matrix have to be
+ * refreshed whenever addRow returns true.
+ * T has to be a plain arithmetic type.
+ *
+ * \param _data aligned storage of capacity rows
+ * \param _rows number of rows in use
+ * \param _capacity number of allocated rows
+ * \param _dim dimension of the weight vectors
+ * \param _stride distance of two consecutive rows in elements
+ */
+template<typename T> class WeightMatrix
+{
+public:
+	// alignment of the rows in bytes
+	enum { alignment = 64 };
+	//std cto creating an empty matrix of dimension 0
+	WeightMatrix() : _data(NULL), _rows(0), _capacity(0), _dim(0), _stride(0) {}
+	//std dto
+	~WeightMatrix() { alignedFree(_data); }
+	//sets the dimension of the rows, the matrix has to be empty
+	void                setDim(const unsigned int&);
+	//appends a zeroed row, returns true if the storage has been moved
+	bool                addRow();
+	//removes a row and shifts the following rows up by one
+	void                eraseRow(const unsigned int&);
+	//removes a row by moving the last row into its place
+	void                swapRemoveRow(const unsigned int&);
+	//copies the rows of another matrix leaving out one of them, both have to have the same shape
+	void                copyRows(const WeightMatrix&, const unsigned int&);
+	//removes all rows, the storage is kept
+	void                clear() { _rows = 0; }
+	//returns a ptr to the first element of the given row
+	inline T*           row(const unsigned int& index) { assert(index < _rows); return _data + index * _stride; }
+	//returns a const ptr to the first element of the given row
+	inline const T*     row(const unsigned int& index) const { assert(index < _rows); return _data + index * _stride; }
+	//returns a ptr to the first row
+	inline const T*     data() const { return _data; }
+	//returns the number of rows
+	inline unsigned int rows() const { return _rows; }
+	//returns the dimension of the rows
+	inline unsigned int dim() const { return _dim; }
+	//returns the distance of two consecutive rows in elements
+	inline unsigned int stride() const { return _stride; }
+
+private:
+	// copying would invalidate the node views referring to the matrix
+	WeightMatrix(const WeightMatrix&);
+	WeightMatrix& operator=(const WeightMatrix&);
+	//reallocates the storage for the given number of rows
+	void                reserve(const unsigned int&);
+	// aligned storage of _capacity rows
+	T*                  _data;
+	// number of rows in use
+	unsigned int        _rows;
+	// number of allocated rows
+	unsigned int        _capacity;
+	// dimension of the weight vectors
+	unsigned int        _dim;
+	// distance of two consecutive rows in elements
+	unsigned int        _stride;
+};
+
+/** \brief sets the dimension of the rows and computes the padded stride
+*
+* \param dim dimension of the weight vectors
+*/
+template<typename T> void WeightMatrix<T>::setDim(const unsigned int& dim)
+{
+  assert (_rows == 0);
+  _dim    = dim;
+  _stride = paddedLength<T>(dim);
+  alignedFree(_data);
+  _data     = NULL;
+  _capacity = 0;
+}
+
+/** \brief reallocates the storage for the given number of rows keeping the used rows
+*
+* \param capacity new number of allocated rows
+*/
+template<typename T> void WeightMatrix<T>::reserve(const unsigned int& capacity)
+{
+  assert (capacity >= _rows);
+  T* data = static_cast<T*>( alignedMalloc(std::size_t(capacity) * _stride * sizeof(T), alignment) );
+  assert (data != NULL);
+  if (_rows > 0)
+    std::memcpy(data, _data, std::size_t(_rows) * _stride * sizeof(T));
+  alignedFree(_data);
+  _data     = data;
+  _capacity = capacity;
+}
+
+/** \brief appends a row whose elements are zero
+*
+* The capacity is doubled if the storage is exhausted, thus the amortized cost is O(D).
+* \return true if the rows have been moved to a new storage
+*/
+template<typename T> bool WeightMatrix<T>::addRow()
+{
+  bool moved = false;
+  if (_rows == _capacity)
+  {
+    reserve( (_capacity < 8) ? 8 : 2 * _capacity );
+    moved = true;
+  }
+  std::memset(_data + std::size_t(_rows) * _stride, 0, _stride * sizeof(T));
+  _rows++;
+  return moved;
+}
+
+/** \brief removes a row and shifts the following rows up by one keeping their order
+*
+* \param index of the row that shall be removed
+*/
+template<typename T> void WeightMatrix<T>::eraseRow(const unsigned int& index)
+{
+  assert (index < _rows);
+  if (index + 1 < _rows)
+    std::memmove(_data + std::size_t(index) * _stride, _data + std::size_t(index + 1) * _stride,
+                 std::size_t(_rows - index - 1) * _stride * sizeof(T));
+  _rows--;
+}
+
+/** \brief removes a row by moving the last row into its place
+*
+* \param index of the row that shall be removed
+*/
+template<typename T> void WeightMatrix<T>::swapRemoveRow(const unsigned int& index)
+{
+  assert (index < _rows);
+  if (index + 1 < _rows)
+    std::memcpy(_data + std::size_t(index) * _stride, _data + std::size_t(_rows - 1) * _stride,
+                _stride * sizeof(T));
+  _rows--;
+}
+
+/** \brief copies the rows of another matrix into the rows of this matrix
+*
+* The rows are copied by a single block copy. If removed is a row of src it is left out
+* and the last row of src takes its place, as in swapRemoveRow. This matrix has to have
+* as many rows as are copied and the same dimension as src.
+* \param src matrix to be copied from
+* \param removed row of src that is left out, no row is left out if it is not in src
+*/
+template<typename T> void WeightMatrix<T>::copyRows(const WeightMatrix& src, const unsigned int& removed)
+{
+  assert (_dim == src._dim && _stride == src._stride);
+  assert (_rows == ((removed < src._rows) ? src._rows - 1 : src._rows));
+  if (_rows == 0)
+    return;
+  std::memcpy(_data, src._data, std::size_t(_rows) * _stride * sizeof(T));
+  if (removed < _rows)
+    std::memcpy(_data + std::size_t(removed) * _stride, src._data + std::size_t(_rows) * _stride, _stride * sizeof(T));
+}
+
+/** \class NodeWeight
+ *  \brief Weight vector of a node, a view on a row of the WeightMatrix of its graph
+ *
+ * As long as the node belongs to a graph the values live in the WeightMatrix
+ * of the graph and the view only refers to them. A node that is not bound to a graph,
+ * e.g. a node that is loaded from a file or a copy of a node, stores its values itself.
+ * Binding such a node to a row copies its values into the matrix.
+ * The arithmetic operators mirror those of Vector<T>. Binary operators return
+ * a new Vector<T>, the compound assignments work in place. axpy and moveToward
+ * fuse the update rules of the algorithms into one pass without temporaries.
+ * Where a Vector<T> is expected the values are copied implicitly.
+ *
+ * \param _data ptr to the first value, either into the matrix or into _own
+ * \param _size dimension of the weight vector
+ * \param _own storage of an unbound weight vector
+ * \param _bound true if the values live in a WeightMatrix
+ */
+template<typename T> class NodeWeight
+{
+	friend class boost::serialization::access;
+public:
+	/// std cto creating an unbound empty weight vector
+	NodeWeight() : _data(NULL), _size(0), _bound(false) {}
+	// copy cto, the copy is always unbound
+	NodeWeight(const NodeWeight&);
+	// copies the values of another weight vector
+	NodeWeight& operator=(const NodeWeight&);
+	// copies the values of a vector
+	NodeWeight& operator=(const Vector<T>&);
+	/// returns a reference to the i-th value
+	inline T& operator[](const unsigned int& i) { assert(i < _size); return _data[i]; }
+	/// returns a const reference to the i-th value
+	inline const T& operator[](const unsigned int& i) const { assert(i < _size); return _data[i]; }
+	/// returns the dimension
+	inline unsigned int size() const { return _size; }
+	/// returns a ptr to the first value
+	inline T* data() { return _data; }
+	/// returns a const ptr to the first value
+	inline const T* data() const { return _data; }
+	/// returns true if the values live in a WeightMatrix
+	inline bool isBound() const { return _bound; }
+	// sets the dimension, a bound weight vector cannot change its dimension
+	void resize(const unsigned int&);
+	// lets the view refer to a row of a WeightMatrix
+	void bind(T*, const unsigned int&);
+	// copies the values back into the own storage
+	void unbind();
+	// conversion into a Vector copying the values
+	operator Vector<T>() const;
+	// operator+= adding a vector in place
+	NodeWeight& operator+=(const Vector<T>&);
+	// operator-= subtracting a vector in place
+	NodeWeight& operator-=(const Vector<T>&);
+	// operator*= multiplying by a scalar in place
+	template<typename S> NodeWeight& operator*=(const S&);
+	// operator/= dividing by a scalar in place
+	template<typename S> NodeWeight& operator/=(const S&);
+	// adds a multiple of a vector in place, i.e. *this += factor * x
+	template<typename S> NodeWeight& axpy(const S&, const Vector<T>&);
+	// moves the weight vector toward a vector in place, i.e. *this += rate * (x - *this)
+	template<typename S> NodeWeight& moveToward(const Vector<T>&, const S&);
+	// operator+ adding a vector and returning a new result vector
+	Vector<T> operator+(const Vector<T>&) const;
+	// operator+ adding a weight vector and returning a new result vector
+	Vector<T> operator+(const NodeWeight&) const;
+	// operator- subtracting a vector and returning a new result vector
+	Vector<T> operator-(const Vector<T>&) const;
+	// operator- subtracting a weight vector and returning a new result vector
+	Vector<T> operator-(const NodeWeight&) const;
+	// operator* multiplying by a scalar from the right and returning a new result vector
+	template<typename S> Vector<T> operator*(const S&) const;
+	// operator/ dividing by a scalar from the right and returning a new result vector
+	template<typename S> Vector<T> operator/(const S&) const;
+
+	/** \brief friend operator* permitting a multiplication from the left with an arbitrary type
+	 *
+	 * \param factor is the scalar by which the vector is multiplied
+	 * \param w is the weight vector that is multiplied by the scalar
+	 */
+	template<typename S> friend inline Vector<T> operator*(const S& factor,const NodeWeight<T>& w)
+	{
+		return w*factor;
+	}
+
+private:
+	// ptr to the first value, either into a matrix or into _own
+	T*               _data;
+	// dimension of the weight vector
+	unsigned int     _size;
+	// storage of an unbound weight vector
+	std::vector<T>   _own;
+	// true if the values live in a WeightMatrix
+	bool             _bound;
+
+	template<class Archive>
+	void save(Archive & ar, const unsigned int) const;
+	template<class Archive>
+	void load(Archive & ar, const unsigned int);
+	BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
+
+/** \brief copy cto, the copy stores the values itself
+*
+* \param w weight vector to be copied from
+*/
+template<typename T> NodeWeight<T>::NodeWeight(const NodeWeight& w) :
+	_data(NULL), _size(w._size), _own(w._data, w._data + w._size), _bound(false)
+{
+  if (_size > 0)
+    _data = &_own[0];
+}
+
+/** \brief copies the values of another weight vector
+*
+* An unbound weight vector takes over the dimension of w, a bound one
+* has to have the same dimension.
+* \param w weight vector to be copied from
+*/
+template<typename T> NodeWeight<T>& NodeWeight<T>::operator=(const NodeWeight& w)
+{
+  if (this != &w)
+  {
+    resize(w._size);
+    for (unsigned int i=0; i < _size; i++)
+      _data[i] = w._data[i];
+  }
+  return *this;
+}
+
+/** \brief copies the values of a vector
+*
+* An unbound weight vector takes over the dimension of v, a bound one
+* has to have the same dimension.
+* \param v vector to be copied from
+*/
+template<typename T> NodeWeight<T>& NodeWeight<T>::operator=(const Vector<T>& v)
+{
+  resize(v.size());
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] = v[i];
+  return *this;
+}
+
+/** \brief sets the dimension of the weight vector
+*
+* A bound weight vector has the dimension of its matrix, only a
+* call with that dimension is permitted.
+* \param dim new dimension
+*/
+template<typename T> void NodeWeight<T>::resize(const unsigned int& dim)
+{
+  if (_bound)
+  {
+    assert (dim == _size);
+    return;
+  }
+  _own.resize(dim);
+  _size = dim;
+  _data = (dim > 0) ? &_own[0] : NULL;
+}
+
+/** \brief lets the view refer to a row of a WeightMatrix
+*
+* If the weight vector stores values of the same dimension itself, they are
+* copied into the row before the own storage is released. A bound weight vector
+* is simply moved to the new row, e.g. after the matrix has been reallocated.
+* \param row ptr to the first element of the row
+* \param dim dimension of the row
+*/
+template<typename T> void NodeWeight<T>::bind(T* row, const unsigned int& dim)
+{
+  if (!_bound && _own.size() == dim)
+    for (unsigned int i=0; i < dim; i++)
+      row[i] = _own[i];
+  std::vector<T>().swap(_own);
+  _data  = row;
+  _size  = dim;
+  _bound = true;
+}
+
+/** \brief copies the values into the own storage, the view does not refer to a matrix afterwards
+*/
+template<typename T> void NodeWeight<T>::unbind()
+{
+  if (!_bound)
+    return;
+  _own.assign(_data, _data + _size);
+  _bound = false;
+  _data  = (_size > 0) ? &_own[0] : NULL;
+}
+
+/** \brief conversion into a Vector copying the values
+*/
+template<typename T> NodeWeight<T>::operator Vector<T>() const
+{
+  Vector<T> result(_size);
+  for (unsigned int i=0; i < _size; i++)
+    result[i] = _data[i];
+  return result;
+}
+
+/** \brief operator+= adding a vector in place
+*
+* \param v is what has to be added
+*/
+template<typename T> NodeWeight<T>& NodeWeight<T>::operator+=(const Vector<T>& v)
+{
+  assert (v.size() == _size);
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] += v[i];
+  return *this;
+}
+
+/** \brief operator-= subtracting a vector in place
+*
+* \param v is what has to be subtracted
+*/
+template<typename T> NodeWeight<T>& NodeWeight<T>::operator-=(const Vector<T>& v)
+{
+  assert (v.size() == _size);
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] -= v[i];
+  return *this;
+}
+
+/** \brief operator*= multiplying by a scalar in place
+*
+* \param factor is the scalar by which the vector is multiplied
+*/
+template<typename T> template<typename S> NodeWeight<T>& NodeWeight<T>::operator*=(const S& factor)
+{
+  const T scalar = (T)factor;
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] *= scalar;
+  return *this;
+}
+
+/** \brief operator/= dividing by a scalar in place
+*
+* \param factor is the scalar by which the vector is divided
+*/
+template<typename T> template<typename S> NodeWeight<T>& NodeWeight<T>::operator/=(const S& factor)
+{
+  const T scalar = (T)factor;
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] /= scalar;
+  return *this;
+}
+
+/** \brief adds a multiple of a vector in place, i.e. *this += factor * x
+*
+* Unlike the expression with operators no temporary vectors are created.
+* \param factor is the scalar by which x is multiplied
+* \param x is the vector that is added
+*/
+template<typename T> template<typename S> NodeWeight<T>& NodeWeight<T>::axpy(const S& factor, const Vector<T>& x)
+{
+  assert (x.size() == _size);
+  if (_size > 0)
+    neuralgas::axpy(_data, factor, &x[0], _size);
+  return *this;
+}
+
+/** \brief moves the weight vector toward a vector in place, i.e. *this += rate * (x - *this)
+*
+* This is the update rule of the winners and their neighbors, unlike the
+* expression with operators no temporary vectors are created. A row of a
+* WeightMatrix and the storage of x are both padded with zeros up to the stride,
+* so a bound weight is updated over the whole padded row without a scalar tail.
+* \param x is the vector toward which the weight vector is moved
+* \param rate is the fraction of the difference by which the weight vector is moved
+*/
+template<typename T> template<typename S> NodeWeight<T>& NodeWeight<T>::moveToward(const Vector<T>& x, const S& rate)
+{
+  assert (x.size() == _size);
+  if (_size == 0)
+    return *this;
+  if (_bound)
+    moveTowardPadded(_data, &x[0], rate, paddedLength<T>(_size));
+  else
+    neuralgas::moveToward(_data, &x[0], rate, _size);
+  return *this;
+}
+
+/** \brief operator+ adding a vector and returning a new result vector
+*
+* \param v is the vector that is added
+*/
+template<typename T> Vector<T> NodeWeight<T>::operator+(const Vector<T>& v) const
+{
+  Vector<T> result(_size);
+  if (v.size() == _size)
+    for (unsigned int i=0; i < _size; i++)
+      result[i] = _data[i] + v[i];
+  return result;
+}
+
+/** \brief operator+ adding a weight vector and returning a new result vector
+*
+* \param w is the weight vector that is added
+*/
+template<typename T> Vector<T> NodeWeight<T>::operator+(const NodeWeight& w) const
+{
+  Vector<T> result(_size);
+  if (w._size == _size)
+    for (unsigned int i=0; i < _size; i++)
+      result[i] = _data[i] + w._data[i];
+  return result;
+}
+
+/** \brief operator- subtracting a vector and returning a new result vector
+*
+* \param v is the vector that is subtracted
+*/
+template<typename T> Vector<T> NodeWeight<T>::operator-(const Vector<T>& v) const
+{
+  Vector<T> result(_size);
+  if (v.size() == _size)
+    for (unsigned int i=0; i < _size; i++)
+      result[i] = _data[i] - v[i];
+  return result;
+}
+
+/** \brief operator- subtracting a weight vector and returning a new result vector
+*
+* \param w is the weight vector that is subtracted
+*/
+template<typename T> Vector<T> NodeWeight<T>::operator-(const NodeWeight& w) const
+{
+  Vector<T> result(_size);
+  if (w._size == _size)
+    for (unsigned int i=0; i < _size; i++)
+      result[i] = _data[i] - w._data[i];
+  return result;
+}
+
+/** \brief operator* multiplying by a scalar from the right and returning a new result vector
+*
+* \param factor is the scalar by which the vector is multiplied
+*/
+template<typename T> template<typename S> Vector<T> NodeWeight<T>::operator*(const S& factor) const
+{
+  const T scalar = (T)factor;
+  Vector<T> result(_size);
+  for (unsigned int i=0; i < _size; i++)
+    result[i] = _data[i] * scalar;
+  return result;
+}
+
+/** \brief operator/ dividing by a scalar from the right and returning a new result vector
+*
+* \param factor is the scalar by which the vector is divided
+*/
+template<typename T> template<typename S> Vector<T> NodeWeight<T>::operator/(const S& factor) const
+{
+  const T scalar = (T)factor;
+  Vector<T> result(_size);
+  for (unsigned int i=0; i < _size; i++)
+    result[i] = _data[i] / scalar;
+  return result;
+}
+
+/** \brief operator+ adding a weight vector to a vector and returning a new result vector
+*
+* \param v is the lhs vector
+* \param w is the weight vector that is added
+*/
+template<typename T> inline Vector<T> operator+(const Vector<T>& v, const NodeWeight<T>& w)
+{
+  return w + v;
+}
+
+/** \brief operator- subtracting a weight vector from a vector and returning a new result vector
+*
+* \param v is the lhs vector
+* \param w is the weight vector that is subtracted
+*/
+template<typename T> inline Vector<T> operator-(const Vector<T>& v, const NodeWeight<T>& w)
+{
+  unsigned int tsize = v.size();
+  Vector<T> result(tsize);
+  if (tsize == w.size())
+    for (unsigned int i=0; i < tsize; i++)
+      result[i] = v[i] - w[i];
+  return result;
+}
+
+template<typename T>
+template<class Archive>
+void
+NodeWeight<T>::save(Archive & ar, const unsigned int /* file_version */) const
+{
+  const std::vector<T> values(_data, _data + _size);
+  ar & boost::serialization::make_nvp("weight", values);
+}
+
+template<typename T>
+template<class Archive>
+void
+NodeWeight<T>::load(Archive & ar, const unsigned int /* file_version */)
+{
+  std::vector<T> values;
+  ar & boost::serialization::make_nvp("weight", values);
+  resize(values.size());
+  for (unsigned int i=0; i < _size; i++)
+    _data[i] = values[i];
+}
+
+} // namespace neuralgas
+
+#endif
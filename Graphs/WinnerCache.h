@@ -0,0 +1,514 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file WinnerCache.h
+* \brief Exact winner search reusing the winners of a data item from its previous search
+*
+*  \date    2026
+*/
+
+
+#ifndef WINNERCACHE_H
+#define WINNERCACHE_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <math.h>
+#include <tools/distanceKernels.h>
+#include "WeightMatrix.h"
+
+namespace neuralgas {
+
+/** \class WinnerCache
+ *  \brief Exact winner search reusing the winners of a data item from its previous search
+ *
+ * The winners of every data item are kept together with lower bounds of the distances of
+ * the item to the other nodes. The first winner is the closest node, the second winner
+ * the closest node with a smaller index (the node 1 for the first winner 0), like the scan
+ * of GNGModulGraph::getWinner. When the item is searched again its distances to the cached
+ * winners are computed. If they are still below the bounds, lowered by the largest
+ * displacement of a node since the entry was written, the scan is skipped.
+ *
+ * The searches are split into generations, a generation lasts until about a _history-th
+ * of the data items could have been searched. The weights are copied when a generation
+ * starts and every node keeps its largest displacement from that copy during the
+ * generation (weightChanged), the largest one of all nodes is the radius of the generation.
+ * The displacement of a node since an entry was written is at most the radius of the
+ * generation of the entry, the largest displacement of a node between the copies of that
+ * generation and of the current one, and the radius of the current generation. Thus nodes
+ * oscillating around their position hardly lower the bounds. Entries of generations older
+ * than the last _history ones are invalid, an entry reaching half of that age is written
+ * again with the lowered bounds when it is used.
+ *
+ * Nodes added after an entry was written are compared with the item directly, the
+ * winners must be closer. Removed and moved nodes are announced by eraseNode and moveNode
+ * (see Base_Graph::rmNode), they invalidate the entries whose winners they are, the bounds
+ * of the other entries hold for less nodes as well. Copies only share the settings.
+ *
+ * \param _enabled whether the cache is used
+ * \param _dim dimension of the weights
+ * \param _size number of nodes that are known
+ * \param _capacity number of nodes the copies of the weights are allocated for
+ * \param _reset whether all entries have to be dropped by the next search
+ * \param _version number of changes of the nodes
+ * \param _stamps version when the node at every index was added or took the place of another one
+ * \param _added nodes added in the last _history generations
+ * \param _pending indices taken by added nodes since the last search
+ * \param _generation current generation
+ * \param _first first generation since the entries were dropped
+ * \param _searches number of searches in the current generation
+ * \param _entries cached winners of every data item
+ * \param _snapshots copies of the weights when the last _history generations started
+ * \param _radius largest displacement of a node from the copy during every generation
+ * \param _offset largest displacement of a node between the copy of every generation and the current one
+ * \param _stats counters of the searches
+ */
+template<typename T> class WinnerCache
+{
+public:
+	/// counters of the searches
+	struct Stats
+	{
+		Stats() : queries(0), hits(0) {}
+		// fraction of the searches answered by the cache
+		double hitRate() const { return queries ? double(hits) / queries : 0.0; }
+		// number of searches
+		unsigned long queries;
+		// number of searches whose cached winners were proven unchanged
+		unsigned long hits;
+	};
+	//std cto, the cache is disabled
+	WinnerCache() : _enabled(false), _dim(0), _size(0), _capacity(0), _reset(true), _version(1), _generation(0), _first(0), _searches(0) {}
+	//copy cto copying the settings only
+	WinnerCache(const WinnerCache& w) : _enabled(w._enabled), _dim(0), _size(0), _capacity(0), _reset(true), _version(1), _generation(0), _first(0), _searches(0) {}
+	//assignment copying the settings only
+	WinnerCache& operator=(const WinnerCache&);
+	//enables or disables the cache
+	void                     setEnabled(const bool& enabled) { _enabled = enabled; _reset = true; }
+	//returns whether the cache is enabled
+	inline bool              enabled() const { return _enabled; }
+	//returns the counters
+	inline const Stats&      stats() const { return _stats; }
+	//resets the counters
+	inline void              resetStats() { _stats = Stats(); }
+	//invalidates the entries won by a node that is deleted from the graph
+	void                     eraseNode(const unsigned int&);
+	//invalidates the entries won by the node at the new index of a moved node
+	void                     moveNode(const unsigned int&, const unsigned int&);
+	//accumulates the displacement of a node whose weight vector has been changed
+	void                     weightChanged(const unsigned int&, const WeightMatrix<T>&);
+	//determines the two winner nodes for the given data item like GNGModulGraph::getWinner
+	T                        getWinner(unsigned int&, unsigned int&, const T*, const unsigned int&, const WeightMatrix<T>&);
+
+private:
+	/// number of generations whose copies of the weights are kept
+	enum { _history = 16 };
+	/// cached winners of a data item
+	struct Entry
+	{
+		Entry() : first(1), second(0), others(0), before(0), version(0), generation(0) {}
+		// first winner
+		unsigned int first;
+		// second winner
+		unsigned int second;
+		// lower bound of the distances to the nodes except the first winner
+		double       others;
+		// lower bound of the distances to the nodes except both winners
+		double       before;
+		// version of the nodes when the entry was written
+		unsigned int version;
+		// generation when the entry was written
+		unsigned int generation;
+	};
+	/// node added to the known ones
+	struct Added
+	{
+		Added(const unsigned int& i, const unsigned int& v, const unsigned int& g) : index(i), version(v), stamp(v), generation(g) {}
+		// current index of the node
+		unsigned int index;
+		// version when the node was added
+		unsigned int version;
+		// version when the node got its current index
+		unsigned int stamp;
+		// generation when the node was added
+		unsigned int generation;
+	};
+	//drops all entries
+	void                     reset(const WeightMatrix<T>&);
+	//takes the nodes added since the last search into account
+	void                     update(const WeightMatrix<T>&);
+	//copies the weight vector of an added node into all copies
+	void                     add(const unsigned int&, const WeightMatrix<T>&);
+	//starts a new generation
+	void                     nextGeneration(const WeightMatrix<T>&);
+	//returns the copy of the weight vector of a node when the generation started
+	inline T*                snapshot(const unsigned int& generation, const unsigned int& index) { return &_snapshots[((generation % _history) * _capacity + index) * _dim]; }
+	//returns the euclidean distance of the item to a node as computed by nearestTwo
+	inline T                 distance(const T*, const unsigned int&, const WeightMatrix<T>&) const;
+	//scans all nodes and writes the entry of the item
+	T                        scan(unsigned int&, unsigned int&, const T*, Entry&, const WeightMatrix<T>&);
+	bool                     _enabled;
+	unsigned int             _dim;
+	unsigned int             _size;
+	unsigned int             _capacity;
+	bool                     _reset;
+	unsigned int             _version;
+	std::vector<unsigned int> _stamps;
+	std::vector<Added>       _added;
+	std::vector<unsigned int> _pending;
+	unsigned int             _generation;
+	unsigned int             _first;
+	unsigned int             _searches;
+	std::vector<Entry>       _entries;
+	std::vector<T>           _snapshots;
+	double                   _radius[_history];
+	double                   _offset[_history];
+	Stats                    _stats;
+};
+
+/** \brief assignment copying the settings only, the entries are written by the next searches
+*/
+template<typename T> WinnerCache<T>& WinnerCache<T>::operator=(const WinnerCache& w)
+{
+	_enabled = w._enabled;
+	_reset   = true;
+	return *this;
+}
+
+/** \brief invalidates the entries won by a node that is deleted from the graph
+*
+* If it is not the last node, moveNode is called afterwards for the last node.
+* \param index of the node
+*/
+template<typename T> void WinnerCache<T>::eraseNode(const unsigned int& index)
+{
+	_version++;
+	if (index + 1 == _size)
+		_size--;
+}
+
+/** \brief invalidates the entries won by the node at the new index of a moved node
+*
+* The node taking the place of an erased one is the last node, its copies are kept.
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T> void WinnerCache<T>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+	_version++;
+	if (to >= _size)
+		return;
+	if (from >= _size)
+	{
+		// an added node that is not known yet takes the place
+		_stamps[to] = _version;
+		_pending.push_back(to);
+		return;
+	}
+	assert (from + 1 == _size);
+	for (unsigned int g = 0; g < _history; g++)
+		std::copy(snapshot(g, from), snapshot(g, from) + _dim, snapshot(g, to));
+	_stamps[to] = _version;
+	for (unsigned int i = 0; i < _added.size(); i++)
+		if (_added[i].index == from && _added[i].stamp == _stamps[from])
+		{
+			_added[i].index = to;
+			_added[i].stamp = _version;
+		}
+	_size--;
+}
+
+/** \brief accumulates the displacement of a node whose weight vector has been changed
+*
+* \param index of the node
+* \param weights weight matrix holding the new weight vector
+*/
+template<typename T> void WinnerCache<T>::weightChanged(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	if (!_enabled || _reset || index >= _size)
+		return;
+	const T* w = weights.row(index);
+	const T* copy = snapshot(_generation, index);
+	double displacement = 0;
+	for (unsigned int k = 0; k < _dim; k++)
+	{
+		const double value = double(w[k]) - double(copy[k]);
+		displacement += value * value;
+	}
+	double& radius = _radius[_generation % _history];
+	radius = std::max(radius, sqrt(displacement));
+}
+
+/** \brief determines the two winner nodes for the given data item like GNGModulGraph::getWinner
+*
+* The winners and the returned distance are exactly those of the scan, the scan is
+* skipped if the bounds of the entry of the item prove that its winners are unchanged.
+*
+* \param first_winner after func call the closest node, the smallest index among equally close ones
+* \param second_winner after func call the node that was closest before first_winner was found
+* \param x data item
+* \param item index of the data item
+* \param weights weight matrix of the graph
+* \return euclidean distance of the item to the first winner
+*/
+template<typename T> T WinnerCache<T>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const T* x, const unsigned int& item, const WeightMatrix<T>& weights)
+{
+	assert (_enabled);
+	assert (weights.rows() >= 2);
+	update(weights);
+	_stats.queries++;
+	// a generation lasts until a part of the items could have been searched
+	if (++_searches >= std::max(64u, (unsigned int) _entries.size() / (_history / 2)))
+		nextGeneration(weights);
+	if (item >= _entries.size())
+		_entries.resize(item + 1);
+	Entry& entry = _entries[item];
+	if (entry.generation < _first || _generation - entry.generation >= _history ||
+	    entry.first >= _size || _stamps[entry.first] > entry.version)
+		return scan(first_winner, second_winner, x, entry, weights);
+	// the second winner is the node 1 or 0 for the first winners 0 and 1
+	const bool check_second = entry.first > 1;
+	if (check_second && (entry.second >= _size || _stamps[entry.second] > entry.version))
+		return scan(first_winner, second_winner, x, entry, weights);
+
+	// largest displacement of a node since the entry was written, up to rounding
+	const double margin = (_dim + 4) * double(std::numeric_limits<T>::epsilon());
+	const unsigned int g = entry.generation % _history;
+	const double current = _radius[_generation % _history];
+	const double displacement = ((entry.generation == _generation) ? 2 * current : _radius[g] + _offset[g] + current) * (1 + margin);
+	const double others = entry.others * (1 - margin) - displacement;
+	const double before = entry.before * (1 - margin) - displacement;
+	const T first_distance = distance(x, entry.first, weights);
+	if (!(first_distance * (1 + margin) < others * (1 - margin)))
+		return scan(first_winner, second_winner, x, entry, weights);
+	const T second_distance = check_second ? distance(x, entry.second, weights) : T(0);
+	if (check_second && !(second_distance * (1 + margin) < before * (1 - margin)))
+		return scan(first_winner, second_winner, x, entry, weights);
+
+	// the nodes added since then are compared directly, they have the largest indices
+	// unless they took the place of a removed node
+	double added = std::numeric_limits<double>::max();
+	for (unsigned int i = 0; i < _added.size(); i++)
+		if (_added[i].version > entry.version && _added[i].index < _size && _stamps[_added[i].index] == _added[i].stamp)
+		{
+			const double d = distance(x, _added[i].index, weights) * (1 - margin);
+			if (!(first_distance * (1 + margin) < d) ||
+			    (check_second && _added[i].index < entry.first && !(second_distance * (1 + margin) < d)))
+				return scan(first_winner, second_winner, x, entry, weights);
+			added = std::min(added, d);
+		}
+
+	if (_generation - entry.generation >= _history / 2)
+	{
+		// the entry is written again with the lowered bounds
+		entry.others     = std::min(others * (1 - margin), added);
+		entry.before     = std::min(before * (1 - margin), added);
+		entry.version    = _version;
+		entry.generation = _generation;
+	}
+	_stats.hits++;
+	first_winner  = entry.first;
+	second_winner = entry.second;
+	return first_distance;
+}
+
+/** \brief drops all entries and copies the weights
+*/
+template<typename T> void WinnerCache<T>::reset(const WeightMatrix<T>& weights)
+{
+	_dim      = weights.dim();
+	_size     = weights.rows();
+	_capacity = _size;
+	_reset    = false;
+	_version++;
+	_stamps.assign(_size, _version);
+	_added.clear();
+	_pending.clear();
+	_snapshots.resize(_history * _capacity * _dim);
+	_first    = _generation + 1;
+	nextGeneration(weights);
+}
+
+/** \brief takes the nodes added since the last search into account
+*/
+template<typename T> void WinnerCache<T>::update(const WeightMatrix<T>& weights)
+{
+	const unsigned int n = weights.rows();
+	if (_reset || _dim != weights.dim() || _size > n)
+	{
+		reset(weights);
+		return;
+	}
+	for (unsigned int i = 0; i < _pending.size(); i++)
+		if (_pending[i] < _size)
+			add(_pending[i], weights);
+	_pending.clear();
+	if (n > _capacity)
+	{
+		// the copies are laid out for the larger number of nodes
+		const unsigned int capacity = std::max(n, 2 * _capacity);
+		std::vector<T> snapshots(_history * capacity * _dim);
+		for (unsigned int g = 0; g < _history; g++)
+			std::copy(_snapshots.begin() + g * _capacity * _dim, _snapshots.begin() + (g * _capacity + _size) * _dim,
+				  snapshots.begin() + g * capacity * _dim);
+		_snapshots.swap(snapshots);
+		_capacity = capacity;
+	}
+	if (_size < n)
+		_stamps.resize(n);
+	for (; _size < n; _size++)
+		add(_size, weights);
+}
+
+/** \brief copies the weight vector of an added node into all copies
+*
+* \param index of the node
+* \param weights weight matrix of the graph
+*/
+template<typename T> void WinnerCache<T>::add(const unsigned int& index, const WeightMatrix<T>& weights)
+{
+	_version++;
+	_stamps[index] = _version;
+	_added.push_back(Added(index, _version, _generation));
+	for (unsigned int g = 0; g < _history; g++)
+		std::copy(weights.row(index), weights.row(index) + _dim, snapshot(g, index));
+}
+
+/** \brief starts a new generation
+*
+* The weights are copied and the largest displacements of the nodes between the copies
+* of the former generations and the new copy are computed. The nodes added before the
+* oldest generation are forgotten.
+*/
+template<typename T> void WinnerCache<T>::nextGeneration(const WeightMatrix<T>& weights)
+{
+	_generation++;
+	_searches = 0;
+	_radius[_generation % _history] = 0;
+	for (unsigned int i = 0; i < _size; i++)
+		std::copy(weights.row(i), weights.row(i) + _dim, snapshot(_generation, i));
+	unsigned int oldest = _first;
+	if (_generation >= oldest + _history)
+		oldest = _generation + 1 - _history;
+	for (unsigned int g = oldest; g < _generation; g++)
+	{
+		double offset = 0;
+		for (unsigned int i = 0; i < _size; i++)
+		{
+			const T* a = snapshot(g, i);
+			const T* b = snapshot(_generation, i);
+			double displacement = 0;
+			for (unsigned int k = 0; k < _dim; k++)
+			{
+				const double value = double(a[k]) - double(b[k]);
+				displacement += value * value;
+			}
+			offset = std::max(offset, displacement);
+		}
+		_offset[g % _history] = sqrt(offset);
+	}
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < _added.size(); i++)
+		if (_added[i].generation >= oldest)
+			_added[kept++] = _added[i];
+	_added.resize(kept, _added.empty() ? Added(0, 0, 0) : _added[0]);
+}
+
+/** \brief returns the euclidean distance of the item to a node as computed by nearestTwo
+*/
+template<typename T> inline T WinnerCache<T>::distance(const T* x, const unsigned int& index, const WeightMatrix<T>& weights) const
+{
+	T squared;
+	squaredDistances<T> (x, weights, index, 1, &squared);
+	return T(sqrt(squared));
+}
+
+/** \brief scans all nodes like nearestTwo and writes the entry of the item
+*
+* Besides the winners the three smallest squared distances are kept: the smallest of them
+* except the first winner bounds the distances to all other nodes, the smallest except both
+* winners the distances to all nodes that might replace the second winner.
+*/
+template<typename T> T WinnerCache<T>::scan(unsigned int& first_winner, unsigned int& second_winner, const T* x, Entry& entry, const WeightMatrix<T>& weights)
+{
+	// rows per call of the kernel, the squared distances stay in the L1 cache
+	enum { block = 64 };
+	T squared[block];
+	T best_distance = std::numeric_limits<T>::max();
+	T best_squared  = std::numeric_limits<T>::max();
+	T smallest[3]   = {std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max()};
+	unsigned int nodes[3] = {0, 0, 0};
+	const unsigned int rows = weights.rows();
+
+	first_winner  = 1;
+	second_winner = 0;
+	for (unsigned int begin = 0; begin < rows; begin += block)
+	{
+		const unsigned int count = (rows - begin < block) ? rows - begin : (unsigned int) block;
+		squaredDistances<T> (x, weights, begin, count, squared);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (squared[i] < best_squared)
+			{
+				// different squares may have the same root
+				const T distance = T(sqrt(squared[i]));
+				if (distance < best_distance)
+				{
+					second_winner = first_winner;
+					first_winner  = begin + i;
+					best_distance = distance;
+					best_squared  = squared[i];
+				}
+			}
+			if (squared[i] < smallest[2])
+			{
+				unsigned int k = 2;
+				for (; k > 0 && squared[i] < smallest[k - 1]; k--)
+				{
+					smallest[k] = smallest[k - 1];
+					nodes[k]    = nodes[k - 1];
+				}
+				smallest[k] = squared[i];
+				nodes[k]    = begin + i;
+			}
+		}
+	}
+
+	entry.first   = first_winner;
+	entry.second  = second_winner;
+	entry.others  = -1;
+	entry.before  = -1;
+	for (unsigned int k = 0; k < 3 && k < rows; k++)
+	{
+		if (nodes[k] == first_winner)
+			continue;
+		if (entry.others < 0)
+			entry.others = sqrt(double(smallest[k]));
+		if (nodes[k] != second_winner && entry.before < 0)
+			entry.before = sqrt(double(smallest[k]));
+	}
+	entry.version    = _version;
+	entry.generation = _generation;
+	return best_distance;
+}
+
+} // namespace neuralgas
+
+#endif
@@ -124,6 +124,12 @@ void EBGNGAlgorithm<T,S>::setRefVectors(const unsigned int& num_of_ref_vec)
 	_graphptr           = new GNGGraph<T,S>(this->getDimension());
 	this->graphptr      = _graphptr;
 	this->_graphModulptr = _graphptr;
+	_graphptr->setWinnerIndex(this->_winnerIndexKind);
+	_graphptr->setTopologicalSearch(this->_topologicalSearch);
+	_graphptr->setPrefilter(this->_prefilter);
+	_graphptr->setTriangleBounds(this->_triangleBounds);
+	_graphptr->setWinnerCache(this->_winnerCache);
+	this->updatePartialDistance();
 	// sets the min value for the init of the context vector
 	_graphptr->setLowLimits(this->minValues());
 	// sets the max value for the init of the context vector
@@ -146,7 +152,8 @@ void EBGNGAlgorithm<T,S>::setRefVectors(const unsigned int& num_of_ref_vec)
 template<typename T,typename S> void EBGNGAlgorithm<T,S>::updateNeighbor(const unsigned int& item_index,const unsigned int& node_index)
 {
  //(*_graphptr)[node_index].weight  += this->params[5] * ( (*this)[time]-(*_graphptr)[node_index].weight);
- (*_graphptr)[node_index].weight  += rate * ( (*this)[item_index]-(*_graphptr)[node_index].weight);
+ (*_graphptr)[node_index].weight.moveToward((*this)[item_index], rate);
+ _graphptr->weightChanged(node_index);
 
 }
 
@@ -161,7 +168,8 @@ template<typename T,typename S> void EBGNGAlgorithm<T,S>::updateNeighbor(const u
 */
 template<typename T,typename S> void EBGNGAlgorithm<T,S>::updateWinner(const unsigned int& item_index,const unsigned int& winner)
 {
- (*_graphptr)[winner].weight  += this->params[4] * ( (*this)[item_index]-(*_graphptr)[winner].weight);
+ (*_graphptr)[winner].weight.moveToward((*this)[item_index], this->params[4]);
+ _graphptr->weightChanged(winner);
 }
 
 
@@ -157,6 +157,12 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::setRefVectors(const unsi
   _graphptr           = new GNGGraph<T,S>(this->getDimension());
   this->graphptr      = _graphptr;
   this->_graphModulptr = _graphptr;
+  _graphptr->setWinnerIndex(this->_winnerIndexKind);
+  _graphptr->setTopologicalSearch(this->_topologicalSearch);
+  _graphptr->setPrefilter(this->_prefilter);
+  _graphptr->setTriangleBounds(this->_triangleBounds);
+  _graphptr->setWinnerCache(this->_winnerCache);
+  this->updatePartialDistance();
   // sets the min values for the init of the context vector
   _graphptr->setLowLimits(this->minValues());
   // sets the max values for the init of the context vector
@@ -185,7 +191,8 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::setMinGlobalError (T val
 */
 template<typename T,typename S> void GNGAlgorithm<T,S>::updateNeighbor(const unsigned int& item,const unsigned int& node_index)
 {
- (*_graphptr)[node_index].weight  += this->params[5] * ( (*this)[item]-(*_graphptr)[node_index].weight);
+ (*_graphptr)[node_index].weight.moveToward((*this)[item], this->params[5]);
+ _graphptr->weightChanged(node_index);
 }
 
 /** \brief defines the update rule for the winner
@@ -199,7 +206,8 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::updateNeighbor(const uns
 */
 template<typename T,typename S> void GNGAlgorithm<T,S>::updateWinner(const unsigned int& item,const unsigned int& winner)
 {
- (*_graphptr)[winner].weight  += this->params[4] * ( (*this)[item]-(*_graphptr)[winner].weight);
+ (*_graphptr)[winner].weight.moveToward((*this)[item], this->params[4]);
+ _graphptr->weightChanged(winner);
 }
 
 
@@ -265,13 +273,7 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::run()
  */
 template<typename T,typename S> T GNGAlgorithm<T,S>::getGlobalError ()
 {
-  T global_error = this->_zero;
-  for(unsigned int i = 0; i < _graphptr->size(); i++)
-  {
-    global_error += _graphptr->getError(i);
-  }
-  return global_error;
-
+  return _graphptr->getGlobalError();
 }
 
 /** \brief a learning cycle for instance t
@@ -298,7 +300,7 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::learning_loop ( unsigned
     this->params[j] =((*this)._funcArray[j])(t);
   }
     
-  _graphptr->getWinner(first_winner,second_winner,(*this)[t]);
+  _graphptr->getWinner(first_winner,second_winner,(*this)[t],t);
 
   T distance = pow(_graphptr->getDistance((*this)[t],first_winner),2);
 
@@ -339,17 +341,7 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::learning_loop ( unsigned
     
   if( 0<int(this->params[6]) && (t % (unsigned int)(this->params[6])== 0) && _graphptr->size() < this->params[7])
   {
-    T max_error                   = this->_zero;
-    int max_error_index           = 0;
- 
-    for (unsigned int i=0; i < _graphptr->size(); i++)
-    {
-      if (_graphptr->getError(i) > max_error )
-      {
-        max_error               = _graphptr->getError(i);
-        max_error_index         = i;
-      }
-    }
+    int max_error_index           = _graphptr->maxErrorNode();
        
     std::vector<unsigned int> neighbors   = _graphptr->getNeighbors(max_error_index);
     T max_error_n                = this->_zero;
@@ -379,10 +371,7 @@ template<typename T,typename S> void GNGAlgorithm<T,S>::learning_loop ( unsigned
     _graphptr->setError(gsize,_graphptr->getError(max_error_index));
   }
 
-  for(unsigned int i = 0; i < _graphptr->size(); i++)
-  {
-    _graphptr->setError(i, this->params[1] * _graphptr->getError(i));
-  }
+  _graphptr->decayErrors(this->params[1]);
 
 }  
 
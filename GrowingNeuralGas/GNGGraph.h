@@ -30,7 +30,10 @@
 #define GNGGRAPH_H
 
 #include <iostream>
+#include <cmath>
+#include <limits>
 #include "GNGModulGraph.h"
+#include <Graphs/IndexedMaxHeap.h>
 
 namespace neuralgas {
 
@@ -45,6 +48,8 @@ namespace neuralgas {
  *   for manipulating the value. 
  *   Furthermore it has a context vector as suggested in the above paper to reflect
  *   the history and the time series evolution of the node.
+ *   The error is stored in the undecayed units of the GNGGraph, i.e. it has to be
+ *   multiplied by the error scale of the graph, use the functions of the graph instead.
  *   \param counter the belief in the node
  *   \param vector reflecting the time series evolution
  *
@@ -72,24 +77,57 @@ template<typename T,typename S> struct GNGNode : Base_Node<T,S>
  * The same holds for the edges, where the edge has to be derived from the timed edge TEdge
  * in the TGraph class.
  *
+ * The errors of all nodes are decayed at every learning step. Instead of visiting all
+ * nodes the decay is applied lazily: the nodes store their error divided by _errorScale
+ * and decayErrors only multiplies _errorScale by the factor. When _errorScale becomes
+ * too small the scale is folded into the stored errors (renormalization).
+ * The sum of the stored errors is kept up to date such that getGlobalError is O(1).
+ * The nodes whose error has been set are kept in a max-heap by their stored error,
+ * which has the same order as the error, such that maxErrorNode is O(1).
+ *
+ * \param _errorScale factor by which the stored errors have to be multiplied
+ * \param _errorSum sum of the stored errors of all nodes, see Accumulator
+ * \param _errorHeap indices of the nodes ordered by their stored error
  */
 template<typename T,typename S> class GNGGraph : public GNGModulGraph<T,S>
 {
 public:
-	//cto creating a graph with the same dimension for node and edge weight vectors
-	GNGGraph(const unsigned int& dim) :  Base_Graph<T,S>(dim),UGraph<T,S>(dim),TGraph<T,S>(dim),GNGModulGraph<T,S>(dim){}
+	//cto creating a graph with the given dimension for node weight vectors, the edges only carry their age
+	GNGGraph(const unsigned int& dim) :  Base_Graph<T,S>(dim,0),UGraph<T,S>(dim),TGraph<T,S>(dim),GNGModulGraph<T,S>(dim),_errorScale(1),_errorSum(0){}
 	//cto creating a graph with the different dimension for node and edge weight vectors
-	GNGGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge),UGraph<T,S>(dimNode,dimEdge),TGraph<T,S>(dimNode,dimEdge){}
+	GNGGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge),UGraph<T,S>(dimNode,dimEdge),TGraph<T,S>(dimNode,dimEdge),_errorScale(1),_errorSum(0){}
 	// std dto
 	~GNGGraph(){}
 	// sets a new counter value for the given node
 	void inline setError(const unsigned int&, const T&);
 	// gets the counter value for the given node
 	T inline getError(const unsigned int&) const;
+	// multiplies the errors of all nodes by the given factor
+	void inline decayErrors(const T&);
+	// returns the sum of the errors of all nodes
+	T inline getGlobalError() const;
+	// returns the errors of all nodes ordered by their index
+	std::vector<T> getErrors() const;
+	// returns the index of the node with the maximal error
+	unsigned int inline maxErrorNode() const;
+	
+protected:
+	// removes the node from the error sum and the error heap and deletes it
+	virtual void                      deleteNode(const unsigned int&);
+	// changes the index of a moved node in the error heap
+	virtual void                      moveNode(const unsigned int&, const unsigned int&);
 	
 private:
 	// returns a pointer to a node of a type that is currently used by the graph
 	virtual GNGNode<T,S>*             newNode(void);
+	// folds the given factor and the error scale into the stored errors
+	void                              renormalizeErrors(const T&);
+	// factor by which the stored errors have to be multiplied
+	T                                 _errorScale;
+	// sum of the stored errors of all nodes, kept in double for float errors
+	typename Accumulator<T>::type     _errorSum;
+	// indices of the nodes ordered by their stored error
+	IndexedMaxHeap<T>                 _errorHeap;
 };
 
 
@@ -119,7 +157,11 @@ template<typename T,typename S> GNGNode<T,S>* GNGGraph<T,S>::newNode(void)
 */
 template<typename T,typename S> void inline GNGGraph<T,S>::setError(const unsigned int& index, const T& newError)
 {
- (static_cast< GNGNode<T,S>* > (this->_nodes[index]))->setError(newError);
+ GNGNode<T,S>* node = static_cast< GNGNode<T,S>* > (this->_nodes[index]);
+ T stored  = newError / _errorScale;
+ _errorSum += stored - node->getError();
+ node->setError(stored);
+ _errorHeap.set(index, stored);
 }
 /** \brief gets the error value for the given node
 *
@@ -128,7 +170,103 @@ template<typename T,typename S> void inline GNGGraph<T,S>::setError(const unsign
  
 template<typename T,typename S> T inline GNGGraph<T,S>::getError(const unsigned int& index) const
 { 
-  return (static_cast< GNGNode<T,S>* > (this->_nodes[index]))->getError();
+  return (static_cast< GNGNode<T,S>* > (this->_nodes[index]))->getError() * _errorScale;
+}
+
+/** \brief multiplies the errors of all nodes by the given factor
+*
+* Only the error scale is changed, the nodes are visited when the scale drops below
+* a threshold or the factor is not positive. Any factor is allowed, see renormalizeErrors.
+* \param factor by which the errors are multiplied
+*/
+template<typename T,typename S> void inline GNGGraph<T,S>::decayErrors(const T& factor)
+{
+  // below this scale the stored errors would lose their range
+  const T min_scale = std::sqrt( std::numeric_limits<T>::epsilon() );
+  if (factor > 0 && _errorScale * factor >= min_scale)
+    _errorScale *= factor;
+  else
+    renormalizeErrors(factor);
+}
+
+/** \brief returns the sum of the errors of all nodes
+*/
+template<typename T,typename S> T inline GNGGraph<T,S>::getGlobalError() const
+{
+  return T(_errorSum * _errorScale);
+}
+
+/** \brief returns the errors of all nodes ordered by their index
+*
+* The errors are returned in their decayed value, e.g. for a FrozenGraph.
+*/
+template<typename T,typename S> std::vector<T> GNGGraph<T,S>::getErrors() const
+{
+  std::vector<T> errors(this->size());
+  for (unsigned int i = 0; i < this->size(); i++)
+    errors[i] = getError(i);
+  return errors;
+}
+
+/** \brief returns the index of the node with the maximal error
+*
+* Among nodes with equal errors the one with the smaller index is returned. If no
+* node has a positive error the first node is returned.
+*/
+template<typename T,typename S> unsigned int inline GNGGraph<T,S>::maxErrorNode() const
+{
+  assert (this->size() > 0);
+  if (_errorHeap.empty() || !(_errorHeap.topKey() > 0))
+    return 0;
+  return _errorHeap.top();
+}
+
+/** \brief folds the given factor and the error scale into the stored errors
+*
+* The error sum is recomputed, which also discards the rounding errors accumulated
+* by the incremental updates. A negative factor reverses the order of the errors,
+* in that case the error heap is rebuilt from the nodes instead of being scaled.
+* \param factor by which the errors are multiplied
+*/
+template<typename T,typename S> void GNGGraph<T,S>::renormalizeErrors(const T& factor)
+{
+  T scale   = _errorScale * factor;
+  _errorSum = 0;
+  if (scale < 0)
+    _errorHeap.clear();
+  for (unsigned int i = 0; i < this->size(); i++)
+  {
+    GNGNode<T,S>* node = static_cast< GNGNode<T,S>* > (this->_nodes[i]);
+    node->setError(node->getError() * scale);
+    _errorSum += node->getError();
+    if (scale < 0)
+      _errorHeap.set(i, node->getError());
+  }
+  if (!(scale < 0))
+    _errorHeap.scale(scale);
+  _errorScale = 1;
+}
+
+/** \brief removes the node from the error sum and the error heap and deletes it
+*
+* \param index of the node that is removed from the graph
+*/
+template<typename T,typename S> void GNGGraph<T,S>::deleteNode(const unsigned int& index)
+{
+  _errorSum -= static_cast< GNGNode<T,S>* > (this->_nodes[index])->getError();
+  _errorHeap.erase(index);
+  GNGModulGraph<T,S>::deleteNode(index);
+}
+
+/** \brief changes the index of a moved node in the error heap
+*
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T,typename S> void GNGGraph<T,S>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+  _errorHeap.move(from, to);
+  GNGModulGraph<T,S>::moveNode(from, to);
 }
 
 } // namespace neuralgas
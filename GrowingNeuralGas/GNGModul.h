@@ -36,7 +36,7 @@
 
 namespace neuralgas {
 
-template<typename T,typename S> class ErrorTesting;
+template<typename T,typename S,typename M> class ErrorTesting;
 
 /** \class GNGModul
  *  \brief This class is a modul offering common functions that are used within nearly
@@ -48,6 +48,13 @@ template<typename T,typename S> class ErrorTesting;
  *   It is intended to expand this class whenever components are found to be extractable.
  *
  *   \param _graphModulptr ptr to the GNGModulGraph
+ *   \param _winnerIndexKind kind of spatial index the graph uses for the winner search
+ *   \param _topologicalSearch settings of the topological winner search of the graph
+ *   \param _prefilter settings of the quantized prefilter of the graph
+ *   \param _triangleBounds settings of the triangle inequality bounds of the graph
+ *   \param _partialDistance settings of the partial distance winner search of the graph
+ *   \param _winnerCache settings of the winner cache of the graph
+ *   \param _orderByVariance whether the partial distance search orders the dimensions by the variance of the data
  */
 template<typename T,typename S> class GNGModul : public NeuralGas<T,S>
 {
@@ -62,6 +69,28 @@ public:
         virtual void    showGraph()=0;
         //set stopping value (maximal number of epochs)
         void setMaxEpochs (unsigned int);
+        //sets the kind of spatial index used for the winner search
+        void setWinnerIndex (const typename SpatialIndex<T>::Kind&);
+        //sets the topological winner search walking along the edges, a beam width of 0 disables it
+        void setTopologicalSearch (const unsigned int&, const T& budget = 0.25, const unsigned int& verification = 0);
+        //returns the counters of the topological winner search of the current graph
+        const typename TopologicalSearch<T>::Stats& getTopologicalSearchStats () const;
+        //sets the quantized prefilter of the winner search, 0 candidates disable it
+        void setPrefilter (const unsigned int&, const unsigned int& verification = 0);
+        //returns the counters of the quantized prefilter of the current graph
+        const typename QuantizedPrefilter<T>::Stats& getPrefilterStats () const;
+        //enables the winner search skipping nodes by the triangle inequality
+        void setTriangleBounds (const bool&);
+        //returns the counters of the triangle inequality bounds of the current graph
+        const typename TriangleBounds<T>::Stats& getTriangleBoundsStats () const;
+        //sets the partial distance winner search, a block size of 0 disables it
+        void setPartialDistance (const unsigned int&, const bool& order_by_variance = false);
+        //returns the counters of the partial distance winner search of the current graph
+        const typename PartialDistanceSearch<T>::Stats& getPartialDistanceStats () const;
+        //enables the cache of the winners of the data items between the epochs
+        void setWinnerCache (const bool&);
+        //returns the counters of the winner cache of the current graph
+        const typename WinnerCache<T>::Stats& getWinnerCacheStats () const;
 protected:
         // removes all edges that have an age greater than the given value
         virtual           void   rmOldEdges(const unsigned int&);
@@ -69,10 +98,26 @@ protected:
         virtual           bool   rmNotConnectedNodes();
         // ptr to the underlying graph structure
         GNGModulGraph<T,S>*      _graphModulptr;
+        // kind of spatial index used for the winner search
+        typename SpatialIndex<T>::Kind _winnerIndexKind;
+        // settings of the topological winner search
+        TopologicalSearch<T>     _topologicalSearch;
+        // settings of the quantized prefilter
+        QuantizedPrefilter<T>    _prefilter;
+        // settings of the triangle inequality bounds
+        TriangleBounds<T>        _triangleBounds;
+        // hands the partial distance search over to the current graph
+        void                     updatePartialDistance ();
+        // settings of the partial distance winner search
+        PartialDistanceSearch<T> _partialDistance;
+        // whether the partial distance search orders the dimensions by variance
+        bool                     _orderByVariance;
+        // settings of the winner cache
+        WinnerCache<T>           _winnerCache;
  
 private:         
         // ErrorTesting is defined as friend in order to not having duplicate anything
-        friend class ErrorTesting<T,S>;
+        template<typename,typename,typename> friend class ErrorTesting;
 protected:
         //maximal number of epochs (used as stopping criterion)
         unsigned int max_epochs;
@@ -82,7 +127,16 @@ protected:
 /** \brief cto with size of dimension as input 
 */
 
-template<typename T,typename S> GNGModul<T,S>::GNGModul(const unsigned int& dim) : NeuralGas<T,S>(dim)
+template<typename T,typename S> GNGModul<T,S>::GNGModul(const unsigned int& dim) :
+	NeuralGas<T,S>(dim),
+	_graphModulptr (NULL),
+	_winnerIndexKind (SpatialIndex<T>::NONE),
+	_topologicalSearch (),
+	_prefilter (),
+	_triangleBounds (),
+	_partialDistance (),
+	_orderByVariance (false),
+	_winnerCache ()
 {
   max_epochs = 1;
 }
@@ -91,6 +145,14 @@ template<typename T,typename S> GNGModul<T,S>::GNGModul(const unsigned int& dim)
  */
 template<typename T,typename S> GNGModul<T,S>::GNGModul(const GNGModul& g) :
 	NeuralGas<T,S>(g),
+	_graphModulptr (NULL),
+	_winnerIndexKind (g._winnerIndexKind),
+	_topologicalSearch (g._topologicalSearch),
+	_prefilter (g._prefilter),
+	_triangleBounds (g._triangleBounds),
+	_partialDistance (g._partialDistance),
+	_orderByVariance (g._orderByVariance),
+	_winnerCache (g._winnerCache),
 	max_epochs (g.max_epochs)
 {
 }
@@ -107,33 +169,173 @@ template<typename T,typename S> void GNGModul<T,S>::setMaxEpochs (unsigned int v
   max_epochs = value;
 }
 
+/** \brief sets the kind of spatial index used for the winner search
+ *
+ *  The kind is handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setWinnerIndex. The winners do not depend on the kind.
+ *  \param kind KDTREE, BALLTREE, AUTO or NONE for scanning all nodes
+ */
+template<typename T,typename S> void GNGModul<T,S>::setWinnerIndex (const typename SpatialIndex<T>::Kind& kind)
+{
+  _winnerIndexKind = kind;
+  if (_graphModulptr != NULL)
+    _graphModulptr->setWinnerIndex(kind);
+}
+
+/** \brief sets the topological winner search walking along the edges from the previous winners
+ *
+ *  The settings are handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setTopologicalSearch. The search is approximate, its counters
+ *  tell how often it agrees with the exact search.
+ *  \param beam_width number of closest nodes expanded by the walk, 0 disables the search
+ *  \param budget maximal fraction of the nodes visited by a walk before the exact search is used
+ *  \param verification every verification-th walk is checked by the exact search, 0 for none
+ */
+template<typename T,typename S> void GNGModul<T,S>::setTopologicalSearch (const unsigned int& beam_width, const T& budget, const unsigned int& verification)
+{
+  _topologicalSearch.setBeamWidth(beam_width);
+  _topologicalSearch.setBudget(budget);
+  _topologicalSearch.setVerification(verification);
+  if (_graphModulptr != NULL)
+    _graphModulptr->setTopologicalSearch(beam_width, budget, verification);
+}
+
+/** \brief returns the counters of the topological winner search of the current graph
+ */
+template<typename T,typename S> const typename TopologicalSearch<T>::Stats& GNGModul<T,S>::getTopologicalSearchStats () const
+{
+  assert (_graphModulptr != NULL);
+  return _graphModulptr->topologicalSearch().stats();
+}
+
+/** \brief sets the quantized prefilter comparing an 8 bit copy of the weights first
+ *
+ *  The settings are handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setPrefilter. The search is approximate, its counters tell how
+ *  often the exact first winner was not among the candidates. It is faster than the
+ *  exact scan from 64 dimensions on, for less dimensions the scan is used instead.
+ *  \param candidates number of nodes compared on the weights, 0 disables the prefilter
+ *  \param verification every verification-th search is checked by the exact search, 0 for none
+ */
+template<typename T,typename S> void GNGModul<T,S>::setPrefilter (const unsigned int& candidates, const unsigned int& verification)
+{
+  _prefilter.setCandidates(candidates);
+  _prefilter.setVerification(verification);
+  if (_graphModulptr != NULL)
+    _graphModulptr->setPrefilter(candidates, verification);
+}
+
+/** \brief returns the counters of the quantized prefilter of the current graph
+ */
+template<typename T,typename S> const typename QuantizedPrefilter<T>::Stats& GNGModul<T,S>::getPrefilterStats () const
+{
+  assert (_graphModulptr != NULL);
+  return _graphModulptr->prefilter().stats();
+}
+
+/** \brief enables the winner search skipping nodes by the triangle inequality
+ *
+ *  The setting is handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setTriangleBounds. The winners do not depend on the setting.
+ *  The bounds are disabled by default, they pay off for searches on a graph whose nodes
+ *  do not move, e.g. the evaluation of a trained graph with 16 and more dimensions, but
+ *  slow the training down, see TriangleBounds.
+ *  \param enabled whether the bounds are used
+ */
+template<typename T,typename S> void GNGModul<T,S>::setTriangleBounds (const bool& enabled)
+{
+  _triangleBounds.setEnabled(enabled);
+  if (_graphModulptr != NULL)
+    _graphModulptr->setTriangleBounds(enabled);
+}
+
+/** \brief returns the counters of the triangle inequality bounds of the current graph
+ */
+template<typename T,typename S> const typename TriangleBounds<T>::Stats& GNGModul<T,S>::getTriangleBoundsStats () const
+{
+  assert (_graphModulptr != NULL);
+  return _graphModulptr->triangleBounds().stats();
+}
+
+/** \brief sets the partial distance winner search abandoning the distances of the nodes early
+ *
+ *  The settings are handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setPartialDistance. The winners do not depend on the settings.
+ *  The search pays off for clustered data of 32 and more dimensions, see PartialDistanceSearch.
+ *  The order of the dimensions is taken from the data given so far and again whenever
+ *  the reference vectors are set.
+ *  \param block_size number of dimensions accumulated between two checks, 0 disables the search
+ *  \param order_by_variance whether the dimensions with the largest variance are accumulated first
+ */
+template<typename T,typename S> void GNGModul<T,S>::setPartialDistance (const unsigned int& block_size, const bool& order_by_variance)
+{
+  _partialDistance.setBlockSize(block_size);
+  _orderByVariance = order_by_variance;
+  if (!order_by_variance)
+    _partialDistance.setOrder(Vector<T>(0));
+  updatePartialDistance();
+}
+
+/** \brief returns the counters of the partial distance winner search of the current graph
+ */
+template<typename T,typename S> const typename PartialDistanceSearch<T>::Stats& GNGModul<T,S>::getPartialDistanceStats () const
+{
+  assert (_graphModulptr != NULL);
+  return _graphModulptr->partialDistance().stats();
+}
+
+/** \brief enables the cache of the winners of the data items between the epochs
+ *
+ *  The setting is handed over to the current graph and to the graphs created later on,
+ *  see GNGModulGraph::setWinnerCache. The winners do not depend on the setting, the
+ *  cache pays off when the items are presented again and again to a nearly converged graph.
+ *  \param enabled whether the cache is used
+ */
+template<typename T,typename S> void GNGModul<T,S>::setWinnerCache (const bool& enabled)
+{
+  _winnerCache.setEnabled(enabled);
+  if (_graphModulptr != NULL)
+    _graphModulptr->setWinnerCache(enabled);
+}
+
+/** \brief returns the counters of the winner cache of the current graph
+ */
+template<typename T,typename S> const typename WinnerCache<T>::Stats& GNGModul<T,S>::getWinnerCacheStats () const
+{
+  assert (_graphModulptr != NULL);
+  return _graphModulptr->winnerCache().stats();
+}
+
+/** \brief hands the partial distance search over to the current graph
+ *
+ *  If requested the dimensions are ordered by the variances of the current data.
+ */
+template<typename T,typename S> void GNGModul<T,S>::updatePartialDistance ()
+{
+  if (_orderByVariance && this->size())
+    _partialDistance.setOrder(this->variances());
+  if (_graphModulptr != NULL)
+    _graphModulptr->setPartialDistance(_partialDistance);
+}
+
 /** \brief Removes all edges that have an age greater than the value given by max_age
 * 
+* The graph keeps its edges indexed by age, thus only the expired edges are visited.
 * \param max_age is the maximal age that is permitted for an edge to have
 */
 
 template<typename T,typename S> void GNGModul<T,S>::rmOldEdges(const unsigned int& max_age)
 {
-  for (unsigned int j = 0; j < _graphModulptr->size(); j++)
-  {
-    for (unsigned int k = 0; k < j; k++)
-      if ( _graphModulptr->getAge(k,j) > max_age ) // age is greater than max_age
-	_graphModulptr->rmEdge(k,j);              // and has to be removedd
-  }
+  _graphModulptr->rmOldEdges(max_age);
 }
 /** \brief Removes all nodes from the graph that are not connected
 *
+* At least two nodes are kept. The graph keeps track of its isolated nodes,
+* thus only those are visited.
 */
 template<typename T,typename S> bool GNGModul<T,S>::rmNotConnectedNodes()
 {
-  unsigned int original_graph_size = _graphModulptr->size();
-  for (unsigned int j = 0; j < _graphModulptr->size(); j++)
-    if (!(_graphModulptr->isConnected(j)) && _graphModulptr->size() > 2 )
-    {
-      _graphModulptr->rmNode(j);
-      j--;
-    }
-  return original_graph_size > _graphModulptr->size();
+  return _graphModulptr->rmIsolatedNodes(2) > 0;
 }
 
 } // namespace neuralgas
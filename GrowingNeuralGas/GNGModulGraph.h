@@ -31,11 +31,19 @@
 
 #include <Graphs/UGraph.h>
 #include <Graphs/TGraph.h>
+#include <Graphs/SpatialIndex.h>
+#include <Graphs/PartialDistanceSearch.h>
+#include <Graphs/TriangleBounds.h>
+#include <Graphs/QuantizedPrefilter.h>
+#include <Graphs/WinnerCache.h>
+#include <tools/distanceKernels.h>
+#include <tools/batchAssignment.h>
+#include "TopologicalSearch.h"
 #include <limits>
 
 namespace neuralgas {
 
-template<typename T,typename S> class ErrorTesting;
+template<typename T,typename S,typename M> class ErrorTesting;
 
 /** \class GNGModulGraph
  *  \brief provides the basic graph structure for MergeGrowingNeuralGas
@@ -49,36 +57,131 @@ template<typename T,typename S> class ErrorTesting;
  * it returns a pointer to that newly defined but derived node data type. 
  * The same holds for the edges, but in the edge has to be derived from the struct TEdge<S,T>
  * contained in the class TGraph.
+ * The third template parameter selects the adjacency backend of Base_Graph, the fourth
+ * the metric policy used as distance unless a user defined metric is set by setMetric,
+ * see L2Metric. The winner search calls the policy directly on the rows of the weight
+ * matrix, the accelerated searches below need the euclidean policy.
+ * The winner search can be done by an exact spatial index instead of scanning all nodes,
+ * see setWinnerIndex. With the index every change of a weight vector of an existing node
+ * has to be announced by weightChanged. Alternatively the winners can be searched
+ * approximately by walking along the edges from the previous winners, see
+ * setTopologicalSearch, or by comparing an 8 bit copy of the weights first, see setPrefilter.
+ * Without an index nodes can be skipped by the triangle inequality
+ * on the distances between the nodes, see setTriangleBounds, which also needs the changes
+ * of the weights announced, or the distances of the nodes can be abandoned as soon as
+ * they exceed the current winner, see setPartialDistance. Passes over many items at once
+ * like the evaluation of a whole data set determine the winners by assignBatch. Repeated
+ * searches for the items of a data set can reuse the winners of the previous search of
+ * an item while the nodes provably moved too little to change them, see setWinnerCache.
  *
  * \param low_limit min value for the random initializiation of the context vector 
  * \param high_limit max value for the random initializiation of the context vector 
+ * \param _winnerIndex spatial index over the weight vectors used by getWinner if enabled
+ * \param _topologicalSearch walk along the edges used by getWinner if enabled
+ * \param _prefilter quantized copy of the weights used by getWinner if enabled and no walk is set
+ * \param _triangleBounds bounds on the distances between the nodes, used by getWinner if enabled and no index is set
+ * \param _partialDistance search abandoning distances early, used by getWinner if enabled and no other search is set
+ * \param _winnerCache winners of the data items used by getWinner with an item index if enabled and no approximate search is set
+ * \param _metricPolicy metric policy used as distance if no user defined metric is set
  */
-template<typename T,typename S> class GNGModulGraph : public virtual UGraph<T,S>, public virtual TGraph<T,S>
+template<typename T,typename S,typename A = SparseAdjacency< Base_Edge<S,T> >,typename M = L2Metric<T> > class GNGModulGraph : public virtual UGraph<T,S,A>, public virtual TGraph<T,S,A>
 {
 
 public:
-	//cto creating a graph with the same dimension for node and edge weight vectors
-	GNGModulGraph(const unsigned int& dim) : Base_Graph<T,S>(dim),UGraph<T,S>(dim),TGraph<T,S>(dim){}
+	//cto creating a graph with the given dimension for node weight vectors, the edges only carry their age
+	GNGModulGraph(const unsigned int& dim) : Base_Graph<T,S,A>(dim,0),UGraph<T,S,A>(dim),TGraph<T,S,A>(dim){}
 	//cto creating a graph with the different dimension for node and edge weight vectors
-	GNGModulGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge),UGraph<T,S>(dimNode,dimEdge),TGraph<T,S>(dimNode,dimEdge){}
+	GNGModulGraph(const unsigned int& dimNode,const unsigned int& dimEdge) : Base_Graph<T,S,A>(dimNode,dimEdge),UGraph<T,S,A>(dimNode,dimEdge),TGraph<T,S,A>(dimNode,dimEdge){}
 	/// dummy cto
 	GNGModulGraph () {};
 	/// std dto
 	virtual ~GNGModulGraph(){}
 	// adds an edge between the nodes given by their indeces by calling corresponding upper class method of UGraph
-	virtual void inline  addEdge(const unsigned int& x,const unsigned int& y){if (x!=y) UGraph<T,S>::addEdge(x,y); }
+	virtual void inline  addEdge(const unsigned int& x,const unsigned int& y){if (x!=y) UGraph<T,S,A>::addEdge(x,y); }
 	// removes an edge between the nodes given by their indeces if there exists one by calling corresponding upper class method of UGraph    
-	virtual void inline  rmEdge(const unsigned int& x,const unsigned int& y){if (x!=y) UGraph<T,S>::rmEdge(x,y);}
+	virtual void inline  rmEdge(const unsigned int& x,const unsigned int& y){if (x!=y) UGraph<T,S,A>::rmEdge(x,y);}
 
 	// // class dependent distance function that is used within the winner function
 	// //virtual T getDistance(const Vector<T>&,const unsigned int&)=0;
 	virtual T getDistance(const Vector<T>&,const unsigned int&) const;
 	// func determines for the current time step / data item the two most similar nodes
 	virtual T getWinner( unsigned int&, unsigned int&, const Vector<T>&) const;
-   
+	// func determines the two most similar nodes for the data item with the given index, using the winner cache
+	T getWinner( unsigned int&, unsigned int&, const Vector<T>&, const unsigned int&) const;
+	// func determines the two most similar nodes by scanning all nodes or by the spatial index
+	T getExactWinner( unsigned int&, unsigned int&, const Vector<T>&) const;
+	// func determines the two closest nodes of many items at once
+	void assignBatch(const std::vector<const Vector<T>*>&, std::vector< Assignment<T> >&, const unsigned int& threads = 0) const;
+	// sets the topological search used by getWinner, a beam width of 0 disables it
+	void setTopologicalSearch(const unsigned int&, const T& budget = 0.25, const unsigned int& verification = 0);
+	// takes over the settings of the given topological search
+	inline void setTopologicalSearch(const TopologicalSearch<T>& settings) { _topologicalSearch = settings; }
+	// returns the topological search used by getWinner, e.g. for its counters
+	inline const TopologicalSearch<T>& topologicalSearch() const { return _topologicalSearch; }
+	// sets the quantized prefilter used by getWinner, 0 candidates disable it
+	void setPrefilter(const unsigned int&, const unsigned int& verification = 0);
+	// takes over the settings of the given quantized prefilter
+	inline void setPrefilter(const QuantizedPrefilter<T>& settings) { _prefilter = settings; }
+	// returns the quantized prefilter used by getWinner, e.g. for its counters
+	inline const QuantizedPrefilter<T>& prefilter() const { return _prefilter; }
+	// sets the kind of spatial index used by getWinner, NONE scans all nodes
+	void setWinnerIndex(const typename SpatialIndex<T>::Kind&);
+	// takes over the settings of the given spatial index, e.g. its share of evaluated nodes
+	inline void setWinnerIndex(const SpatialIndex<T>& settings) { _winnerIndex = settings; }
+	// returns the spatial index used by getWinner
+	inline const SpatialIndex<T>& winnerIndex() const { return _winnerIndex; }
+	// enables the triangle inequality bounds used by getWinner, they pay off while the nodes do not move
+	inline void setTriangleBounds(const bool& enabled) { _triangleBounds.setEnabled(enabled); }
+	// takes over the settings of the given triangle inequality bounds
+	inline void setTriangleBounds(const TriangleBounds<T>& settings) { _triangleBounds = settings; }
+	// returns the triangle inequality bounds used by getWinner, e.g. for their counters
+	inline const TriangleBounds<T>& triangleBounds() const { return _triangleBounds; }
+	// sets the partial distance search used by getWinner, a block size of 0 disables it
+	inline void setPartialDistance(const unsigned int& block_size) { _partialDistance.setBlockSize(block_size); }
+	// takes over the settings of the given partial distance search, e.g. its order of the dimensions
+	inline void setPartialDistance(const PartialDistanceSearch<T>& settings) { _partialDistance = settings; }
+	// returns the partial distance search used by getWinner, e.g. for its counters
+	inline const PartialDistanceSearch<T>& partialDistance() const { return _partialDistance; }
+	// enables the cache of the winners of the data items used by getWinner with an item index
+	inline void setWinnerCache(const bool& enabled) { _winnerCache.setEnabled(enabled); }
+	// takes over the settings of the given winner cache
+	inline void setWinnerCache(const WinnerCache<T>& settings) { _winnerCache = settings; }
+	// returns the winner cache, e.g. for its counters
+	inline const WinnerCache<T>& winnerCache() const { return _winnerCache; }
+	// announces that the weight vector of the given node has been changed
+	inline void weightChanged(const unsigned int& index);
+	// sets the metric policy, e.g. the variances of DiagonalMahalanobisMetric
+	inline void setMetricPolicy(const M& policy) { _metricPolicy = policy; }
+	// returns the metric policy
+	inline const M& metricPolicy() const { return _metricPolicy; }
+
+protected:
+	// returns whether getDistance is the metric policy on the weights
+	virtual bool policyDistance() const { return this->_metric_to_use == NULL; }
+	// returns whether getDistance is the euclidean distance on the weights, only then the spatial index is used
+	inline bool indexableDistance() const { return M::isEuclidean && policyDistance(); }
+	// removes the node from the spatial index and deletes it
+	virtual void deleteNode(const unsigned int&);
+	// changes the index of a moved node in the spatial index
+	virtual void moveNode(const unsigned int&, const unsigned int&);
+	// spatial index over the weight vectors, it is updated lazily by the const getWinner
+	mutable SpatialIndex<T> _winnerIndex;
+	// walk along the edges, it keeps the previous winners as seeds
+	mutable TopologicalSearch<T> _topologicalSearch;
+	// quantized copy of the weights, it is updated lazily by the const getWinner
+	mutable QuantizedPrefilter<T> _prefilter;
+	// bounds on the distances between the nodes, they are updated lazily by the const getWinner
+	mutable TriangleBounds<T> _triangleBounds;
+	// search abandoning the distances early, it keeps counters
+	mutable PartialDistanceSearch<T> _partialDistance;
+	// winners of the data items with bounds on their distances to the other nodes
+	mutable WinnerCache<T> _winnerCache;
+	// metric policy used as distance if no user defined metric is set
+	M _metricPolicy;
+
 private:
 	/// ErrorTesting is defined as friend in order to not having duplicate anything
-	friend class ErrorTesting<T,S>;
+	template<typename,typename,typename> friend class ErrorTesting;
 
 };
 
@@ -90,13 +193,64 @@ private:
 *  
 *   NOTE: It is intented to "outsource" this function and to let the user define the way
 *         of determining the winner and refer to it via a function ptr.
+*
+*   If the topological search is enabled the winners are searched approximately by walking
+*   along the edges, if the prefilter is enabled they are searched approximately among the
+*   nodes closest to the item on the quantized weights, otherwise they are determined exactly
+*   by getExactWinner.
 *  
 *   \param first_winner before func call an arbitrary value, after func call the closest node
 *   \param second_winner before func call an arbitrary value, after func call the second closest node
 *   \param time is the current time step reflecting the current data to be processed
 */
-template<typename T,typename S>
-T GNGModulGraph<T,S>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item) const
+template<typename T,typename S,typename A,typename M>
+T GNGModulGraph<T,S,A,M>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item) const
+{
+	if (_topologicalSearch.enabled())
+		return _topologicalSearch.getWinner(*this, first_winner, second_winner, item);
+	if (_prefilter.enabled() && indexableDistance())
+		return _prefilter.getWinner(first_winner, second_winner, &item[0], this->_weights);
+	return getExactWinner(first_winner, second_winner, item);
+}
+
+/** \brief func determines the two most similar nodes for the data item with the given index
+*
+*   If the winner cache is enabled the winners of the previous search of the item are
+*   returned as long as the moves of the nodes since then prove them unchanged, otherwise
+*   all nodes are scanned and the cache entry of the item is written. The winners are the
+*   same as the ones of the exact search. Without the cache, with an approximate search or
+*   another distance than the euclidean one the index is ignored.
+*
+*   \param first_winner after func call the closest node
+*   \param second_winner after func call the second closest node
+*   \param item current data item
+*   \param index of the data item in the data set
+*/
+template<typename T,typename S,typename A,typename M>
+T GNGModulGraph<T,S,A,M>::getWinner(unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item, const unsigned int& index) const
+{
+	if (_winnerCache.enabled() && !_topologicalSearch.enabled() && !_prefilter.enabled() && indexableDistance())
+		return _winnerCache.getWinner(first_winner, second_winner, &item[0], index, this->_weights);
+	return getWinner(first_winner, second_winner, item);
+}
+
+/** \brief func determines for the current data item the two most similar nodes exactly
+*
+*   All nodes are scanned, the first winner is the closest node and the second winner
+*   the node that was closest before the first winner was found.
+*   If the distance is the pre-specified metric the weight matrix is scanned by the
+*   vectorized kernel of nearestTwo or, if a spatial index is set, the winners are looked
+*   up in the index, otherwise if the triangle bounds are enabled nodes are skipped by
+*   the triangle inequality, or if the partial distance search is enabled the distances
+*   are abandoned early. All return the same winners as the scan by getDistance.
+*   For other metric policies the policy is scanned along the rows of the weight matrix.
+*
+*   \param first_winner after func call the closest node
+*   \param second_winner after func call the closest node among the nodes with a smaller index than first_winner
+*   \param item data vector
+*/
+template<typename T,typename S,typename A,typename M>
+T GNGModulGraph<T,S,A,M>::getExactWinner(unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item) const
 {
 	T distance;
 	// best_distance set to "infinity"
@@ -104,12 +258,25 @@ T GNGModulGraph<T,S>::getWinner(unsigned int& first_winner, unsigned int& second
 
 	assert (this->size() >= 2);
 
+	if (indexableDistance())
+	{
+		if (_winnerIndex.enabled())
+			return _winnerIndex.getWinner(first_winner, second_winner, &item[0], this->_weights);
+		if (_triangleBounds.enabled())
+			return _triangleBounds.getWinner(first_winner, second_winner, &item[0], this->_weights);
+		if (_partialDistance.enabled())
+			return _partialDistance.getWinner(first_winner, second_winner, &item[0], this->_weights);
+		return nearestTwo<T> (&item[0], this->_weights, first_winner, second_winner);
+	}
+
 	first_winner = 1;
 	second_winner = 0;
  
+	// the metric policy is called directly on the rows instead of the virtual getDistance
+	const bool policy = policyDistance();
 	for (unsigned int j = 0; j < this->size(); j++)
 	{
-		distance = getDistance(item,j);
+		distance = policy ? _metricPolicy(&item[0], this->_weights.row(j), this->_dimNode) : getDistance(item,j);
 		if (distance < best_distance)
 		{
 			second_winner              =       first_winner;
@@ -120,23 +287,172 @@ T GNGModulGraph<T,S>::getWinner(unsigned int& first_winner, unsigned int& second
 	return best_distance;
 }
 
+/** \brief func determines the two closest nodes of many data items at once
+*
+*   If the distance is the euclidean metric policy the items are assigned by BatchAssignment,
+*   which evaluates the distances of blocks of items and nodes like a matrix multiplication
+*   in several threads, otherwise all nodes are scanned by getDistance for every item.
+*   Both give exactly the closest node of getExactWinner as first node, whereas the second
+*   node is the closest of the other nodes. The search settings of getWinner are not used.
+*
+*   \param items data vectors
+*   \param result after func call the assignment of every item
+*   \param threads number of threads, 0 for the number of cores
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::assignBatch(const std::vector<const Vector<T>*>& items, std::vector< Assignment<T> >& result, const unsigned int& threads) const
+{
+	assert (this->size() >= 2);
+
+	result.resize(items.size());
+	if (items.empty())
+		return;
+	if (indexableDistance())
+	{
+		std::vector<const T*> rows (items.size());
+		for (unsigned int i = 0; i < items.size(); i++)
+			rows[i] = &(*items[i])[0];
+		BatchAssignment<T> batch (this->_weights, threads);
+		batch.assign(&rows[0], rows.size(), &result[0]);
+		return;
+	}
+
+	for (unsigned int i = 0; i < items.size(); i++)
+	{
+		Assignment<T>& a = result[i];
+		a.first = a.second = this->size();
+		a.first_distance = a.second_distance = std::numeric_limits<T>::max();
+		for (unsigned int j = 0; j < this->size(); j++)
+		{
+			T distance = getDistance(*items[i],j);
+			if (distance < a.first_distance)
+			{
+				a.second          = a.first;
+				a.second_distance = a.first_distance;
+				a.first           = j;
+				a.first_distance  = distance;
+			}
+			else if (distance < a.second_distance)
+			{
+				a.second          = j;
+				a.second_distance = distance;
+			}
+		}
+	}
+}
+
 /** \brief Algorithmic dependent distance function
 *
 *   This function returns the distance of the given item and the given node. 
 *   The distance is a algorithmic dependent function that is either
 *   just the setted metric or a combination thereof.
 *   Currently dist  = metric(x_t,w_j) where x_t is the data vector and w_j the node vector,
+*   without a user defined metric the metric policy reads w_j directly from the weight
+*   matrix of the graph such that getWinner streams through the rows.
 *
 *   \param item data vector
 *   \param node_index is the node where to the distance shall be determined
 
 */
-template<typename T,typename S>
-inline T GNGModulGraph<T,S>::getDistance(const Vector<T>& item, const unsigned int& node_index) const
+template<typename T,typename S,typename A,typename M>
+inline T GNGModulGraph<T,S,A,M>::getDistance(const Vector<T>& item, const unsigned int& node_index) const
 {
+	if (this->_metric_to_use == NULL)
+		return _metricPolicy(&item[0], this->_weights.row(node_index), this->_dimNode);
 	return this->metric( item, this->_nodes[node_index]->weight);
 }
 
+/** \brief sets the kind of spatial index used by getWinner
+*
+*   The index is built by the next call of getWinner. The scan is used whenever the
+*   distance is not the pre-specified metric on the weights.
+*
+*   \param kind KDTREE for low dimensions, BALLTREE for moderate ones, AUTO for a kd-tree
+*          only where it beats the scan or NONE for scanning all nodes, see SpatialIndex
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::setWinnerIndex(const typename SpatialIndex<T>::Kind& kind)
+{
+	_winnerIndex.setKind(kind);
+}
+
+/** \brief sets the topological search used by getWinner
+*
+*   The walk starts at the winners of the previous call of getWinner, thus it suits
+*   items that are close to their predecessors like time series.
+*
+*   \param beam_width number of closest nodes expanded by the walk, 1 is the greedy walk, 0 disables the search
+*   \param budget maximal fraction of the nodes visited by a walk before the exact search is used
+*   \param verification every verification-th walk is checked by the exact search, 0 for none
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::setTopologicalSearch(const unsigned int& beam_width, const T& budget, const unsigned int& verification)
+{
+	_topologicalSearch.setBeamWidth(beam_width);
+	_topologicalSearch.setBudget(budget);
+	_topologicalSearch.setVerification(verification);
+}
+
+/** \brief sets the quantized prefilter used by getWinner
+*
+*   The candidates are the nodes closest to the item on the 8 bit codes of the weights,
+*   the winners are the closest candidates. Every weight change has to be announced by
+*   weightChanged. The prefilter only pays off from 64 dimensions on, for less dimensions
+*   the winners are determined exactly by the scan, see QuantizedPrefilter::setMinDim.
+*
+*   \param candidates number of nodes compared on the weights, 0 disables the prefilter
+*   \param verification every verification-th search is checked by the exact search, 0 for none
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::setPrefilter(const unsigned int& candidates, const unsigned int& verification)
+{
+	_prefilter.setCandidates(candidates);
+	_prefilter.setVerification(verification);
+}
+
+/** \brief announces that the weight vector of the given node has been changed
+*
+*   The spatial index, the triangle bounds, the prefilter and the winner cache account for the move of the node.
+*
+*   \param index of the node
+*/
+template<typename T,typename S,typename A,typename M>
+inline void GNGModulGraph<T,S,A,M>::weightChanged(const unsigned int& index)
+{
+	_winnerIndex.weightChanged(index, this->_weights);
+	_triangleBounds.weightChanged(index, this->_weights);
+	_prefilter.weightChanged(index, this->_weights);
+	_winnerCache.weightChanged(index, this->_weights);
+}
+
+/** \brief removes the node from the spatial index, the triangle bounds, the prefilter and the winner cache and deletes it
+*
+* \param index of the node that is removed from the graph
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::deleteNode(const unsigned int& index)
+{
+	_winnerIndex.eraseNode(index);
+	_triangleBounds.eraseNode(index);
+	_prefilter.eraseNode(index);
+	_winnerCache.eraseNode(index);
+	Base_Graph<T,S,A>::deleteNode(index);
+}
+
+/** \brief changes the index of a moved node in the spatial index, the triangle bounds, the prefilter and the winner cache
+*
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T,typename S,typename A,typename M>
+void GNGModulGraph<T,S,A,M>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+	_winnerIndex.moveNode(from, to);
+	_triangleBounds.moveNode(from, to);
+	_prefilter.moveNode(from, to);
+	_winnerCache.moveNode(from, to);
+}
+
 } // namespace neuralgas
 
 #endif
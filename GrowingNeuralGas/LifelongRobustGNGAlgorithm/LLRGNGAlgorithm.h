@@ -80,6 +80,23 @@ signals:
 	void updateData (SeqNeurons* neurons);
 	void initializeData (SeqData* data, SeqNeurons* neurons, unsigned int sidesize = 1000);
 protected:
+	/// shows the nodes and waits until the visualization has drawn them
+	void showNodes (SeqNeurons* neurons)
+	{
+		mutex.lock();
+		emit updateData (neurons);
+		condition.wait (&mutex);
+		mutex.unlock();
+	}
+	/// the visualization only draws nodes of type <double,int>, others are not shown
+	template<typename N> void showNodes (N*) {}
+	/// passes the data and the nodes to the visualization
+	void showData (SeqData* data, SeqNeurons* neurons)
+	{
+		emit initializeData (data, neurons);
+	}
+	/// the visualization only draws data and nodes of type <double,int>, others are not shown
+	template<typename D, typename N> void showData (D*, N*) {}
 	QMutex mutex;
 	QWaitCondition condition;
 	bool visualizing;
@@ -99,6 +116,8 @@ class LLRGNGAlgorithm : public GNGModul<T,S>, public LLRGNGThread
 {
 	friend class boost::serialization::access;
 public:
+	/// type of the sums over the data set like the MDL terms, see Accumulator
+	typedef typename Accumulator<T>::type SumType;
 
 	// default cto.
 	LLRGNGAlgorithm ();
@@ -141,7 +160,7 @@ public:
 	// gets maximal partition
 	unsigned int getMaxNodes () const;
 	// calculate the Minimum Description Length of the current graph and dataset
-	T calculateMinimumDescriptionLength (bool calculate_model_efficiency = true);
+	SumType calculateMinimumDescriptionLength (bool calculate_model_efficiency = true);
 	// set maximum nr of epochs after avg error reduction is expected
 	void setMaxEpochsErrorReduction (unsigned int);
 	// set maximum nr of epochs after mdl reduction is expected
@@ -157,7 +176,7 @@ public:
 	/// get average error among all graph nodes
 	T getAvgError ();
 	// get model efficiency (error) of current graph
-	T getModelEfficiency ();
+	SumType getModelEfficiency ();
 	// calculate value range of data
 	void calculateValueRange ();
 protected:
@@ -168,12 +187,14 @@ protected:
 	// check if minimal MDL has not changed for more than \p max_epochs_mdl_reduction
 	bool minimalMDL ();
 	// calculate model efficiency (error) of a graph
-	T calculateModelEfficiency (LLRGNGGraph<T,S>* graph);
-	T calculateModelEfficiency (LLRGNGGraph<T,S>* graph, unsigned int&);
+	SumType calculateModelEfficiency (LLRGNGGraph<T,S>* graph);
+	SumType calculateModelEfficiency (LLRGNGGraph<T,S>* graph, unsigned int&);
 	// mark the current graph as stable in order to stop the algorithm
 	void markAsStableGraph ();
 	// calculate initial restricting distances for every node
 	void calculateInitialRestrictingDistances ();
+	// calculate initial restricting distances for the nodes from begin to end
+	void calculateInitialRestrictingDistances (const unsigned int&, const unsigned int&) const;
 	// check if restricting distances are overflowed
 	void checkOverflowedRestrictingDistances ();
 	// save MDL history in text files
@@ -190,6 +211,8 @@ protected:
 	void learning_loop ( unsigned int, unsigned int );
 	// update params like age, avg errors, etc.
 	void updateParams (unsigned int&, unsigned int&, unsigned int&);
+	// update the avg errors of a node with the errors per dimension in a Vector<T,N>
+	template<unsigned int N> void updateAvgError (const unsigned int&, const unsigned int&, T&);
 	/// insertion rate constant
 	T insertion_rate;
 	/// maximal number of nodes if it is set (not obligatory)
@@ -199,9 +222,9 @@ protected:
 	/// current training epoch
 	unsigned int epoch;
 	/// current minimum description length value
-	T mdl;
+	SumType mdl;
 	/// current minimal mdl
-	T min_mdl;
+	SumType min_mdl;
 	/// current minimal graph (mdl criterion)
 	LLRGNGGraph<T,S>* min_mdl_graphptr;
 	// UGraph<T,S>* min_mdl_graphptr;
@@ -226,6 +249,23 @@ protected:
 	/// file for saving MDL history
 	std::ofstream* mdl_history;
 private:
+	/// pass over the nodes run by parallelRanges
+	struct RestrictingDistancesJob
+	{
+		RestrictingDistancesJob (const LLRGNGAlgorithm& a) : algorithm (a) {}
+		void run (const unsigned int& begin, const unsigned int& end) const { algorithm.calculateInitialRestrictingDistances (begin, end); }
+		const LLRGNGAlgorithm& algorithm;
+	};
+	/// update of the avg errors run by dispatchDimension
+	struct AvgErrorUpdate
+	{
+		AvgErrorUpdate (LLRGNGAlgorithm& a, const unsigned int& t, const unsigned int& b, T& d) : algorithm (a), item (t), node (b), distance (d) {}
+		template<unsigned int N> void run () { algorithm.template updateAvgError<N> (item, node, distance); }
+		LLRGNGAlgorithm& algorithm;
+		const unsigned int& item;
+		const unsigned int& node;
+		T& distance;
+	};
 	template<class Archive>
 	void serialize(Archive & ar, const unsigned int);
 
@@ -240,12 +280,14 @@ LLRGNGAlgorithm<T,S>::LLRGNGAlgorithm(const unsigned int& dim, const unsigned in
 	GNGModul<T,S>(dim),
 	max_nodes (0),
 	data_accuracy (0.001),
+	epoch (0),
 	mdl (1e10),
 	min_mdl (mdl),
 	min_mdl_graphptr (NULL),
 	max_epochs_error_reduction (5),
 	max_epochs_mdl_reduction (80),
 	last_epoch_mdl_reduction (0),
+	stable_graph (false),
 	model_efficiency_const (1.0),
 	mean_distance_mode (harmonic),
 	mdl_history (NULL)
@@ -264,12 +306,14 @@ LLRGNGAlgorithm<T,S>::LLRGNGAlgorithm():
 	GNGModul<T,S>(0),
 	max_nodes (0),
 	data_accuracy (0),
+	epoch (0),
 	mdl (0),
 	min_mdl (0),
 	min_mdl_graphptr (0),
 	max_epochs_error_reduction (0),
 	max_epochs_mdl_reduction (0),
 	last_epoch_mdl_reduction (0),
+	stable_graph (false),
 	model_efficiency_const (0),
 	mean_distance_mode (harmonic),
 	mdl_history (0)
@@ -283,12 +327,14 @@ LLRGNGAlgorithm<T,S>::LLRGNGAlgorithm(const LLRGNGAlgorithm& l) :
 	GNGModul<T,S>(l),
 	max_nodes (l.max_nodes),
 	data_accuracy (l.data_accuracy),
+	epoch (l.epoch),
 	mdl (l.mdl),
 	min_mdl (l.min_mdl),
 	min_mdl_graphptr (0),
 	max_epochs_error_reduction (l.max_epochs_error_reduction),
 	max_epochs_mdl_reduction (l.max_epochs_mdl_reduction),
 	last_epoch_mdl_reduction (l.last_epoch_mdl_reduction),
+	stable_graph (l.stable_graph),
 	model_efficiency_const (l.model_efficiency_const),
 	mean_distance_mode (l.mean_distance_mode),
 	mdl_history (0)
@@ -336,7 +382,7 @@ void LLRGNGAlgorithm<T,S>::setRefVectors(const unsigned int& num_of_ref_vec)
 		calculateInitialRestrictingDistances ();
 
 	if (visualizing)
-		emit initializeData (this->_data, _graphptr->getNodes());
+		showData (this->_data, _graphptr->getNodes());
 
 }
 
@@ -476,11 +522,13 @@ void LLRGNGAlgorithm<T,S>::resetLearning ()
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (&(*this->_graphptr)[i]);
 		node->min_last_avgerror = metric (_graphptr->getHighLimits (), _graphptr->getLowLimits());
 		node->last_avgerror = node->prev_avgerror = -1;
-		node->errors.clear();
-		node->dim_errors.clear();
-		for (unsigned int j=0; j<node->edges.size(); j++)
-			if ( node->edges[j] != NULL )
-				_graphptr->setAge (i, j, 0.0);
+		node->errors.reset();
+		node->dim_errors.reset();
+		_graphptr->calculateInsertionQuality (i);
+		_graphptr->calculateInsertionCriterion (i);
+		std::vector<unsigned int> neighbors = _graphptr->getNeighbors (i);
+		for (unsigned int j=0; j<neighbors.size(); j++)
+			_graphptr->setAge (i, neighbors[j], 0.0);
 	}
 
 }
@@ -503,8 +551,8 @@ void LLRGNGAlgorithm<T,S>::updateWinnerWeight(const unsigned int& item_index,con
 	else
 		amplitude = distance;
 	
-	node->weight += node->learning_rate * amplitude * ( (*this)[item_index]-node->weight) / distance;
-
+	node->weight.moveToward ((*this)[item_index], node->learning_rate * amplitude / distance);
+	_graphptr->weightChanged (node_index);
 }
 
 /** \brief Defines the update rule for a node given by the second index 
@@ -530,7 +578,8 @@ void LLRGNGAlgorithm<T,S>::updateNeighborWeight(const unsigned int& item_index,c
 	else
 		amplitude = distance;
 	
-	node->weight += node->learning_rate * amplitude * ( (*this)[item_index]-node->weight) / distance;
+	node->weight.moveToward ((*this)[item_index], node->learning_rate * amplitude / distance);
+	_graphptr->weightChanged (node_index);
 
 	// T dist_avg;
 	// typename std::map<unsigned int, T>::iterator it;
@@ -632,7 +681,7 @@ void LLRGNGAlgorithm<T,S>::learning_loop ( unsigned int t, unsigned int i )
 	unsigned int b;
 	//second winner
 	unsigned int s;
-	T distance = _graphptr->getWinner(b,s,(*this)[t]);
+	T distance = _graphptr->getWinner(b,s,(*this)[t],t);
 	// _graphptr->increaseItemsCounter (b);
 	
 	//learning rule for weight adaptation
@@ -660,12 +709,7 @@ void LLRGNGAlgorithm<T,S>::learning_loop ( unsigned int t, unsigned int i )
 	{
 		// calculateInitialRestrictingDistances ();
 		if (visualizing)
-		{
-			mutex.lock();
-			emit updateData(_graphptr->getNodes());
-			condition.wait (&mutex);
-			mutex.unlock();
-		}
+			showNodes (_graphptr->getNodes());
 		if (min_mdl_graphptr != NULL)
 			updateMinimalGraphMDL ();
 		else
@@ -693,12 +737,7 @@ void LLRGNGAlgorithm<T,S>::learning_loop ( unsigned int t, unsigned int i )
 					updateMinimalGraphMDL();
 
 					if (visualizing)
-					{
-						mutex.lock();
-						emit updateData(_graphptr->getNodes());
-						condition.wait (&mutex);
-						mutex.unlock();
-					}
+						showNodes (_graphptr->getNodes());
 
 					if (minimalMDL ())
 					{
@@ -709,12 +748,7 @@ void LLRGNGAlgorithm<T,S>::learning_loop ( unsigned int t, unsigned int i )
 				}
 			}
 
-			for (unsigned int j=0; j<_graphptr->size(); j++)
-			{
-				_graphptr->calculateInsertionQuality (j);
-				_graphptr->calculateInsertionCriterion (j);
-			}
-				
+			// the graph keeps the insertion criterion of the nodes up to date
 			int q = maxInsertionCriterionNode ();
 		
 			// find node among neighbours of q with maximal value of
@@ -738,12 +772,7 @@ void LLRGNGAlgorithm<T,S>::learning_loop ( unsigned int t, unsigned int i )
 					if (mean_distance_mode == harmonic)
 						calculateInitialRestrictingDistances ();
 					if (visualizing)
-					{
-						mutex.lock();
-						emit updateData(_graphptr->getNodes());
-						condition.wait (&mutex);
-						mutex.unlock();
-					}
+						showNodes (_graphptr->getNodes());
 				}
 			}
 		}		
@@ -777,12 +806,11 @@ void LLRGNGAlgorithm<T,S>::updateParams (unsigned int& t, unsigned int& b, unsig
 {
 	if (b < _graphptr->size())
 	{
-		Vector<T> dim_distances (this->getDimension());
-		for (unsigned int i=0; i<this->getDimension(); i++)
-			dim_distances[i] = T(fabs ((*this)[t][i] - (*_graphptr)[b].weight[i]));
 		T min_error = _graphptr->getNodeMinLastAvgError (b);
 		T distance = _graphptr->getDistance ((*this)[t], b);
-		_graphptr->updateAvgError (b, distance, dim_distances);
+		// the errors per dimension live on the stack for the low dimensions
+		AvgErrorUpdate update (*this, t, b, distance);
+		dispatchDimension (this->getDimension(), update);
 		if (mean_distance_mode == harmonic)
 			_graphptr->updateRestrictingDistance (b, distance);
 		std::vector<unsigned int> b_neighbors = _graphptr->getNeighbors(b);
@@ -819,24 +847,33 @@ void LLRGNGAlgorithm<T,S>::updateParams (unsigned int& t, unsigned int& b, unsig
 
 }
 
+/** \brief update the avg errors of a node with the errors of a data item per dimension
+ *
+ *  The errors per dimension are collected in a Vector<T,N>, i.e. without heap
+ *  allocation for the fixed dimensions, and in a Vector<T> for N = 0.
+ *  \param t index of the data item
+ *  \param b index of the node
+ *  \param distance distance of the data item to the node
+ */
+template<typename T, typename S>
+template<unsigned int N>
+void LLRGNGAlgorithm<T,S>::updateAvgError (const unsigned int& t, const unsigned int& b, T& distance)
+{
+	Vector<T,N> dim_distances;
+	dim_distances.resize (this->getDimension());
+	const Vector<T>& item = (*this)[t];
+	const T* weight = _graphptr->weights().row(b);
+	for (unsigned int i=0; i<this->getDimension(); i++)
+		dim_distances[i] = T(fabs (item[i] - weight[i]));
+	_graphptr->template updateAvgError<N> (b, distance, &dim_distances[0]);
+}
+
 /** \brief find node with maximal value of insertion criterion
  */
 template<typename T, typename S>
 int LLRGNGAlgorithm<T,S>::maxInsertionCriterionNode ()
 {
-	assert (_graphptr->size());
-	T max_value = 0;
-	int q = -1;
-	for (unsigned int i=0; i < _graphptr->size(); i++)
-	{
-		T value = (static_cast<LLRGNGNode<T,S>* > (&(*_graphptr)[i]))->insertion_criterion;
-		if (max_value < value)
-		{
-			max_value = value;
-			q = i;
-		}
-	}
-	return q;
+	return _graphptr->maxInsertionCriterionNode ();
 }
  
 /** \brief find node with maximal value of insertion quality among some nodes
@@ -862,25 +899,32 @@ int LLRGNGAlgorithm<T,S>::maxInsertionQualityNode (const std::vector<unsigned in
 }
 
 //! \brief calculate model efficiency of a graph.
-/*! \param graph 
+/*! The winners of all data items are determined at once by assignBatch.
+  \param graph 
   \return model efficiency
 */
 template<typename T, typename S>
-T LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph)
+typename LLRGNGAlgorithm<T,S>::SumType LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph)
 {
 	graph->resetMDLCounters ();
+	std::vector<const Vector<T>*> items (this->size());
+	for(unsigned int t = 0; t < this->size(); t++)
+		items[t] = &(*this)[t];
+	std::vector< Assignment<T> > winners;
+	graph->assignBatch (items, winners);
 	for(unsigned int t = 0; t < this->size(); t++)
 	{
-		//winners
-		unsigned int b, s;
-		/*T distance = */graph->getWinner(b,s,(*this)[t]);
+		//winner
+		unsigned int b = winners[t].first;
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (&(*graph)[b]);
 		node->items_counter++;
-		node->data.push_back (t);
-		T node_item_efficiency = 0;
+		node->data.write().push_back (t);
+		const Vector<T>& item = (*this)[t];
+		const T* weight = graph->weights().row(b);
+		SumType node_item_efficiency = 0;
 		for (unsigned int i=0; i<this->getDimension(); i++)
 		{
-			node_item_efficiency += std::max(log2((fabs((*this)[t][i] -  (*graph)[b].weight[i])) / data_accuracy), 1.0);
+			node_item_efficiency += std::max(log2((fabs(SumType(item[i]) -  weight[i])) / data_accuracy), SumType(1.0));
 		}
 		node->efficiency += node_item_efficiency;
 		graph->model_efficiency += node_item_efficiency;
@@ -896,20 +940,27 @@ T LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph)
   \return model efficiency
 */
 template<typename T, typename S>
-T LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph, unsigned int& rmnode_index)
+typename LLRGNGAlgorithm<T,S>::SumType LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph, unsigned int& rmnode_index)
 {
 	LLRGNGNode<T,S>* rmnode = static_cast<LLRGNGNode<T,S>* > (&(*_graphptr)[rmnode_index]);
-	for(unsigned int t = 0; t < rmnode->data.size(); t++)
+	const typename LLRGNGNode<T,S>::DataIndices& rmdata = *rmnode->data;
+	std::vector<const Vector<T>*> items (rmdata.size());
+	for(unsigned int t = 0; t < rmdata.size(); t++)
+		items[t] = &(*this)[rmdata[t]];
+	std::vector< Assignment<T> > winners;
+	graph->assignBatch (items, winners);
+	for(unsigned int t = 0; t < rmdata.size(); t++)
 	{
-		unsigned int b, s;
-		graph->getWinner(b,s,(*this)[rmnode->data[t]]);
+		unsigned int b = winners[t].first;
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (&(*graph)[b]);
 		node->items_counter++;
-		node->data.push_back (rmnode->data[t]);
-		T node_item_efficiency = 0;
+		node->data.write().push_back (rmdata[t]);
+		const Vector<T>& item = (*this)[rmdata[t]];
+		const T* weight = graph->weights().row(b);
+		SumType node_item_efficiency = 0;
 		for (unsigned int i=0; i<this->getDimension(); i++)
 		{
-			node_item_efficiency += std::max(log2((fabs((*this)[rmnode->data[t]][i] -  (*graph)[b].weight[i])) / data_accuracy), 1.0);
+			node_item_efficiency += std::max(log2((fabs(SumType(item[i]) -  weight[i])) / data_accuracy), SumType(1.0));
 		}
 		node->efficiency += node_item_efficiency;	
 	}
@@ -921,14 +972,14 @@ T LLRGNGAlgorithm<T,S>::calculateModelEfficiency (LLRGNGGraph<T,S>* graph, unsig
 
 //! \brief Get model efficiency of the current \p _graphptr
 template<typename T, typename S>
-T LLRGNGAlgorithm<T,S>::getModelEfficiency ()
+typename LLRGNGAlgorithm<T,S>::SumType LLRGNGAlgorithm<T,S>::getModelEfficiency ()
 {
 	return _graphptr->model_efficiency;
 }
 
 //! \brief Calculate MDL for the current \p _graphptr
 template<typename T, typename S>
-T LLRGNGAlgorithm<T,S>::calculateMinimumDescriptionLength (bool calculate_model_efficiency)
+typename LLRGNGAlgorithm<T,S>::SumType LLRGNGAlgorithm<T,S>::calculateMinimumDescriptionLength (bool calculate_model_efficiency)
 {
 	// items_per_winner = std::vector<unsigned int> (_graphptr->size());
 	//std::vector<int> winner_per_item (this->size(), -1);
@@ -937,7 +988,7 @@ T LLRGNGAlgorithm<T,S>::calculateMinimumDescriptionLength (bool calculate_model_
 	if (calculate_model_efficiency)
 		calculateModelEfficiency (_graphptr);
 	mdl = model_efficiency_const * _graphptr->model_efficiency;
-	T L_inliers = this->size() * log2 (_graphptr->size());
+	SumType L_inliers = this->size() * log2 (SumType (_graphptr->size()));
 	
 	mdl += _graphptr->size() * bits_vector + L_inliers;
 	*(this->out) << "K: " << bits_vector << std::endl;
@@ -963,8 +1014,8 @@ void LLRGNGAlgorithm<T,S>::findDislocatedNodesStableGraph ()
 		return;
 	}
 
-	T min_change = 0;
-	T model_complexity_change = -bits_vector + this->size() * (log2 (_graphptr->size() - 1) - log2 (_graphptr->size()));
+	SumType min_change = 0;
+	SumType model_complexity_change = -bits_vector + this->size() * (log2 (SumType (_graphptr->size() - 1)) - log2 (SumType (_graphptr->size())));
 	*(this->out) << "mod complex. change: " << model_complexity_change << std::endl;
 	unsigned int dislocated_node = _graphptr->size();
 	dislocated_node_graphptr = NULL;
@@ -972,11 +1023,10 @@ void LLRGNGAlgorithm<T,S>::findDislocatedNodesStableGraph ()
 	LLRGNGGraph<T,S>* pruned_graph; 
 	for (unsigned int i=0; i<_graphptr->size(); i++)
 	{
-		pruned_graph = new LLRGNGGraph<T,S>(*_graphptr);
-		pruned_graph->rmNode (i);
+		pruned_graph = new LLRGNGGraph<T,S>(*_graphptr, i);
 		calculateModelEfficiency (pruned_graph, i);
 
-		T change = model_complexity_change + model_efficiency_const * (pruned_graph->model_efficiency - _graphptr->model_efficiency);
+		SumType change = model_complexity_change + model_efficiency_const * (pruned_graph->model_efficiency - _graphptr->model_efficiency);
 		if (change < min_change)
 		{
 			
@@ -986,9 +1036,10 @@ void LLRGNGAlgorithm<T,S>::findDislocatedNodesStableGraph ()
 			min_change = change;
 			if (dislocated_node_graphptr != NULL)
 				delete dislocated_node_graphptr;
-			dislocated_node_graphptr = new LLRGNGGraph<T,S> (*pruned_graph);
+			dislocated_node_graphptr = pruned_graph;
 		}
-		delete pruned_graph;
+		else
+			delete pruned_graph;
 	}
 	if (dislocated_node != _graphptr->size())
 	{
@@ -1126,12 +1177,7 @@ void LLRGNGAlgorithm<T,S>::markAsStableGraph ()
 	stable_graph = true;
 
 	if (visualizing)
-	{
-		mutex.lock();
-		emit updateData(_graphptr->getNodes());
-		condition.wait (&mutex);
-		mutex.unlock();
-	}
+		showNodes (_graphptr->getNodes());
 
 }
 
@@ -1140,12 +1186,8 @@ void LLRGNGAlgorithm<T,S>::markAsStableGraph ()
 template<typename T, typename S>
 void LLRGNGAlgorithm<T,S>::calculateValueRange ()
 {
-	T avg_values = 0;
-	for(unsigned int t = 0; t < this->size(); t++)
-		for (unsigned int i=0; i<this->getDimension(); i++)
-			avg_values += (*this)[t][i];
-	avg_values /= T (this->size() * this->getDimension());
-	value_range = avg_values - this->minValue ();
+	const DataStatistics<T>& data_statistics = this->statistics ();
+	value_range = data_statistics.meanValue () - data_statistics.minValue ();
 
 	*(this->out) << "value range: " << value_range << std::endl;
 
@@ -1153,19 +1195,32 @@ void LLRGNGAlgorithm<T,S>::calculateValueRange ()
 
 }
 
-/** \brief calculate initial restricting distances for every node
+/** \brief calculate initial restricting distances for every node,
+    the nodes are distributed among threads (see parallelRanges)
  */
 template<typename T, typename S>
 void LLRGNGAlgorithm<T,S>::calculateInitialRestrictingDistances ()
 {
-	for (unsigned int i=0; i < _graphptr->size(); i++)
+	parallelRanges (RestrictingDistancesJob (*this), _graphptr->size(), 0, 1);
+}
+
+/** \brief calculate initial restricting distances for the nodes from begin to end,
+    the nodes are independent of each other
+    \param begin first node
+    \param end node after the last one
+ */
+template<typename T, typename S>
+void LLRGNGAlgorithm<T,S>::calculateInitialRestrictingDistances (const unsigned int& begin, const unsigned int& end) const
+{
+	for (unsigned int i=begin; i < end; i++)
 	{
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (&(*_graphptr)[i]);
 		node->restricting_distance = 0;
+		const Vector<T> weight = node->weight;
 
 		for (unsigned int t=0; t<this->size(); t++)
 		{
-			node->restricting_distance += 1.0 / (this->metric (node->weight, (*this)[t]) + 0.01);
+			node->restricting_distance += 1.0 / (this->metric (weight, (*this)[t]) + 0.01);
 		}
 		node->restricting_distance /= this->size();
 		node->restricting_distance = 1.0 / node->restricting_distance;
@@ -1180,14 +1235,14 @@ void LLRGNGAlgorithm<T,S>::calculateInitialRestrictingDistances ()
 template<typename T, typename S>
 T LLRGNGAlgorithm<T,S>::getAvgError ()
 {
-	T avgerror = 0;
+	SumType avgerror = 0;
 	for (unsigned int i=0; i < _graphptr->size(); i++)
 	{
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (&(*_graphptr)[i]);
 		avgerror += node->last_avgerror;
 	}
 	avgerror /= _graphptr->size ();
-	return avgerror;
+	return T (avgerror);
 }
 
 /** \brief check if restricting distances are overflowed and if so recalculate them
@@ -28,6 +28,8 @@
 #define LLRGNGGRAPH_H
 
 #include <GrowingNeuralGas/GNGModulGraph.h>
+#include <Graphs/IndexedMaxHeap.h>
+#include <Graphs/CopyOnWrite.h>
 #include <tools/metrics.h>
 
 namespace neuralgas {
@@ -43,6 +45,10 @@ namespace neuralgas {
  * "Intrinsic Motivation Systems for Autonomous Mental Development"
  * by Oudeyer, Kaplan, Hafner.
  *
+ * The error windows and the data indices are shared with the copies of the node made
+ * by the copy constructor of LLRGNGGraph (copy-on-write), they are copied only when
+ * they are changed, thus graph snapshots do not duplicate them for unchanged nodes.
+ *
  */
 template<typename T,typename S>
 struct LLRGNGNode : Base_Node<T,S>
@@ -58,11 +64,13 @@ struct LLRGNGNode : Base_Node<T,S>
 	/// delete operator overloading
 	static inline void operator delete( void* p )
 	{ pool.deallocate( static_cast<LLRGNGNode<T,S>* >(p) ) ; }
+	/// container type of the data set indices
+	typedef std::vector< unsigned int, boost::pool_allocator<unsigned int> > DataIndices;
 	/// errors vector for calculating different parameters. Its size is
 	/// set by the maximum allowable error window
-	std::vector<T> errors;
-	/// errors vector for each dimension
-	std::vector<Vector<T> > dim_errors;
+	CopyOnWrite<std::vector<T> > errors;
+	/// errors for each dimension, the ones of an error of \p errors follow each other
+	CopyOnWrite<std::vector<T> > dim_errors;
 	// calculate \p learning_quality measure
 	void calculateLearningQuality ();
 	/// quality measure for learning
@@ -76,7 +84,7 @@ struct LLRGNGNode : Base_Node<T,S>
 	/// insertion criterion
 	T insertion_criterion;
 	// calculate \p prev_avgerror and \p last_avgerror
-	void updateAvgError (T&, Vector<T>&, const unsigned int&, const unsigned int&, const unsigned int&);
+	template<unsigned int N> void updateAvgError (T&, const T*, const unsigned int&, const unsigned int&, const unsigned int&);
 	// update \p restricting_distance
 	void updateRestrictingDistance (T);
 	/// previous mean error counter
@@ -103,14 +111,14 @@ struct LLRGNGNode : Base_Node<T,S>
 	T learning_rate;
 	/// counter for the nr. of items in the receptive field of this node
 	unsigned int items_counter;
-	/// model efficiency contribution to total MDL
-	T efficiency;
+	/// model efficiency contribution to total MDL, summed in double for float weights
+	typename Accumulator<T>::type efficiency;
 	/// repulsion constant for updating weights
 	// T repulsion;
 	/// mode for calculating mean distances
 	unsigned int mean_distance_mode;
 	/// data set indices that the node covers (used for calculating mdl values and for active learning)
-        std::vector< unsigned int, boost::pool_allocator<unsigned int> > data;
+        CopyOnWrite<DataIndices> data;
 	// memory pool for node objects
         static boost::fast_pool_allocator<LLRGNGNode<T,S> > pool;
 private:
@@ -124,6 +132,14 @@ private:
 /// \brief default \p LLRGNGNode cto
 template<typename T, typename S>
 LLRGNGNode<T,S>::LLRGNGNode () :
+	learning_quality (0),
+	insertion_quality (0),
+	insertion_criterion (0),
+	prev_avgerror (0),
+	last_avgerror (0),
+	restricting_distance (0),
+	prev_restricting_distance (0),
+	min_last_avgerror (0),
 	last_epoch_improvement (0),
 	age (1),
 	learning_rate (0),
@@ -136,7 +152,6 @@ LLRGNGNode<T,S>::LLRGNGNode () :
 template<typename T, typename S>
 LLRGNGNode<T,S>::~LLRGNGNode ()
 {
-	this->edges.clear();
 }
 
 
@@ -203,22 +218,31 @@ void LLRGNGNode<T,S>::updateLearningRate (T& adaptation_threshold, T& default_ra
  *         using the strategy in Oudeyer et al. Harmonic
  *         distances are used.
  *  \param last_error last calculated distance to some data item
+ *  The errors per dimension are summed in a Vector<Sum,N>, for the fixed
+ *  dimensions N the sums stay in registers, N = 0 works for any dimension.
+ *  The sums are of type Accumulator<T>::type, i.e. double for float errors.
+ *  \param dim_last_error last calculated distances per dimension
  *  \param smoothing smoothing window constant
  *  \param timewindow error time window constant
  */
 template<typename T, typename S>
-void LLRGNGNode<T,S>::updateAvgError (T& last_error, Vector<T>& dim_last_error, const unsigned int& smoothing, const unsigned int& timewindow, const unsigned int& max_errors_size)
+template<unsigned int N>
+void LLRGNGNode<T,S>::updateAvgError (T& last_error, const T* dim_last_error, const unsigned int& smoothing, const unsigned int& timewindow, const unsigned int& max_errors_size)
 {
-	if (errors.size() == max_errors_size)
+	const unsigned int dim = N ? N : dim_last_avgerror.size();
+	assert (dim == dim_last_avgerror.size());
+	std::vector<T>& errs = errors.write();
+	std::vector<T>& dim_errs = dim_errors.write();
+	if (errs.size() == max_errors_size)
 	{
-		errors.erase (errors.begin());
-		dim_errors.erase (dim_errors.begin());
+		errs.erase (errs.begin());
+		dim_errs.erase (dim_errs.begin(), dim_errs.begin() + dim);
 	}
 
-	errors.push_back (last_error);
-	dim_errors.push_back (dim_last_error);
+	errs.push_back (last_error);
+	dim_errs.insert (dim_errs.end(), dim_last_error, dim_last_error + dim);
 	
-	unsigned int errors_size = errors.size();
+	unsigned int errors_size = errs.size();
 	
 	T timewindow_ratio = timewindow / T(smoothing + timewindow);
 	T smoothing_ratio = smoothing / T(smoothing + timewindow);
@@ -250,44 +274,46 @@ void LLRGNGNode<T,S>::updateAvgError (T& last_error, Vector<T>& dim_last_error,
 		windowbegin_last_avgerror = errors_size - 1 - smoothing;
 
 	assert (windowbegin_prev_avgerror >= 0 && windowlast_prev_avgerror >= 0 && windowbegin_last_avgerror >= 0);
-	prev_avgerror = 0.0;
-	last_avgerror = 0.0;
+	typedef typename Accumulator<T>::type Sum;
+	Sum prev_sum = 0.0;
+	Sum last_sum = 0.0;
 
 	if (mean_distance_mode == harmonic)
 	{
 		for (unsigned int i=windowbegin_last_avgerror; i < errors_size; i++) 
-			last_avgerror += 1.0 / errors[i];
+			last_sum += 1.0 / errs[i];
 		for (unsigned int i=windowbegin_prev_avgerror; i<=windowlast_prev_avgerror; i++)
-			prev_avgerror += 1.0 / errors[i];	
+			prev_sum += 1.0 / errs[i];	
 		
-		prev_avgerror = smoothing_prev / prev_avgerror;
-		last_avgerror = smoothing_last / last_avgerror;
+		prev_avgerror = smoothing_prev / prev_sum;
+		last_avgerror = smoothing_last / last_sum;
 		
-		for (unsigned int i=0; i<dim_last_avgerror.size(); i++)
-		{
-			dim_last_avgerror[i] = 0.0;
-			for (unsigned int j=windowbegin_last_avgerror; j < errors_size; j++)
-				dim_last_avgerror[i] += 1.0 / dim_errors[j][i];
-			dim_last_avgerror[i] = smoothing_last / dim_last_avgerror[i];
-		}
+		// the sums start at zero
+		Vector<Sum,N> dim_sums;
+		dim_sums.resize (dim);
+		for (unsigned int j=windowbegin_last_avgerror; j < errors_size; j++)
+			for (unsigned int i=0; i<dim; i++)
+				dim_sums[i] += 1.0 / dim_errs[j * dim + i];
+		for (unsigned int i=0; i<dim; i++)
+			dim_last_avgerror[i] = smoothing_last / dim_sums[i];
 	}
 	else if (mean_distance_mode == arithmetic)
 	{
 		for (unsigned int i=windowbegin_last_avgerror; i < errors_size; i++) 
-			last_avgerror += errors[i];
+			last_sum += errs[i];
 		for (unsigned int i=windowbegin_prev_avgerror; i<=windowlast_prev_avgerror; i++)
-			prev_avgerror += errors[i];	
+			prev_sum += errs[i];	
 		
-		prev_avgerror = prev_avgerror / smoothing_prev;
-		last_avgerror = last_avgerror / smoothing_last;
-
-		for (unsigned int i=0; i<dim_last_avgerror.size(); i++)
-		{
-			dim_last_avgerror[i] = 0.0;
-			for (unsigned int j=windowbegin_last_avgerror; j < errors_size; j++)
-				dim_last_avgerror[i] += dim_errors[j][i];
-			dim_last_avgerror[i] = dim_last_avgerror[i] / smoothing_last;
-		}
+		prev_avgerror = prev_sum / smoothing_prev;
+		last_avgerror = last_sum / smoothing_last;
+
+		Vector<Sum,N> dim_sums;
+		dim_sums.resize (dim);
+		for (unsigned int j=windowbegin_last_avgerror; j < errors_size; j++)
+			for (unsigned int i=0; i<dim; i++)
+				dim_sums[i] += dim_errs[j * dim + i];
+		for (unsigned int i=0; i<dim; i++)
+			dim_last_avgerror[i] = dim_sums[i] / smoothing_last;
 	}
 
 	if (min_last_avgerror > last_avgerror)
@@ -335,9 +361,14 @@ template<typename T, typename S> class LLRGNGAlgorithm;
  *   without catastrophic interference by Fred H. Hamker.
  * and Robust growing neural gas algorithm with application in cluster analysis by Qin and Suganthan.
  *   The algorithm tries to avoid bias/variance issues in the original GNG.
+ *
+ * The insertion quality and criterion of a node are recalculated whenever its average
+ * errors change and the nodes are kept in a max-heap by their insertion criterion, such that
+ * maxInsertionCriterionNode does not have to visit all nodes. Nodes that have not been
+ * assigned a criterion yet (new, loaded) are added to the heap when it is queried.
 */
-template<typename T, typename S>
-class LLRGNGGraph : public GNGModulGraph<T,S>
+template<typename T, typename S, typename A = SparseAdjacency< Base_Edge<S,T> > >
+class LLRGNGGraph : public GNGModulGraph<T,S,A>
 {
 	friend class boost::serialization::access;
 public:
@@ -347,6 +378,8 @@ public:
 	LLRGNGGraph (const unsigned int&, const unsigned int&);
 	/// copy constructor
 	LLRGNGGraph (const LLRGNGGraph&);
+	/// copy constructor leaving out the node with the given index
+	LLRGNGGraph (const LLRGNGGraph&, const unsigned int&);
 	/// std dto
 	virtual ~LLRGNGGraph();
 	/// new operator overloading
@@ -354,7 +387,7 @@ public:
 	{ return llrgngpool.allocate() ; }
 	/// delete operator overloading
 	static inline void operator delete( void* p )
-	{ llrgngpool.deallocate( static_cast<LLRGNGGraph<T,S>* >(p) ) ; }
+	{ llrgngpool.deallocate( static_cast<LLRGNGGraph<T,S,A>* >(p) ) ; }
 	// removes the node given by the index, removes its edges and updates the number of connections of its neighbors
 	virtual void rmNode(const unsigned int&); 
 	// set time window constants
@@ -364,7 +397,7 @@ public:
 	// calculate inherited variables for a node to be inserted between two nodes
 	void calculateInheritedParams (const unsigned int, const unsigned int, const unsigned int);
 	// calculate long term and short term error for some node
-	void updateAvgError (const unsigned int, T&, Vector<T>&);
+	template<unsigned int N> void updateAvgError (const unsigned int, T&, const T*);
 	// update restricting distance value for some node
 	void updateRestrictingDistance (const unsigned int, T);
 	// calculate learning quality for some node
@@ -373,6 +406,8 @@ public:
 	void calculateInsertionQuality (const unsigned int);
 	// calculate insertion criterion for some node
 	void calculateInsertionCriterion (const unsigned int);
+	// find node with maximal value of insertion criterion
+	int maxInsertionCriterionNode ();
 	// update learning rate for some winner node
 	void updateWinnerLearningRate (const unsigned int);
 	// update learning rate for some winner-neighboring node
@@ -401,11 +436,21 @@ public:
 	void setLastEpochImprovement (const unsigned int, unsigned int);
 	// set mean distance calculation mode
 	void setMeanDistanceMode (unsigned int);
+	// get restricting distances of all nodes
+	std::vector<T> getRestrictingDistances () const;
 	friend class LLRGNGAlgorithm<T,S>;
 
 protected:
 	// returns a pointer to a edge of a type that is currently used by the graph
 	virtual LLRGNGNode<T,S>* newNode(void);
+	// removes the node from the insertion criterion heap and deletes it
+	virtual void deleteNode(const unsigned int&);
+	// changes the index of a moved node in the insertion criterion heap
+	virtual void moveNode(const unsigned int&, const unsigned int&);
+	// recalculate insertion quality and criterion for some node after its errors changed
+	void updateInsertionCriterion (const unsigned int);
+	/// indices of the nodes ordered by their insertion criterion
+	IndexedMaxHeap<T> criterion_heap;
 	/// adaptation threshold constant
 	T adaptation_threshold;
 	/// initial winner learning rate constant
@@ -422,27 +467,29 @@ protected:
 	unsigned int age_time_window;
 	/// maximal size of error vector
 	unsigned int max_errors_size;
-	/// current model efficiency value
-	T model_efficiency;
+	/// current model efficiency value, summed in double for float weights
+	typename Accumulator<T>::type model_efficiency;
 	/// mode for calculating mean distances
 	unsigned int mean_distance_mode;
 	// memory pool for graph objects
-        static boost::fast_pool_allocator<LLRGNGGraph<T,S> > llrgngpool;
+        static boost::fast_pool_allocator<LLRGNGGraph<T,S,A> > llrgngpool;
 private:
+	// copies the nodes, edges and node statistics of a graph leaving out the given node
+	void cloneGraph (const LLRGNGGraph&, const unsigned int&);
 	template<class Archive>
 	void serialize(Archive & ar, const unsigned int);
 		
 };
 
-/** \brief cto Graph creation (node and edges weights share dimensionality)
-    \param dim dimensionality
+/** \brief cto Graph creation (the edges carry no weight vector, only their age)
+    \param dim dimensionality of the node weights
  */
-template<typename T, typename S>
-LLRGNGGraph<T,S>::LLRGNGGraph (const unsigned int &dim, const unsigned int& max_error_window = 81) :
-	Base_Graph<T,S>(dim),
-	UGraph<T,S>(dim),
-	TGraph<T,S>(dim),
-	GNGModulGraph<T,S>(dim),
+template<typename T, typename S, typename A>
+LLRGNGGraph<T,S,A>::LLRGNGGraph (const unsigned int &dim, const unsigned int& max_error_window = 81) :
+	Base_Graph<T,S,A>(dim,0),
+	UGraph<T,S,A>(dim),
+	TGraph<T,S,A>(dim),
+	GNGModulGraph<T,S,A>(dim),
 	adaptation_threshold (0),
 	winner_learning_rate (0),
 	neighbors_learning_rate (0),
@@ -458,12 +505,12 @@ LLRGNGGraph<T,S>::LLRGNGGraph (const unsigned int &dim, const unsigned int& max_
 
 /** \brief Default constructor (Should only be used for serialization)
  */
-template<typename T, typename S>
-LLRGNGGraph<T,S>::LLRGNGGraph () :
-	Base_Graph<T,S>(0),
-	UGraph<T,S>(0),
-	TGraph<T,S>(0),
-	GNGModulGraph<T,S>(0),
+template<typename T, typename S, typename A>
+LLRGNGGraph<T,S,A>::LLRGNGGraph () :
+	Base_Graph<T,S,A>(0),
+	UGraph<T,S,A>(0),
+	TGraph<T,S,A>(0),
+	GNGModulGraph<T,S,A>(0),
 	adaptation_threshold (0),
 	winner_learning_rate (0),
 	neighbors_learning_rate (0),
@@ -480,14 +527,43 @@ LLRGNGGraph<T,S>::LLRGNGGraph () :
 
 /** \brief copy constructor.
  *   Calls UGraph and Base_Graph customized copy constructors (they are empty)
+ *   The error windows and data indices of the nodes are shared with \p g
+ *   until either graph changes them, see LLRGNGNode.
  *  \param g graph to be copied from. 
  */
-template<typename T,typename S>
-LLRGNGGraph<T,S>::LLRGNGGraph (const LLRGNGGraph& g) :
-	Base_Graph<T,S>(),
-	UGraph<T,S>(),
-	TGraph<T,S>(),
-	GNGModulGraph<T,S>(),
+template<typename T, typename S, typename A>
+LLRGNGGraph<T,S,A>::LLRGNGGraph (const LLRGNGGraph& g) :
+	Base_Graph<T,S,A>(),
+	UGraph<T,S,A>(),
+	TGraph<T,S,A>(),
+	GNGModulGraph<T,S,A>(),
+	adaptation_threshold (g.adaptation_threshold),
+	winner_learning_rate (g.winner_learning_rate),
+	neighbors_learning_rate (g.neighbors_learning_rate),
+	maximal_edge_age (g.maximal_edge_age),
+	smoothing_window (g.smoothing_window),
+	error_time_window (g.error_time_window),
+	age_time_window (g.age_time_window),
+	max_errors_size (g.max_errors_size),
+	model_efficiency (g.model_efficiency),
+	mean_distance_mode (g.mean_distance_mode)
+{
+	cloneGraph (g, Base_Graph<T,S,A>::npos);
+}
+
+/** \brief copy constructor leaving out a node.
+ *   The graph is the same as a copy of \p g after rmNode(removed), i.e. the last
+ *   node takes the index of the removed node and the former neighbors of the removed
+ *   node are connected, but the removed node is never copied.
+ *  \param g graph to be copied from. 
+ *  \param removed index of the node of \p g that is left out
+ */
+template<typename T, typename S, typename A>
+LLRGNGGraph<T,S,A>::LLRGNGGraph (const LLRGNGGraph& g, const unsigned int& removed) :
+	Base_Graph<T,S,A>(),
+	UGraph<T,S,A>(),
+	TGraph<T,S,A>(),
+	GNGModulGraph<T,S,A>(),
 	adaptation_threshold (g.adaptation_threshold),
 	winner_learning_rate (g.winner_learning_rate),
 	neighbors_learning_rate (g.neighbors_learning_rate),
@@ -499,39 +575,47 @@ LLRGNGGraph<T,S>::LLRGNGGraph (const LLRGNGGraph& g) :
 	model_efficiency (g.model_efficiency),
 	mean_distance_mode (g.mean_distance_mode)
 {
+	assert (removed < g.size());
+	cloneGraph (g, removed);
+}
 
+/** \brief copies the nodes, edges and node statistics of a graph, used by the copy constructors.
+ *   Nodes, weights and edges are copied in bulk by Base_Graph::cloneNodes and
+ *   Base_Graph::cloneEdges, then the statistics of the nodes are taken over.
+ *  \param g graph to be copied from.
+ *  \param removed index of the node of \p g that is left out, npos for a full copy
+ */
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::cloneGraph (const LLRGNGGraph& g, const unsigned int& removed)
+{
 	this->_dimNode = g._dimNode;
 	this->_dimEdge = g._dimEdge;
 	this->_metric_to_use = g._metric_to_use;
+	this->_winnerIndex = g._winnerIndex;
+	this->_topologicalSearch = g._topologicalSearch;
+	this->_prefilter = g._prefilter;
+	this->_triangleBounds = g._triangleBounds;
+	this->_partialDistance = g._partialDistance;
+	this->_winnerCache = g._winnerCache;
 	this->low_limit = g.low_limit;
 	this->high_limit = g.high_limit;
 	this->low_limits = g.low_limits;
 	this->high_limits = g.high_limits;
-	unsigned int gsize = g.size();
-	
-	for (unsigned int i=0; i < gsize; i++)
-	{
-		this->addNode ();
-		this->_nodes[i]->weight = g._nodes[i]->weight;
-		
-	}
-	for (unsigned int i=0; i < gsize; i++)
-		for (unsigned int j=0; j<g._nodes[i]->edges.size(); j++)
-			if ( g._nodes[i]->edges[j] != NULL )
-			{
-				this->addEdge (i, j);
-				this->_nodes[i]->edges[j]->weight = g._nodes[i]->edges[j]->weight;
-				static_cast<TEdge<S,T>* >(this->_nodes[i]->edges[j])->age = static_cast<TEdge<S,T>* >(g._nodes[i]->edges[j])->age;
-			}
+	this->cloneNodes (g, removed);
+	this->cloneEdges (g, removed);
 	
-	for (unsigned int i=0; i < gsize; i++)
+	const unsigned int last = g.size() - 1;
+	for (unsigned int i=0; i < this->size(); i++)
 	{
+		const unsigned int source = (i == removed) ? last : i;
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* >(this->_nodes[i]);
-		LLRGNGNode<T,S>* copynode = static_cast<LLRGNGNode<T,S>* >(g._nodes[i]);
+		LLRGNGNode<T,S>* copynode = static_cast<LLRGNGNode<T,S>* >(g._nodes[source]);
 
 		node->learning_quality = copynode->learning_quality;
 		node->insertion_quality = copynode->insertion_quality;
 		node->insertion_criterion = copynode->insertion_criterion;
+		if (g.criterion_heap.contains (source))
+			criterion_heap.set (i, node->insertion_criterion);
 		node->prev_avgerror = copynode->prev_avgerror;
 		node->last_avgerror = copynode->last_avgerror;
 		node->restricting_distance = copynode->restricting_distance;
@@ -548,20 +632,33 @@ LLRGNGGraph<T,S>::LLRGNGGraph (const LLRGNGGraph& g) :
 		node->mean_distance_mode = copynode->mean_distance_mode;
 		node->data = copynode->data;
 	}
+
+	if (removed < g.size())
+	{
+		// connect all former neighbor nodes as rmNode does
+		std::vector<unsigned int> neighbors = g.getNeighbors (removed);
+		for (unsigned int i=0; i < neighbors.size(); i++)
+			if (neighbors[i] == last)
+				neighbors[i] = removed;
+		for (unsigned int i=0; i < neighbors.size(); i++)
+			for (unsigned int j=0; j < neighbors.size(); j++)
+				if (i != j)
+					this->setAge (neighbors[i], neighbors[j], 0.0);
+	}
 }
 
 /** \brief dto Graph deletion
  */
-template<typename T, typename S>
-LLRGNGGraph<T,S>::~LLRGNGGraph ()
+template<typename T, typename S, typename A>
+LLRGNGGraph<T,S,A>::~LLRGNGGraph ()
 {			     
 }
 
 
 /** \brief overriden function from \p Base_Graph
     to create a node of type \p LLRGNGNode */
-template<typename T,typename S>
-LLRGNGNode<T,S>* LLRGNGGraph<T,S>::newNode(void)
+template<typename T, typename S, typename A>
+LLRGNGNode<T,S>* LLRGNGGraph<T,S,A>::newNode(void)
 {
 	LLRGNGNode<T,S>* n = new LLRGNGNode<T,S>;
 	if (this->high_limits.size() != 0 && this->low_limits.size() != 0)
@@ -569,57 +666,45 @@ LLRGNGNode<T,S>* LLRGNGGraph<T,S>::newNode(void)
 	//default inherited errors (used when initializing reference vectors)
 	n->prev_avgerror = n->last_avgerror;
 	// n->repulsion = 0.001;
-	n->errors.push_back (n->last_avgerror);
+	n->errors.write().push_back (n->last_avgerror);
 	n->min_last_avgerror = n->last_avgerror;
 	n->dim_last_avgerror.reserve (this->_dimNode);
 	n->dim_last_avgerror.resize (this->_dimNode);
-	n->dim_errors.reserve (max_errors_size);
-	n->dim_errors.resize (1);
-	n->dim_errors[0].reserve (this->_dimNode);
-	n->dim_errors[0].resize (this->_dimNode);
+	std::vector<T>& dim_errors = n->dim_errors.write();
+	dim_errors.reserve (max_errors_size * this->_dimNode);
+	dim_errors.resize (this->_dimNode);
 	n->mean_distance_mode = mean_distance_mode;
 	if (this->high_limits.size() != 0 && this->low_limits.size() != 0)
 		for (unsigned int i=0; i<this->_dimNode; i++)
-			n->dim_errors[0][i] = (this->high_limits[i] - this->low_limits[i])*(this->high_limits[i] - this->low_limits[i]);
+			dim_errors[i] = (this->high_limits[i] - this->low_limits[i])*(this->high_limits[i] - this->low_limits[i]);
 	return n; 
 }
 
 /** \brief Removes the node given by the index, removes its edges and updates the number 
  * of connections of its neighbors. Connects the nodes that were its neighbors.
+ * As in Base_Graph::rmNode the last node takes the index of the removed node.
  *
  * \param index is the node that shall be deleted
  */
-template<typename T,typename S>
-void LLRGNGGraph<T,S>::rmNode(const unsigned int& index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::rmNode(const unsigned int& index)
 {
 	// function does as follows
-	// checks whether the neighbors have an (directed) edge to index and deletes them
-	// deletes node in the _nodes array  
+	// removes the node and its edges by Base_Graph::rmNode
+	// connects the former neighbors
  
-	unsigned int     nsize=this->size();
-	assert ( index < nsize );
+	assert ( index < this->size() );
 	std::vector<unsigned int> neighbors = this->getNeighbors(index);
-   
+	std::vector<NodeHandle> handles;
+	handles.reserve (neighbors.size());
 	for(unsigned int i=0; i < neighbors.size(); i++)
-		if ( this->_nodes[ neighbors[i] ]->edges[index]!=NULL ) // edge from i to index
-		{
-			delete  this->_nodes[  neighbors[i] ]->edges[index];
-			this->_nodes[ neighbors[i] ]->edges[index]=NULL; // (really needed?)
-			this->_nodes[ neighbors[i] ]->num_connections--;
-		}  
-   
-	for(unsigned int i=0; i < nsize; i++)
-		this->_nodes[ i ]->edges.erase( this->_nodes[ i ]->edges.begin() + index ); 
-
-	delete this->_nodes[index];                                 // delete ptrs to the nodes (really needed?)
-	this->_nodes[index] = NULL;  // (really needed?)
+		handles.push_back (this->getHandle(neighbors[i]));
    
-	this->_nodes.erase(this->_nodes.begin() + index);                 // erase node within the array
+	Base_Graph<T,S,A>::rmNode(index);
 
-	//reindex
+	// a neighbor may have been moved into the place of the removed node
 	for(unsigned int i=0; i < neighbors.size(); i++)
-		if (neighbors[i] > index)
-			neighbors[i]--;
+		neighbors[i] = this->getIndex(handles[i]);
 	
 	// connect all neighbor nodes
 	for(unsigned int i=0; i < neighbors.size(); i++)
@@ -634,8 +719,8 @@ void LLRGNGGraph<T,S>::rmNode(const unsigned int& index)
     \param smoothing smoothing time window constant
     \param longterm error time window constant
     \param age age time window constant */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setTimeWindows (unsigned int smoothing, unsigned int error, unsigned int age)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setTimeWindows (unsigned int smoothing, unsigned int error, unsigned int age)
 {
 	assert (max_errors_size > error + smoothing);
 
@@ -647,8 +732,8 @@ void LLRGNGGraph<T,S>::setTimeWindows (unsigned int smoothing, unsigned int erro
 /** \brief reset max errors size
     \param size
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setMaxErrorsSize (unsigned int size = 81)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setMaxErrorsSize (unsigned int size = 81)
 {
 	max_errors_size = size;
 }
@@ -659,8 +744,8 @@ void LLRGNGGraph<T,S>::setMaxErrorsSize (unsigned int size = 81)
  *  \param first_index 1st node index
  *  \param snd_index 2nd node index
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::calculateInheritedParams (const unsigned int index, const unsigned int first_index, const unsigned int snd_index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::calculateInheritedParams (const unsigned int index, const unsigned int first_index, const unsigned int snd_index)
 {
 	LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* >(this->_nodes[index]);
 	LLRGNGNode<T,S>* first_node = static_cast<LLRGNGNode<T,S>* >(this->_nodes[first_index]);
@@ -678,26 +763,28 @@ void LLRGNGGraph<T,S>::calculateInheritedParams (const unsigned int index, const
 
 	node->min_last_avgerror = node->last_avgerror;
 	first_node->last_avgerror = first_node->prev_avgerror = 0;
-	first_node->errors.clear();
-	first_node->dim_errors.clear();
+	first_node->errors.reset();
+	first_node->dim_errors.reset();
 	
-	assert (node->errors.size() == 1);
+	assert (node->errors->size() == 1);
 	// node->errors.front() = node->last_avgerror;
-	node->errors.pop_back();
-	node->dim_errors.pop_back();
+	node->errors.write().pop_back();
+	node->dim_errors.write().resize (node->dim_errors->size() - this->_dimNode);
 
-	
+	updateInsertionCriterion (index);
+	updateInsertionCriterion (first_index);
 }
 
 
 
 /** \brief calculate last and previous mean error for a given node
     \param index node index */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::updateAvgError (const unsigned int index, T& last_error, Vector<T>& dim_last_error)
+template<typename T, typename S, typename A>
+template<unsigned int N>
+void LLRGNGGraph<T,S,A>::updateAvgError (const unsigned int index, T& last_error, const T* dim_last_error)
 {
-	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->updateAvgError(last_error, dim_last_error, smoothing_window, error_time_window, max_errors_size);
-
+	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->template updateAvgError<N> (last_error, dim_last_error, smoothing_window, error_time_window, max_errors_size);
+	updateInsertionCriterion (index);
 }
 
 //! \brief update restricting distance value for some node
@@ -706,8 +793,8 @@ void LLRGNGGraph<T,S>::updateAvgError (const unsigned int index, T& last_error,
   \param index node index
   \param last_error last error to calculate current value
 */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::updateRestrictingDistance (const unsigned int index, T last_error)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::updateRestrictingDistance (const unsigned int index, T last_error)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->updateRestrictingDistance(last_error);
 
@@ -716,8 +803,8 @@ void LLRGNGGraph<T,S>::updateRestrictingDistance (const unsigned int index, T la
 
 /** \brief calculate learning quality for a node
     \param index node index */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::calculateLearningQuality (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::calculateLearningQuality (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->calculateLearningQuality();
 	
@@ -725,8 +812,8 @@ void LLRGNGGraph<T,S>::calculateLearningQuality (const unsigned int index)
 
 /** \brief calculate insertion quality for a node
     \param index node index */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::calculateInsertionQuality (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::calculateInsertionQuality (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->calculateInsertionQuality();
 	
@@ -734,19 +821,67 @@ void LLRGNGGraph<T,S>::calculateInsertionQuality (const unsigned int index)
 
 /** \brief calculate insertion criterion for a node
     \param index node index */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::calculateInsertionCriterion (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::calculateInsertionCriterion (const unsigned int index)
 {
-	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->calculateInsertionCriterion();
-	
+	LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (this->_nodes[index]);
+	node->calculateInsertionCriterion();
+	criterion_heap.set (index, node->insertion_criterion);
+}
+
+/** \brief recalculate insertion quality and criterion for a node after its errors changed
+    \param index node index */
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::updateInsertionCriterion (const unsigned int index)
+{
+	calculateInsertionQuality (index);
+	calculateInsertionCriterion (index);
+}
+
+/** \brief find node with maximal value of insertion criterion
+ *
+ *  Nodes without a criterion get one from their current errors first.
+ *  Among nodes with equal criterion the one with the smaller index is returned.
+ *  \return node index or -1 if no node has a positive criterion
+ */
+template<typename T, typename S, typename A>
+int LLRGNGGraph<T,S,A>::maxInsertionCriterionNode ()
+{
+	assert (this->size());
+	if (criterion_heap.size() < this->size())
+		for (unsigned int i=0; i < this->size(); i++)
+			if (!criterion_heap.contains (i))
+				updateInsertionCriterion (i);
+	if (!(criterion_heap.topKey() > 0))
+		return -1;
+	return criterion_heap.top();
+}
+
+/** \brief removes the node from the insertion criterion heap and deletes it
+    \param index of the node that is removed from the graph */
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::deleteNode (const unsigned int& index)
+{
+	criterion_heap.erase (index);
+	GNGModulGraph<T,S,A>::deleteNode (index);
+}
+
+/** \brief changes the index of a moved node in the insertion criterion heap
+    \param from former index of the node
+    \param to new index of the node */
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::moveNode (const unsigned int& from, const unsigned int& to)
+{
+	criterion_heap.move (from, to);
+	GNGModulGraph<T,S,A>::moveNode (from, to);
 }
 
 /** \brief set initial learning rate constants
  *  \param winner initial winner learning rate constant
  *  \param neighbors initial winner-neighbors learning rate constant
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setLearningRates (T winner, T neighbors)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setLearningRates (T winner, T neighbors)
 {
 	winner_learning_rate = winner;
 	neighbors_learning_rate = neighbors;
@@ -756,8 +891,8 @@ void LLRGNGGraph<T,S>::setLearningRates (T winner, T neighbors)
 /** \brief update learning rate for a winner node
  *  \param index node index
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::updateWinnerLearningRate (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::updateWinnerLearningRate (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->updateLearningRate(adaptation_threshold, winner_learning_rate);	
 }
@@ -765,8 +900,8 @@ void LLRGNGGraph<T,S>::updateWinnerLearningRate (const unsigned int index)
 /** \brief update learning rate for a winner-neighboring node
  *  \param index node index
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::updateNeighborLearningRate (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::updateNeighborLearningRate (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->updateLearningRate(adaptation_threshold, neighbors_learning_rate);	
 }
@@ -774,8 +909,8 @@ void LLRGNGGraph<T,S>::updateNeighborLearningRate (const unsigned int index)
 
 /** \brief set adaptation threshold
     \param threshold given adaptation threshold */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setAdaptationThreshold (T threshold)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setAdaptationThreshold (T threshold)
 {
 	adaptation_threshold = threshold;	
 }
@@ -783,47 +918,53 @@ void LLRGNGGraph<T,S>::setAdaptationThreshold (T threshold)
 /* \brief set maximal edge age constant
  * \param age maximal edge age constant
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setMaximalEdgeAge (unsigned int& age)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setMaximalEdgeAge (unsigned int& age)
 {
 	maximal_edge_age = age;
 }
 
 /* \brief get \p maximal_edge_age constant
  */
-template<typename T, typename S>
-unsigned int LLRGNGGraph<T,S>::getMaximalEdgeAge () const
+template<typename T, typename S, typename A>
+unsigned int LLRGNGGraph<T,S,A>::getMaximalEdgeAge () const
 {
 	return maximal_edge_age;
 }
 
 /* \brief decrease age of a node
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::decreaseNodeAge (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::decreaseNodeAge (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->decreaseAge (age_time_window);
 }
 
 /** \brief update items counter for the receptive field of some node
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::increaseItemsCounter (const unsigned int index)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::increaseItemsCounter (const unsigned int index)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->increaseItemsCounter ();
 }
 
 /* \brief delete nodes that are do not have items in their receptive fields
-   \param winner winner node index that needs to be reindexed if necessary
-   \param snd_winner winner node index that needs to be reindexed if necessary
+   \param winner winner node index, it is updated if the node has been moved
+   \param snd_winner second winner node index, it is updated if the node has been moved
+   and set to the graph size if the node has been deleted
  */
-template<typename T, typename S>
-bool LLRGNGGraph<T,S>::deleteInactiveNodes (unsigned int& winner, unsigned int& snd_winner)
+template<typename T, typename S, typename A>
+bool LLRGNGGraph<T,S,A>::deleteInactiveNodes (unsigned int& winner, unsigned int& snd_winner)
 {
 	bool node_deleted = false;
 	if (this->size() <= 2)
 		return false;
 
+	NodeHandle winner_handle = this->getHandle (winner);
+	NodeHandle snd_winner_handle;
+	if (snd_winner < this->size())
+		snd_winner_handle = this->getHandle (snd_winner);
+
 	for (unsigned int i=0; i < this->size(); i++)
 	{
 		if (static_cast<LLRGNGNode<T,S>* > (this->_nodes[i])->items_counter == 0)
@@ -833,24 +974,21 @@ bool LLRGNGGraph<T,S>::deleteInactiveNodes (unsigned int& winner, unsigned int&
 				// std::cout << "deleting node " << i << std::endl;
 				rmNode (i);
 				node_deleted = true;
-				if (winner > i)
-					winner--;
-				if (snd_winner > i)
-					snd_winner--;
-				else if (snd_winner == i)
-					snd_winner = this->size();
+				winner = this->getIndex (winner_handle);
+				// the last node has been moved to i
 				i--;
 			}
 		}
 		
 	}
+	snd_winner = this->isValid (snd_winner_handle) ? this->getIndex (snd_winner_handle) : this->size();
 	return node_deleted;
 }
 
 /* \brief find node with less items in their receptive fields
  */
-template<typename T, typename S>
-int LLRGNGGraph<T,S>::findLessItemsNode ()
+template<typename T, typename S, typename A>
+int LLRGNGGraph<T,S,A>::findLessItemsNode ()
 {
 	unsigned int min_value = static_cast<LLRGNGNode<T,S>* > (this->_nodes[0])->activations_counter;
 	int n = 0;
@@ -869,8 +1007,8 @@ int LLRGNGGraph<T,S>::findLessItemsNode ()
 
 /** \brief reset items counter for all nodes and efficiency contribution to MDL
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::resetMDLCounters ()
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::resetMDLCounters ()
 {
 	model_efficiency = 0;
 	for (unsigned int i=0; i < this->size(); i++)
@@ -878,24 +1016,35 @@ void LLRGNGGraph<T,S>::resetMDLCounters ()
 		LLRGNGNode<T,S>* node = static_cast<LLRGNGNode<T,S>* > (this->_nodes[i]);
 		node->items_counter = 0;
 		node->efficiency = 0;
-		node->data.clear ();
+		node->data.reset ();
 	}
 }
 
 /* \brief get last stored minimal average error for some node
  */
-template<typename T, typename S>
-T LLRGNGGraph<T,S>::getNodeMinLastAvgError (const unsigned int index)
+template<typename T, typename S, typename A>
+T LLRGNGGraph<T,S,A>::getNodeMinLastAvgError (const unsigned int index)
 {
 	return static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->min_last_avgerror;
 }
 
+/* \brief get restricting distances of all nodes ordered by their index, e.g. for a FrozenGraph
+ */
+template<typename T, typename S, typename A>
+std::vector<T> LLRGNGGraph<T,S,A>::getRestrictingDistances () const
+{
+	std::vector<T> distances (this->size());
+	for (unsigned int i = 0; i < this->size(); i++)
+		distances[i] = static_cast<LLRGNGNode<T,S>* > (this->_nodes[i])->restricting_distance;
+	return distances;
+}
+
 /* \brief set last epoch where an error reduction for a node was achieved
    \param index node index
    \param epoch current training epoch
  */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setLastEpochImprovement (const unsigned int index, unsigned int epoch)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setLastEpochImprovement (const unsigned int index, unsigned int epoch)
 {
 	static_cast<LLRGNGNode<T,S>* > (this->_nodes[index])->last_epoch_improvement = epoch;
 }
@@ -903,8 +1052,8 @@ void LLRGNGGraph<T,S>::setLastEpochImprovement (const unsigned int index, unsign
 /** \brief set mean distance calculation mode
     \param mode mean distance calculation mode
 */
-template<typename T, typename S>
-void LLRGNGGraph<T,S>::setMeanDistanceMode (unsigned int mode)
+template<typename T, typename S, typename A>
+void LLRGNGGraph<T,S,A>::setMeanDistanceMode (unsigned int mode)
 {
 	mean_distance_mode = mode;
 	for (unsigned int i=0; i < this->size(); i++)
@@ -914,12 +1063,12 @@ void LLRGNGGraph<T,S>::setMeanDistanceMode (unsigned int mode)
 	}
 }
 
-template<typename T, typename S>
+template<typename T, typename S, typename A>
 template<class Archive>
 void 
-LLRGNGGraph<T,S>::serialize(Archive & ar, const unsigned int /* file_version */) 
+LLRGNGGraph<T,S,A>::serialize(Archive & ar, const unsigned int /* file_version */) 
 {
-	ar & boost::serialization::base_object<Base_Graph<T, S> >(*this);
+	ar & boost::serialization::base_object<Base_Graph<T, S, A> >(*this);
 	ar & BOOST_SERIALIZATION_NVP(adaptation_threshold);
 	ar & BOOST_SERIALIZATION_NVP(winner_learning_rate);
 	ar & BOOST_SERIALIZATION_NVP(neighbors_learning_rate);
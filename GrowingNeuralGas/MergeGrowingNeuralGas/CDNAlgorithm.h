@@ -73,8 +73,8 @@ template<typename T,typename S> void CDNAlgorithm<T,S>::updateNeighbor(const uns
  this->_graphptr->setBirthday(index,time);
 
 
- (*(this->_graphptr))[index].weight  +=  rate *( (*this)[time]-(*(this->_graphptr))[index].weight);
- this->_graphptr->context(index) += rate * ( this->globalContextV - this->_graphptr->context(index));            
+ (*(this->_graphptr))[index].weight.moveToward((*this)[time], rate);
+ this->_graphptr->context(index).moveToward(this->globalContextV, rate);            
 }
 
 /** \brief defines the update rule for the winner
@@ -94,8 +94,8 @@ float rate = this->_graphptr->getTemp(winner) * exp(- float( time - this->_graph
 this->_graphptr->setTemp(winner,rate);
 this->_graphptr->setBirthday(winner,time);
 
-(*(this->_graphptr))[winner].weight  +=  rate *( (*this)[time]-(*(this->_graphptr))[winner].weight);
-this->_graphptr->context(winner) += rate * ( this->globalContextV - this->_graphptr->context(winner));            
+(*(this->_graphptr))[winner].weight.moveToward((*this)[time], rate);
+this->_graphptr->context(winner).moveToward(this->globalContextV, rate);            
 }
 
 } // namespace neuralgas
@@ -38,18 +38,6 @@
 
 namespace neuralgas {
 
-/**  \brief func is the default updating rule for a node's counter
-*
-*    \param n is the node to be updated
-*    \param value is a float value that can be included, default it is params[7] = eta
-*/
-template<typename T,typename S> void updateCounter(Base_Node<T,S>* n,const float& value)
-{
-  MGNGNode<T,S>* temp = dynamic_cast< MGNGNode<T,S>* > (n);
-  temp->setCounter(temp->getCounter() * value);
-}
-
-
 /** \class MGNGAlgorithm
  *  \brief Class implements the algorithm proposed in "Incremental Unsupervised Time Series 
  *   Analysis using Merge Growing Neural Gas" by Andreakis,Hoyningen-Huene and Beets.
@@ -124,7 +112,7 @@ public:
 	void    showGraph(){_graphptr->showGraph();}
 	// stores the graph in myfile , just for internal use
 	void    storeGraph(const unsigned int& );
-	friend class MGNGGraph<T,S>;
+	template<typename,typename,typename> friend class MGNGGraph;
 protected:
 	virtual void updateNeighbor(const unsigned int&,const unsigned int&);
 	virtual void updateWinner(const unsigned int&,const unsigned int&);
@@ -193,6 +181,7 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::setRefVectors(const uns
   this->graphptr      = _graphptr;
   this->_graphModulptr = _graphptr;
   _graphptr->setAlgorithm (this);
+  _graphptr->setTopologicalSearch(this->_topologicalSearch);
 
   // sets the min values for the init of the context vector
   _graphptr->setLowLimits(this->minValues());
@@ -219,8 +208,8 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::setRefVectors(const uns
 */
 template<typename T,typename S> void MGNGAlgorithm<T,S>::updateNeighbor(const unsigned int& time,const unsigned int& index)
 {
- (*_graphptr)[index].weight  += this->params[5] * ( (*this)[time] - (*_graphptr)[index].weight);
- (*_graphptr).context(index) += this->params[5] * (globalContextV - (*_graphptr).context(index));
+ (*_graphptr)[index].weight.moveToward((*this)[time], this->params[5]);
+ (*_graphptr).context(index).moveToward(globalContextV, this->params[5]);
 }
 
 /** \brief defines the update rule for the winner
@@ -234,8 +223,8 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::updateNeighbor(const un
 */
 template<typename T,typename S> void MGNGAlgorithm<T,S>::updateWinner(const unsigned int& time,const unsigned int& winner)
 {
- (*_graphptr)[winner].weight  += this->params[4] * ( (*this)[time]-(*_graphptr)[winner].weight);
- (*_graphptr).context(winner) += this->params[4] * ( globalContextV - (*_graphptr).context(winner));
+ (*_graphptr)[winner].weight.moveToward((*this)[time], this->params[4]);
+ (*_graphptr).context(winner).moveToward(globalContextV, this->params[4]);
 }
 
 
@@ -286,10 +275,9 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::run()
     // line 6
     _graphptr->getWinner(first_winner,second_winner,(*this)[t]);
     // line 7
-    Vector<T> vec = (*_graphptr).context(first_winner);
+    const Vector<T>& vec = (*_graphptr).context(first_winner);
     // C_t = (1 - beta) * w_r +beta * c_r
-    globalContextV=( 1 - this->params[1]) * (*_graphptr)[first_winner].weight;
-    globalContextV+= this->params[1] * vec;
+    linearCombination(&globalContextV[0], 1 - this->params[1], (*_graphptr)[first_winner].weight.data(), this->params[1], &vec[0], this->getDimension());
     // line 10
     _graphptr->incCounter(first_winner);
     // line 11
@@ -326,17 +314,8 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::run()
    
     if(  ((t % (unsigned int)(this->params[8]))== 0) && _graphptr->size() < this->params[6])
     {
-       float max_counter                   = 0.0;
-       int max_counter_index               = 0;
        // line 15a
-       for (unsigned int i=0; i < _graphptr->size(); i++)
-       {
-           if (_graphptr->getCounter(i) > max_counter )
-           {
-            max_counter             = _graphptr->getCounter(i);
-            max_counter_index       = i;
-           }
-       }
+       int max_counter_index               = _graphptr->maxCounterNode();
  
        std::vector<unsigned int> neighbors   = _graphptr->getNeighbors(max_counter_index);
        float max_counter_n                 = 0.0;
@@ -381,8 +360,8 @@ template<typename T,typename S> void MGNGAlgorithm<T,S>::storeGraph(const unsign
  for(unsigned int i=0; i < _graphptr->size(); i++)
  {
 	 myfile << "connex " <<(*_graphptr)[i].num_connections << " ";
-	 for(unsigned int j=0; j < (*_graphptr)[i].edges.size(); j++)
-		 myfile <<(*_graphptr)[i].edges[j] << " ";    
+	 for(unsigned int j=0; j < _graphptr->size(); j++)
+		 myfile << _graphptr->areConnected(i,j) << " ";    
 	 myfile << "counter "<<(*_graphptr).getCounter(i)<<" ";
 	 myfile << "weight ";
 	 for(unsigned int j=0; j < (*_graphptr)[i].weight.size(); j++)
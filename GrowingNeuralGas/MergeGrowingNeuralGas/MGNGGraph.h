@@ -29,7 +29,10 @@
 #define MGNGGRAPH_H
 
 #include <iostream>
+#include <cmath>
+#include <limits>
 #include <GrowingNeuralGas/GNGModulGraph.h>
+#include <Graphs/IndexedMaxHeap.h>
 
 namespace neuralgas {
 
@@ -47,6 +50,9 @@ template<typename T, typename S> class MGNGAlgorithm;
  *   for manipulating the value. 
  *   Furthermore it has a context vector as suggested in the above mentioned paper to reflect
  *   the history and the time series evolution of the node.
+ *   Within a MGNGGraph the counter is stored in the undecayed units of the graph, the
+ *   functions of the graph return the actual value. Functions applied to all nodes
+ *   by applyFunc2AllNodes see the actual value.
  *   \param counter the belief in the node
  *   \param context vector reflecting the time series evolution
  *
@@ -77,6 +83,18 @@ template<typename T,typename S> struct MGNGNode : Base_Node<T,S>
  float getTemp(){return temperature;} 
 };
 
+/**  \brief func is the default updating rule for a node's counter
+*
+*    MGNGGraph::applyFunc2AllNodes recognizes this func and decays the counters lazily.
+*    \param n is the node to be updated
+*    \param value is a float value that can be included, default it is params[7] = eta
+*/
+template<typename T,typename S> void updateCounter(Base_Node<T,S>* n,const float& value)
+{
+  MGNGNode<T,S>* temp = dynamic_cast< MGNGNode<T,S>* > (n);
+  temp->setCounter(temp->getCounter() * value);
+}
+
 /** \class MGNGGraph
  * \brief provides the graph structure for the algorithm proposed in
  *   "Incremental Unsupervised Time Series Analysis using Merge Growing Neural Gas"
@@ -92,14 +110,27 @@ template<typename T,typename S> struct MGNGNode : Base_Node<T,S>
  * The same holds for the edges,where the edge has to be derived from the timed edge TEdge
  * in the TGraph class.
  *
+ * The counters of all nodes are decayed at every learning step by applying updateCounter
+ * to all nodes. As in GNGGraph the decay is applied lazily, the nodes store their counter
+ * divided by _counterScale and only the scale is multiplied by the factor. Other funcs
+ * given to applyFunc2AllNodes are applied after the scale has been folded into the counters.
+ * The nodes whose counter has been changed are kept in a max-heap by their stored counter
+ * such that maxCounterNode is O(1).
+ *
+ * The metric policy M is used for both the weight and the context distance unless a user
+ * defined metric is set, see GNGModulGraph.
+ *
+ * \param _counterScale factor by which the stored counters have to be multiplied
+ * \param _counterHeap indices of the nodes ordered by their stored counter
  */
-template<typename T,typename S> class MGNGGraph : public GNGModulGraph<T,S>
+template<typename T,typename S,typename M = L2Metric<T> > class MGNGGraph : public GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>
 {
+   typedef GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M> ModulGraph;
  public:
-   //cto creating a graph with the same dimension for node and edge weight vectors
-   MGNGGraph(const int& dim) :  Base_Graph<T,S>(dim),UGraph<T,S>(dim),TGraph<T,S>(dim),GNGModulGraph<T,S>(dim){}
+   //cto creating a graph with the given dimension for node weight vectors, the edges only carry their age
+   MGNGGraph(const int& dim) :  Base_Graph<T,S>(dim,0),UGraph<T,S>(dim),TGraph<T,S>(dim),ModulGraph(dim),_counterScale(1){}
    //cto creating a graph with the different dimension for node and edge weight vectors
-   MGNGGraph(const int& dimNode,const int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge),UGraph<T,S>(dimNode,dimEdge),TGraph<T,S>(dimNode,dimEdge){}
+   MGNGGraph(const int& dimNode,const int& dimEdge) : Base_Graph<T,S>(dimNode,dimEdge),UGraph<T,S>(dimNode,dimEdge),TGraph<T,S>(dimNode,dimEdge),_counterScale(1){}
    // std dto
    ~MGNGGraph();
    // sets a new counter value for the given node
@@ -110,6 +141,12 @@ template<typename T,typename S> class MGNGGraph : public GNGModulGraph<T,S>
    void inline incCounter(const int&);
    // gets the counter value for the given node
    float inline getCounter(const int&) const;
+   // multiplies the counters of all nodes by the given factor
+   void inline decayCounters(const float&);
+   // returns the index of the node with the maximal counter
+   unsigned int inline maxCounterNode() const;
+   // applies the given func to all nodes, updateCounter is applied lazily
+   virtual void applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float&);
    // returns a reference to the given context vector
    Vector<T>& context(const int&) const;
    
@@ -129,6 +166,12 @@ template<typename T,typename S> class MGNGGraph : public GNGModulGraph<T,S>
    T getDistance(const Vector<T>&,const unsigned int&) const;
 
 protected:
+   // the distance includes the context, thus the winners are neither looked up in the spatial index nor scanned by the metric policy
+   virtual bool policyDistance() const { return false; }
+   // removes the node from the counter heap and deletes it
+   virtual void deleteNode(const unsigned int&);
+   // changes the index of a moved node in the counter heap
+   virtual void moveNode(const unsigned int&, const unsigned int&);
    // pointer to algorithm
    MGNGAlgorithm<T,S>* algorithm;
 
@@ -136,21 +179,21 @@ protected:
  private:
    // returns a pointer to a edge of a type that is currently used by the graph
    virtual MGNGNode<T,S>*             newNode(void);
+   // folds the given factor and the counter scale into the stored counters
+   void                               renormalizeCounters(const float&);
+   // factor by which the stored counters have to be multiplied
+   float                              _counterScale;
+   // indices of the nodes ordered by their stored counter
+   IndexedMaxHeap<float>              _counterHeap;
 };
 
 
 /** \brief dto Graph deletion
  */
-template<typename T, typename S>
-MGNGGraph<T,S>::~MGNGGraph ()
+template<typename T, typename S, typename M>
+MGNGGraph<T,S,M>::~MGNGGraph ()
 {
-	for (unsigned int i=0; i<this->size(); i++)
-		for (unsigned int j=i+1; j<this->_nodes[i]->edges.size(); j++)
-			if (this->_nodes[i]->edges[j] != NULL)
-				delete this->_nodes[i]->edges[j];
-	
-	for (unsigned int i=0; i<this->size(); i++)
-		this->_nodes[i]->edges.clear();
+	// the edges are deleted by Base_Graph
 }
 
 /** \brief returns a pointer to a node of a type that is currently used by the graph
@@ -165,7 +208,7 @@ MGNGGraph<T,S>::~MGNGGraph ()
 * addNode(),resulting in the use of the used defined node type as node for the graph structure.
 */
 
-template<typename T,typename S> MGNGNode<T,S>* MGNGGraph<T,S>::newNode(void)
+template<typename T,typename S,typename M> MGNGNode<T,S>* MGNGGraph<T,S,M>::newNode(void)
 {
   MGNGNode<T,S>* n = new MGNGNode<T,S>;
   n->temperature=0.0;
@@ -173,7 +216,7 @@ template<typename T,typename S> MGNGNode<T,S>* MGNGGraph<T,S>::newNode(void)
   n->counter=0.0;
   for(unsigned int j = 0; j < this->_dimNode; j++)          
     //n->context[j] = (T)(rand() % this->getMaxRandomValue() ); //sets the value of the weights to random values
-  n->context[j] = (T) ((rand() / (static_cast<T>(RAND_MAX) + 1.0)) * (this->high_limits[j] - this->low_limits[j]) + this->low_limits[j] );
+  n->context[j] = (T) ((rand() / (static_cast<double>(RAND_MAX) + 1.0)) * (this->high_limits[j] - this->low_limits[j]) + this->low_limits[j] );
   
   return n; 
 }
@@ -182,43 +225,137 @@ template<typename T,typename S> MGNGNode<T,S>* MGNGGraph<T,S>::newNode(void)
 * \param index is the index of the node that shall get a new counter value
 * \param newCounter is the value to be set
 */
-template<typename T,typename S> void inline MGNGGraph<T,S>::setCounter(const int& index, const float& newCounter)
+template<typename T,typename S,typename M> void inline MGNGGraph<T,S,M>::setCounter(const int& index, const float& newCounter)
 {
- (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->setCounter(newCounter);
+ (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->setCounter(newCounter / _counterScale);
+ _counterHeap.set(index, newCounter / _counterScale);
 }
 /** \brief gets the counter value for the given node
 *
 * \param index is the index of the node wherefor the counter is desired
 */
  
-template<typename T,typename S> float inline MGNGGraph<T,S>::getCounter(const int& index) const
+template<typename T,typename S,typename M> float inline MGNGGraph<T,S,M>::getCounter(const int& index) const
 { 
-return (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->getCounter();
+return (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->getCounter() * _counterScale;
 }
 /** \brief decreases the counter by one
 *
 * \param index is the index of the node that shall be decreased
 */
  
-template<typename T,typename S> void inline MGNGGraph<T,S>::decCounter(const int& index)
+template<typename T,typename S,typename M> void inline MGNGGraph<T,S,M>::decCounter(const int& index)
 {
-(static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->decCounter();
+MGNGNode<T,S>* node = static_cast< MGNGNode<T,S>* > (this->_nodes[index]);
+node->setCounter(node->getCounter() - 1 / _counterScale);
+_counterHeap.set(index, node->getCounter());
 }
 /** \brief increases the counter by one
 *
 * \param index is the index of the node that shall be increased
 */
  
-template<typename T,typename S> void inline MGNGGraph<T,S>::incCounter(const int& index)
+template<typename T,typename S,typename M> void inline MGNGGraph<T,S,M>::incCounter(const int& index)
 { 
-(static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->incCounter();
+MGNGNode<T,S>* node = static_cast< MGNGNode<T,S>* > (this->_nodes[index]);
+node->setCounter(node->getCounter() + 1 / _counterScale);
+_counterHeap.set(index, node->getCounter());
+}
+
+/** \brief returns the index of the node with the maximal counter
+*
+* Among nodes with equal counters the one with the smaller index is returned. If no
+* node has a positive counter the first node is returned.
+*/
+template<typename T,typename S,typename M> unsigned int inline MGNGGraph<T,S,M>::maxCounterNode() const
+{
+  assert (this->size() > 0);
+  if (_counterHeap.empty() || !(_counterHeap.topKey() > 0))
+    return 0;
+  return _counterHeap.top();
+}
+
+/** \brief removes the node from the counter heap and deletes it
+*
+* \param index of the node that is removed from the graph
+*/
+template<typename T,typename S,typename M> void MGNGGraph<T,S,M>::deleteNode(const unsigned int& index)
+{
+  _counterHeap.erase(index);
+  ModulGraph::deleteNode(index);
+}
+
+/** \brief changes the index of a moved node in the counter heap
+*
+* \param from former index of the node
+* \param to new index of the node
+*/
+template<typename T,typename S,typename M> void MGNGGraph<T,S,M>::moveNode(const unsigned int& from, const unsigned int& to)
+{
+  _counterHeap.move(from, to);
+  ModulGraph::moveNode(from, to);
+}
+
+/** \brief multiplies the counters of all nodes by the given factor
+*
+* Only the counter scale is changed, the nodes are visited when the scale drops below
+* a threshold or the factor is not positive.
+* \param factor by which the counters are multiplied
+*/
+template<typename T,typename S,typename M> void inline MGNGGraph<T,S,M>::decayCounters(const float& factor)
+{
+  // below this scale the stored counters would lose their range
+  const float min_scale = std::sqrt( std::numeric_limits<float>::epsilon() );
+  if (factor > 0 && _counterScale * factor >= min_scale)
+    _counterScale *= factor;
+  else
+    renormalizeCounters(factor);
+}
+
+/** \brief folds the given factor and the counter scale into the stored counters
+*
+* \param factor by which the counters are multiplied
+*/
+template<typename T,typename S,typename M> void MGNGGraph<T,S,M>::renormalizeCounters(const float& factor)
+{
+  float scale = _counterScale * factor;
+  for (unsigned int i = 0; i < this->size(); i++)
+  {
+    MGNGNode<T,S>* node = static_cast< MGNGNode<T,S>* > (this->_nodes[i]);
+    node->setCounter(node->getCounter() * scale);
+  }
+  _counterHeap.scale(scale);
+  _counterScale = 1;
+}
+
+/** \brief applies the given func to all nodes
+*
+* The default counter update updateCounter is turned into an O(1) decay of the counter scale.
+* Before any other func is applied the counter scale is folded into the counters such that
+* the func sees the actual counter values.
+* \param func is a pointer to a function that shall be applied to all nodes
+* \param value is passed to the func
+*/
+template<typename T,typename S,typename M> void MGNGGraph<T,S,M>::applyFunc2AllNodes(void (*func)(Base_Node<T,S>*,const float&),const float& value)
+{
+  if (func == &updateCounter<T,S>)
+    decayCounters(value);
+  else
+  {
+    if (_counterScale != 1)
+      renormalizeCounters(1);
+    Base_Graph<T,S>::applyFunc2AllNodes(func,value);
+    // the func may have changed any counter
+    for (unsigned int i = 0; i < this->size(); i++)
+      _counterHeap.set(i, static_cast< MGNGNode<T,S>* > (this->_nodes[i])->getCounter());
+  }
 }
 /** \brief returns a reference to the given context vector
 *
 * \param index is the index of the node wherefore the context is desired
 */
   
-template<typename T,typename S> Vector<T>& MGNGGraph<T,S>::context(const int& index) const
+template<typename T,typename S,typename M> Vector<T>& MGNGGraph<T,S,M>::context(const int& index) const
 {
 return (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->context;
 }
@@ -231,16 +368,28 @@ return (static_cast< MGNGNode<T,S>* > (this->_nodes[index]))->context;
 *   Currently dist  = (1-a)*metric(x_t,w_j)^2+a*metric(C,c_j)^2 where
 *   x_t is the data vector and w_j the node vector, C the global and c_j the local
 *   context vector where the latter one belongs to w_j.
+*   Without a user defined metric both terms use the metric policy M. Like for euclidean,
+*   contexts of different size, e.g. an empty global context, contribute 0.
 *   
 *   \param item datum
 *   \param node_index is the node where to the distance shall be determined
 */
-template<typename T,typename S> T MGNGGraph<T,S>::getDistance(const Vector<T>& item, const unsigned int& node_index) const
+template<typename T,typename S,typename M> T MGNGGraph<T,S,M>::getDistance(const Vector<T>& item, const unsigned int& node_index) const
 {
     // dist  = (1-a)*metric(x_t,w_j)^2+a*metric(C,c_j)^2
     T distance = (1 - algorithm->params[0]);
+    const Vector<T>& local_context = context(node_index);
+    if (this->_metric_to_use == NULL)
+    {
+     // the metric policy is called directly on the weight row and the contexts
+     assert (local_context.size() == algorithm->globalContextV.size());
+     distance*=pow(this->_metricPolicy( &item[0], this->_weights.row(node_index), this->_dimNode),2);
+     if (local_context.size() == algorithm->globalContextV.size() && !local_context.empty())
+      distance+=algorithm->params[0]*pow(this->_metricPolicy( &algorithm->globalContextV[0], &local_context[0], local_context.size()) ,2);
+     return distance;
+    }
     distance*=pow(this->metric( item, this->_nodes[node_index]->weight),2);
-    distance+=algorithm->params[0]*pow(this->metric(algorithm->globalContextV,context(node_index)) ,2);
+    distance+=algorithm->params[0]*pow(this->metric(algorithm->globalContextV,local_context) ,2);
 
     return distance;
 }
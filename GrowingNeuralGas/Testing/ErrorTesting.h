@@ -43,15 +43,19 @@ namespace neuralgas {
  *   or by a number of randomly chosen data vectors.
  *   As error metric the distance used within the GNG object is used as default. But it is
  *   also possible to define an own error metric and set it by the func setErrorMetric.
+ *   The metric policy M (see L2Metric) is the compile-time alternative: if the graph of the
+ *   GNG object uses the same policy its distance and winner search are used, otherwise the
+ *   policy is computed directly on the rows of the weight matrix of the graph.
  *
  * \param _gngptr ptr to the given GNG object
  * \param _pastTimeSteps defines the number of data items that shall be used, correspoding to the number of returned error points
  * \param _random bool that says whether the data items are selected randomly, default is false
  * \param _errors a vector containing the number of errors
  * \param _error_metric_to_use is the user defined error metric,as default the metric of the given derived GNGModul object is used
+ * \param _metricPolicy metric policy used as error metric if no user defined error metric is set
  *
  */   
-template < typename T, typename S > class ErrorTesting
+template < typename T, typename S, typename M = L2Metric<T> > class ErrorTesting
 {
  public:
     ErrorTesting();
@@ -66,6 +70,8 @@ template < typename T, typename S > class ErrorTesting
     std::vector<T>  getErrors(const unsigned int &,const bool&);
     //sets a user defined metric, used for error measuring 
     inline void     setErrorMetric(T (*)(const Vector<T>& a,const Vector<T>& b));  
+    //sets the metric policy, used for error measuring if no user defined metric is set
+    inline void     setMetricPolicy(const M& policy) { _metricPolicy = policy; }
             
  private:
     // returns the distance of the node and the datum vector
@@ -76,6 +82,8 @@ template < typename T, typename S > class ErrorTesting
     const unsigned int       getRandomIndex() const;
     // returns the shortest distance for a given datum
     const T         getShortestDistance(const unsigned int&);
+    // returns the graph if it uses the metric policy M
+    const GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>* policyGraph() const;
     // calculates the errors 
     void            calcErrors();
     // sets the number of data items that shall be used
@@ -90,11 +98,13 @@ template < typename T, typename S > class ErrorTesting
     std::vector<T>   _errors;
     // is the user defined error metric
     T               (*_error_metric_to_use)(const Vector<T>&,const Vector<T>&); 
+    // metric policy used if no user defined error metric is set
+    M                _metricPolicy;
 
 };
 
 
-template < typename T, typename S > ErrorTesting<T,S>::ErrorTesting()
+template < typename T, typename S, typename M > ErrorTesting<T,S,M>::ErrorTesting()
 {
  _gngptr              = NULL;
  _pastTimeSteps       = 1;
@@ -108,7 +118,7 @@ template < typename T, typename S > ErrorTesting<T,S>::ErrorTesting()
 ]*
 *   \param gngptr a ptr to a GNGModul or a thereof derived class for which the error shall be computed
 */
-template < typename T, typename S > ErrorTesting<T,S>::ErrorTesting(GNGModul<T,S>* gngptr)
+template < typename T, typename S, typename M > ErrorTesting<T,S,M>::ErrorTesting(GNGModul<T,S>* gngptr)
 {
  _gngptr              = gngptr;
  _pastTimeSteps       = 1;
@@ -119,14 +129,14 @@ template < typename T, typename S > ErrorTesting<T,S>::ErrorTesting(GNGModul<T,S
 
 /** \brief std dto
 */
-template < typename T, typename S > ErrorTesting<T,S>::~ErrorTesting()
+template < typename T, typename S, typename M > ErrorTesting<T,S,M>::~ErrorTesting()
 {_gngptr  = NULL;}
 
 //! \brief set the GNG object (algorithm) pointer to be tested
 /*! 
   \param gngptr 
 */
-template < typename T, typename S > void ErrorTesting<T,S>::setGNGObject(GNGModul<T,S>* gngptr)
+template < typename T, typename S, typename M > void ErrorTesting<T,S,M>::setGNGObject(GNGModul<T,S>* gngptr)
 { _gngptr              = gngptr;}
 
 /* \brief Sets the number of data items that shall be used
@@ -137,7 +147,7 @@ template < typename T, typename S > void ErrorTesting<T,S>::setGNGObject(GNGModu
 *
 *  \param pastTimeSteps
 */
-template < typename T, typename S > void ErrorTesting<T,S>::setPastTimeSteps(const unsigned int& pastTimeSteps)
+template < typename T, typename S, typename M > void ErrorTesting<T,S,M>::setPastTimeSteps(const unsigned int& pastTimeSteps)
 {        
  if( pastTimeSteps <= _gngptr->size() ) //check whether the desired number of steps is larger than the available data
   _pastTimeSteps = pastTimeSteps;
@@ -147,7 +157,7 @@ template < typename T, typename S > void ErrorTesting<T,S>::setPastTimeSteps(con
 
 /** \brief sets whether to choose the data randomly, default is false
 */ 
-template < typename T, typename S > void ErrorTesting<T,S>::chooseRandomly(const bool& random)
+template < typename T, typename S, typename M > void ErrorTesting<T,S,M>::chooseRandomly(const bool& random)
 {_random=random;}
 
 /** \brief returns the errors for given number of data items that are either selected at random or not
@@ -156,7 +166,7 @@ template < typename T, typename S > void ErrorTesting<T,S>::chooseRandomly(const
 * \param steps number of data items that shall be taken to compute the error
 * \param random determines whether the data is taken randomly or whether the last number of data items is used
 */
-template < typename T, typename S > std::vector<T> ErrorTesting<T,S>::getErrors(const unsigned int& steps,const bool& random=false) 
+template < typename T, typename S, typename M > std::vector<T> ErrorTesting<T,S,M>::getErrors(const unsigned int& steps,const bool& random=false) 
 {
  chooseRandomly(random);
  setPastTimeSteps(steps);
@@ -178,21 +188,25 @@ template < typename T, typename S > std::vector<T> ErrorTesting<T,S>::getErrors(
 * metric is going to be used.
 * \param *errormetric_to_use is function ptr to an user defined metric
 */
-template < typename T, typename S > inline void ErrorTesting<T,S>::setErrorMetric(T (*error_metric_to_use)(const Vector<T>& a,const Vector<T>& b)=NULL )
+template < typename T, typename S, typename M > inline void ErrorTesting<T,S,M>::setErrorMetric(T (*error_metric_to_use)(const Vector<T>& a,const Vector<T>& b)=NULL )
 {_error_metric_to_use=error_metric_to_use;}  
 
 // returns the distance of the node and the item vector
-template<typename T,typename S> T ErrorTesting<T,S>::getErrorDistance(const unsigned int& node_index, const unsigned int& item_index)
+template<typename T,typename S,typename M> T ErrorTesting<T,S,M>::getErrorDistance(const unsigned int& node_index, const unsigned int& item_index)
 {
      return _error_metric_to_use( (*_gngptr)[item_index], _gngptr->graphptr->operator[](node_index).weight);
 }
 
 // returns a random index within the range of the data size
-template < typename T, typename S > const unsigned int ErrorTesting<T,S>::getRandomIndex() const 
+template < typename T, typename S, typename M > const unsigned int ErrorTesting<T,S,M>::getRandomIndex() const 
 {return (rand() % _gngptr->size()); }
 
+// returns the graph if it uses the metric policy M, otherwise NULL
+template < typename T, typename S, typename M > const GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>* ErrorTesting<T,S,M>::policyGraph() const
+{return dynamic_cast<const GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>* >(_gngptr->graphptr); }
+
 // returns the shortest distance for a given datum
-template < typename T, typename S > const T ErrorTesting<T,S>::getShortestDistance(const unsigned int& index)
+template < typename T, typename S, typename M > const T ErrorTesting<T,S,M>::getShortestDistance(const unsigned int& index)
 {
     // init with zero
    T distance      = _gngptr->_zero;
@@ -201,11 +215,35 @@ template < typename T, typename S > const T ErrorTesting<T,S>::getShortestDistan
    // best_distance set to "infinity"
    best_distance = std::numeric_limits<T>::max();
 
-   if (_error_metric_to_use == NULL)
+   if (_error_metric_to_use == NULL && policyGraph() == NULL)
    {
-       for (unsigned int j = 0; j < _gngptr->graphptr->size(); j++)
+       // the metric policy is computed along the rows of the weight matrix
+       const WeightMatrix<T>& weights = _gngptr->graphptr->weights();
+       const Vector<T>& item = (*_gngptr)[index];
+       for (unsigned int j = 0; j < weights.rows(); j++)
        {
-	distance = dynamic_cast<GNGModulGraph<T,S>* >(_gngptr->graphptr)->getDistance((*_gngptr)[index],j);
+        distance = _metricPolicy(&item[0], weights.row(j), weights.dim());
+    
+        if (distance < best_distance)
+        {
+         best_distance              =       distance;
+        }       
+       }
+   }
+   else if (_error_metric_to_use == NULL)
+   {
+       const GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>* graph = policyGraph();
+       const Vector<T>& item = (*_gngptr)[index];
+       // the distances of the nodes are abandoned as soon as they exceed the closest one
+       if (graph->indexableDistance() && graph->_partialDistance.enabled())
+       {
+        unsigned int first_winner, second_winner;
+        return graph->_partialDistance.getWinner(first_winner, second_winner, &item[0], graph->weights());
+       }
+       // the distances are computed along the rows of the weight matrix
+       for (unsigned int j = 0; j < graph->size(); j++)
+       {
+	distance = graph->getDistance(item,j);
     
         if (distance < best_distance)
         {
@@ -227,21 +265,38 @@ template < typename T, typename S > const T ErrorTesting<T,S>::getShortestDistan
    }
    return best_distance;
 }
-   // calculates the errors 
-
-template < typename T, typename S > void ErrorTesting<T,S>::calcErrors()
+// calculates the errors, with the metric of a graph using the policy all items are assigned at once by assignBatch
+template < typename T, typename S, typename M > void ErrorTesting<T,S,M>::calcErrors()
 {
+ std::vector<unsigned int> indices(_pastTimeSteps);
  _errors.resize(_pastTimeSteps);
 
  if (_random)
  {
   for(unsigned int i = 0; i < _pastTimeSteps; i++)
-          _errors[i]=getShortestDistance(getRandomIndex());         
+          indices[i]=getRandomIndex();
+ }
+ else
+ {
+  for(unsigned int i = 0; i < _pastTimeSteps; i++)
+          indices[i]=_gngptr->size() - _pastTimeSteps + i;
+ }
+
+ const GNGModulGraph<T,S,SparseAdjacency< Base_Edge<S,T> >,M>* graph = policyGraph();
+ if (_error_metric_to_use == NULL && graph != NULL && graph->size() >= 2)
+ {
+  std::vector<const Vector<T>*> items(_pastTimeSteps);
+  std::vector< Assignment<T> > winners;
+  for(unsigned int i = 0; i < _pastTimeSteps; i++)
+          items[i]=&(*_gngptr)[indices[i]];
+  graph->assignBatch(items, winners);
+  for(unsigned int i = 0; i < _pastTimeSteps; i++)
+          _errors[i]=winners[i].first_distance;
  }
  else
  {
   for(unsigned int i = 0; i < _pastTimeSteps; i++)
-          _errors[i]=getShortestDistance(_gngptr->size() - _pastTimeSteps + i);         
+          _errors[i]=getShortestDistance(indices[i]);         
  }
 }
 
@@ -0,0 +1,120 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include <iostream>
+#include <tools/metrics.h>
+#include <tools/distanceKernels.h>
+
+using namespace std;
+using namespace neuralgas;
+
+/** \brief returns the seconds of cpu time elapsed since the given clock value
+*/
+double seconds(const clock_t& start)
+{return double(clock() - start) / CLOCKS_PER_SEC;}
+
+/** \brief determines the two winners by computing euclidean for every row, like the scan of the graphs
+*/
+template<typename T> T scanWinners(const T* x, const WeightMatrix<T>& weights, unsigned int& first, unsigned int& second)
+{
+    T best = std::numeric_limits<T>::max();
+    first  = 1;
+    second = 0;
+    for (unsigned int j = 0; j < weights.rows(); j++)
+    {
+        T distance = euclidean<T> (x, weights.row(j), weights.dim());
+        if (distance < best)
+        {
+            second = first;
+            first  = j;
+            best   = distance;
+        }
+    }
+    return best;
+}
+
+/** \brief times the scan and the kernels of all supported instruction sets for the given type
+*
+* \return number of queries for which a kernel differs from the scan
+*/
+template<typename T> unsigned int benchmark(const char* type, const unsigned int& num_nodes, const unsigned int& dim, const unsigned int& num_queries)
+{
+    WeightMatrix<T> weights;
+    weights.setDim(dim);
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        weights.addRow();
+        for (unsigned int k = 0; k < dim; k++)
+            weights.row(i)[k] = T(2.0 * rand() / RAND_MAX - 1.0);
+    }
+    std::vector<T> items(num_queries * dim);
+    for (unsigned int q = 0; q < items.size(); q++)
+        items[q] = T(2.0 * rand() / RAND_MAX - 1.0);
+
+    std::vector<unsigned int> winners(2 * num_queries);
+    std::vector<T> distances(num_queries);
+    clock_t start = clock();
+    for (unsigned int q = 0; q < num_queries; q++)
+        distances[q] = scanWinners<T> (&items[q * dim], weights, winners[2 * q], winners[2 * q + 1]);
+    double scan_time = seconds(start);
+    cout << type << " euclidean scan  " << num_queries / scan_time << " queries/s" << endl;
+
+    const SimdLevel detected = simdLevel();
+    const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+    unsigned int mismatches = 0;
+    for (int level = scalar; level <= detected; level++)
+    {
+        simdLevel() = SimdLevel(level);
+        unsigned int first, second;
+        start = clock();
+        for (unsigned int q = 0; q < num_queries; q++)
+        {
+            T distance = nearestTwo<T> (&items[q * dim], weights, first, second);
+            if (winners[2 * q] != first || winners[2 * q + 1] != second || distances[q] != distance)
+                mismatches++;
+        }
+        double kernel_time = seconds(start);
+        cout << type << " nearestTwo " << names[level] << " " << num_queries / kernel_time << " queries/s, speedup "
+             << scan_time / kernel_time << endl;
+    }
+    simdLevel() = detected;
+    return mismatches;
+}
+
+/** \brief Compares the vectorized distance kernels with the scan computing euclidean for every node
+*
+*  usage: DistanceBenchmark [nodes] [dim] [queries]
+*  A weight matrix with random rows is queried with random items by the scan and by
+*  nearestTwo using every instruction set the cpu supports, for float and double.
+*  The throughput is printed and the winners and distances have to agree.
+*/
+int main(int argc, char *argv[])
+{
+    unsigned int num_nodes   = (argc > 1) ? atoi(argv[1]) : 1000;
+    unsigned int dim         = (argc > 2) ? atoi(argv[2]) : 16;
+    unsigned int num_queries = (argc > 3) ? atoi(argv[3]) : 10000;
+    srand(1);
+
+    unsigned int mismatches = benchmark<float>("float ", num_nodes, dim, num_queries);
+    mismatches += benchmark<double>("double", num_nodes, dim, num_queries);
+    cout << "mismatches " << mismatches << endl;
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
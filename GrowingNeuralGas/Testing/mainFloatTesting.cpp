@@ -0,0 +1,232 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <GrowingNeuralGas/GNGAlgorithm.h>
+#include <GrowingNeuralGas/ErrorBasedGNGAlgorithm/EBGNGAlgorithm.h>
+#include <GrowingNeuralGas/MergeGrowingNeuralGas/MGNGAlgorithm.h>
+#include <GrowingNeuralGas/LifelongRobustGNGAlgorithm/LLRGNGAlgorithm.h>
+#include "ErrorTesting.h"
+
+using namespace std;
+using namespace neuralgas;
+
+// parameters of GNG and EBGNG, see GNGAlgorithm::learning_loop
+template<typename T> T alpha(const unsigned int&) {return 0.5;}
+template<typename T> T beta(const unsigned int&) {return 0.995;}
+template<typename T> T maxDistortion(const unsigned int&) {return 1e10;}
+template<typename T> T maxAge(const unsigned int&) {return 50;}
+template<typename T> T epsilonB(const unsigned int&) {return 0.05;}
+template<typename T> T epsilonN(const unsigned int&) {return 0.0006;}
+template<typename T> T lambda(const unsigned int&) {return 100;}
+template<typename T> T maxNodes(const unsigned int&) {return 20;}
+// parameters of MGNG differing from the ones above, see MGNGAlgorithm::learning_loop
+template<typename T> T contextWeight(const unsigned int&) {return 0.5;}
+template<typename T> T counterDecay(const unsigned int&) {return 0.995;}
+
+// settings of the winner search, see GNGModul
+template<typename T> void plainSearch(GNGModul<T,int>*) {}
+template<typename T> void kdTreeSearch(GNGModul<T,int>* algorithm) {algorithm->setWinnerIndex(SpatialIndex<T>::KDTREE);}
+template<typename T> void triangleBoundsSearch(GNGModul<T,int>* algorithm) {algorithm->setTriangleBounds(true);}
+
+/** \brief returns the mean of the errors of the trained algorithm over the whole data set
+*/
+template<typename T> double meanError(GNGModul<T,int>* algorithm, const unsigned int& size)
+{
+    ErrorTesting<T,int> et(algorithm);
+    std::vector<T> errors = et.getErrors(size);
+    double total_error = 0.0;
+    for (unsigned int i = 0; i < errors.size(); i++)
+        total_error += errors[i];
+    return total_error / errors.size();
+}
+
+/** \brief trains the algorithm with the data set converted to T and returns its mean error
+*
+* The data set is sampled sequentially for a fixed number of epochs, thus the float and
+* the double run see the same items in the same order starting from the same weights.
+* \param search sets the winner search of the algorithm
+* \param search_later whether the search is set on the created graph instead of before setRefVectors
+*/
+template<typename T> double train(const char* name, const std::vector< Vector<double>* >& items, const unsigned int& dim,
+                                  void (*search)(GNGModul<T,int>*) = plainSearch<T>, const bool& search_later = false)
+{
+    std::vector< Vector<T>* >* data = new std::vector< Vector<T>* >(items.size());
+    for (unsigned int t = 0; t < items.size(); t++)
+    {
+        (*data)[t] = new Vector<T>(dim);
+        for (unsigned int k = 0; k < dim; k++)
+            (*(*data)[t])[k] = T((*items[t])[k]);
+    }
+
+    GNGModul<T,int>* algorithm = NULL;
+    std::string algorithm_name(name);
+    if (algorithm_name == "GNG" || algorithm_name == "EBGNG")
+    {
+        if (algorithm_name == "GNG")
+            algorithm = new GNGAlgorithm<T,int>(dim);
+        else
+        {
+            EBGNGAlgorithm<T,int>* eb = new EBGNGAlgorithm<T,int>(dim);
+            eb->setErrorThreshold(0.01);
+            algorithm = eb;
+        }
+        algorithm->setFuncArray(alpha<T>,0);
+        algorithm->setFuncArray(beta<T>,1);
+        algorithm->setFuncArray(maxDistortion<T>,2);
+        algorithm->setFuncArray(maxAge<T>,3);
+        algorithm->setFuncArray(epsilonB<T>,4);
+        algorithm->setFuncArray(epsilonN<T>,5);
+        algorithm->setFuncArray(lambda<T>,6);
+        algorithm->setFuncArray(maxNodes<T>,7);
+        algorithm->setFuncArray(lambda<T>,8);
+    }
+    else if (algorithm_name == "MGNG")
+    {
+        algorithm = new MGNGAlgorithm<T,int>(dim);
+        algorithm->setFuncArray(contextWeight<T>,0);
+        algorithm->setFuncArray(contextWeight<T>,1);
+        algorithm->setFuncArray(maxAge<T>,2);
+        algorithm->setFuncArray(alpha<T>,3);
+        algorithm->setFuncArray(epsilonB<T>,4);
+        algorithm->setFuncArray(epsilonN<T>,5);
+        algorithm->setFuncArray(maxNodes<T>,6);
+        algorithm->setFuncArray(counterDecay<T>,7);
+        algorithm->setFuncArray(lambda<T>,8);
+    }
+    else
+    {
+        LLRGNGAlgorithm<T,int>* llrgng = new LLRGNGAlgorithm<T,int>(dim);
+        llrgng->setTimeWindows(50, 30, items.size());
+        llrgng->setLearningRates(0.3, 0.001);
+        llrgng->setInsertionRate(items.size());
+        llrgng->setAdaptationThreshold(0.0);
+        llrgng->setMaximalEdgeAge(50);
+        llrgng->setDataAccuracy(0.001);
+        llrgng->setMaxNodes(20);
+        algorithm = llrgng;
+    }
+
+    if (!search_later)
+        search(algorithm);
+    algorithm->setData(data);
+    srand(3);
+    algorithm->setRefVectors(2);
+    if (algorithm_name != "LLRGNG")
+    {
+        // these build their graph in setRefVectors, which seeds rand with the time,
+        // thus both runs start with the first two items as weights
+        srand(3);
+        std::vector< Base_Node<T,int>*, boost::pool_allocator< Base_Node<T,int>* > > nodes(2);
+        for (unsigned int i = 0; i < nodes.size(); i++)
+        {
+            nodes[i] = new Base_Node<T,int>;
+            nodes[i]->weight = *(*data)[i];
+        }
+        algorithm->setNodes(&nodes);
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            delete nodes[i];
+    }
+    if (search_later)
+        search(algorithm);
+    algorithm->setSamplingMode(sequential);
+    algorithm->setStoppingCriterion(epochs);
+    algorithm->setMaxEpochs(10);
+    algorithm->run();
+    double error = meanError(algorithm, items.size());
+
+    delete algorithm;
+    for (unsigned int t = 0; t < data->size(); t++)
+        delete (*data)[t];
+    delete data;
+    return error;
+}
+
+/** \brief compares the mean errors of the float and the double instantiation of an algorithm
+*
+* \return true if the relative difference of the mean errors is within the tolerance
+*/
+bool compare(const char* name, const std::vector< Vector<double>* >& items, const unsigned int& dim, const double& tolerance)
+{
+    double error_double = train<double>(name, items, dim);
+    double error_float  = train<float>(name, items, dim);
+    double difference   = fabs(error_float - error_double) / error_double;
+    bool equivalent     = difference <= tolerance;
+    cout << name << " mean error double " << error_double << ", float " << error_float
+         << ", relative difference " << difference << (equivalent ? "" : " FAILED") << endl;
+    return equivalent;
+}
+
+/** \brief compares the mean errors of an algorithm trained with the plain and with another winner search
+*
+* The search is set once before the graph is created and once on the created graph.
+* \return true if the mean errors are identical, i.e. the search found the same winners
+*/
+bool compareSearch(const char* name, const char* search_name, void (*search)(GNGModul<double,int>*),
+                   const std::vector< Vector<double>* >& items, const unsigned int& dim)
+{
+    double error_plain  = train<double>(name, items, dim);
+    double error_search = train<double>(name, items, dim, search);
+    double error_later  = train<double>(name, items, dim, search, true);
+    bool identical      = error_plain == error_search && error_plain == error_later;
+    cout << name << " mean error plain search " << error_plain << ", " << search_name << " " << error_search
+         << ", " << search_name << " set later " << error_later << (identical ? "" : " FAILED") << endl;
+    return identical;
+}
+
+/** \brief Compares the quality of the float and the double instantiations of the algorithms
+*
+*  usage: FloatTesting [items] [dim] [tolerance]
+*  The items are drawn around a few random centers. Every algorithm is trained once with
+*  float and once with double weights and data, the mean errors of the data items have to
+*  agree up to the relative tolerance. Afterwards the exact winner searches are checked to
+*  give identical mean errors as the plain search.
+*/
+int main(int argc, char *argv[])
+{
+    unsigned int num_items = (argc > 1) ? atoi(argv[1]) : 1000;
+    unsigned int dim       = (argc > 2) ? atoi(argv[2]) : 2;
+    double tolerance       = (argc > 3) ? atof(argv[3]) : 0.01;
+    const unsigned int num_centers = 5;
+    srand(1);
+
+    std::vector< Vector<double> > centers(num_centers, Vector<double>(dim));
+    for (unsigned int c = 0; c < num_centers; c++)
+        for (unsigned int k = 0; k < dim; k++)
+            centers[c][k] = double(rand()) / RAND_MAX;
+    std::vector< Vector<double>* > items(num_items);
+    for (unsigned int t = 0; t < num_items; t++)
+    {
+        items[t] = new Vector<double>(centers[rand() % num_centers]);
+        for (unsigned int k = 0; k < dim; k++)
+            (*items[t])[k] += 0.1 * (double(rand()) / RAND_MAX - 0.5);
+    }
+
+    bool equivalent = true;
+    equivalent &= compare("GNG", items, dim, tolerance);
+    equivalent &= compare("EBGNG", items, dim, tolerance);
+    equivalent &= compare("MGNG", items, dim, tolerance);
+    equivalent &= compare("LLRGNG", items, dim, tolerance);
+    equivalent &= compareSearch("EBGNG", "kd-tree", kdTreeSearch<double>, items, dim);
+    equivalent &= compareSearch("EBGNG", "triangle bounds", triangleBoundsSearch<double>, items, dim);
+
+    for (unsigned int t = 0; t < num_items; t++)
+        delete items[t];
+    return equivalent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,128 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <GrowingNeuralGas/GNGModulGraph.h>
+
+using namespace std;
+using namespace neuralgas;
+
+typedef SparseAdjacency< Base_Edge<int,double> > Adjacency;
+
+/** \brief returns the seconds of cpu time elapsed since the given clock value
+*/
+double seconds(const clock_t& start)
+{return double(clock() - start) / CLOCKS_PER_SEC;}
+
+/** \class RuntimeMetricGraph
+*   \brief graph computing the policy P as user defined metric set by setMetric,
+*   i.e. through the pointer to the virtual member function metric like before the metric policies
+*/
+template<typename P> class RuntimeMetricGraph : public GNGModulGraph<double,int>
+{
+public:
+    RuntimeMetricGraph(const unsigned int& dim, const P& policy) : Base_Graph<double,int>(dim,0),UGraph<double,int>(dim),TGraph<double,int>(dim),GNGModulGraph<double,int>(dim),_policy(policy)
+    { this->setMetric(&Base_Graph<double,int>::metric); }
+    virtual double metric(const Vector<double>& x, const Vector<double>& y) const
+    { return _policy(&x[0], &y[0], x.size()); }
+private:
+    P _policy;
+};
+
+/** \brief times the winner search with the policy as user defined metric and as metric policy
+*
+* \return number of queries for which the winners or distances differ
+*/
+template<typename P> unsigned int benchmark(const char* name, const P& policy, const unsigned int& num_nodes,
+                                            const unsigned int& dim, const std::vector< Vector<double> >& items)
+{
+    RuntimeMetricGraph<P> runtime(dim, policy);
+    GNGModulGraph<double,int,Adjacency,P> devirtualized(dim);
+    devirtualized.setMetricPolicy(policy);
+    // both graphs get the same random weights
+    runtime.setLowLimits(Vector<double>(dim, -1.0));
+    runtime.setHighLimits(Vector<double>(dim, 1.0));
+    srand(2);
+    runtime.initRandomGraph(num_nodes);
+    devirtualized.setLowLimits(Vector<double>(dim, -1.0));
+    devirtualized.setHighLimits(Vector<double>(dim, 1.0));
+    srand(2);
+    devirtualized.initRandomGraph(num_nodes);
+
+    std::vector<unsigned int> winners(2 * items.size());
+    std::vector<double> distances(items.size());
+    unsigned int first, second;
+    clock_t start = clock();
+    for (unsigned int q = 0; q < items.size(); q++)
+    {
+        distances[q]       = runtime.getWinner(first, second, items[q]);
+        winners[2 * q]     = first;
+        winners[2 * q + 1] = second;
+    }
+    double runtime_time = seconds(start);
+
+    unsigned int mismatches = 0;
+    start = clock();
+    for (unsigned int q = 0; q < items.size(); q++)
+    {
+        double distance = devirtualized.getWinner(first, second, items[q]);
+        if (winners[2 * q] != first || winners[2 * q + 1] != second || distances[q] != distance)
+            mismatches++;
+    }
+    double policy_time = seconds(start);
+
+    cout << name << " setMetric " << items.size() / runtime_time << " queries/s, policy "
+         << items.size() / policy_time << " queries/s, speedup " << runtime_time / policy_time << endl;
+    return mismatches;
+}
+
+/** \brief Compares the winner search with a user defined metric and with a metric policy
+*
+*  usage: MetricBenchmark [nodes] [dim] [queries]
+*  For every metric policy a graph computing it as user defined metric through setMetric
+*  and a graph instantiated with the policy get the same random weights and are queried
+*  with the same random items. The throughput is printed and the winners and distances
+*  have to agree.
+*/
+int main(int argc, char *argv[])
+{
+    unsigned int num_nodes   = (argc > 1) ? atoi(argv[1]) : 1000;
+    unsigned int dim         = (argc > 2) ? atoi(argv[2]) : 16;
+    unsigned int num_queries = (argc > 3) ? atoi(argv[3]) : 10000;
+    srand(1);
+
+    std::vector< Vector<double> > items(num_queries, Vector<double>(dim));
+    for (unsigned int q = 0; q < num_queries; q++)
+        for (unsigned int k = 0; k < dim; k++)
+            items[q][k] = 2.0 * rand() / RAND_MAX - 1.0;
+    Vector<double> variances(dim);
+    for (unsigned int k = 0; k < dim; k++)
+        variances[k] = 0.5 + double(rand()) / RAND_MAX;
+
+    unsigned int mismatches = 0;
+    mismatches += benchmark("L2         ", L2Metric<double>(), num_nodes, dim, items);
+    mismatches += benchmark("squared L2 ", SquaredL2Metric<double>(), num_nodes, dim, items);
+    mismatches += benchmark("L1         ", L1Metric<double>(), num_nodes, dim, items);
+    mismatches += benchmark("Linf       ", LInfMetric<double>(), num_nodes, dim, items);
+    mismatches += benchmark("cosine     ", CosineMetric<double>(), num_nodes, dim, items);
+    mismatches += benchmark("mahalanobis", DiagonalMahalanobisMetric<double>(variances), num_nodes, dim, items);
+    cout << "mismatches " << mismatches << endl;
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,150 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <GrowingNeuralGas/GNGGraph.h>
+#include <Graphs/FrozenGraph.h>
+
+using namespace std;
+using namespace neuralgas;
+
+/** \brief returns the seconds of cpu time elapsed since the given clock value
+*/
+double seconds(const clock_t& start)
+{return double(clock() - start) / CLOCKS_PER_SEC;}
+
+/** \brief Queries the graph with all items and counts the results differing from the given ones
+*/
+unsigned int countMismatches(const GNGGraph<double,int>& graph, const std::vector< Vector<double> >& items,
+                             const std::vector<unsigned int>& winners, const std::vector<double>& distances)
+{
+    unsigned int mismatches = 0;
+    unsigned int first, second;
+    for (unsigned int q = 0; q < items.size(); q++)
+    {
+        double distance = graph.getWinner(first, second, items[q]);
+        if (winners[2 * q] != first || winners[2 * q + 1] != second || distances[q] != distance)
+            mismatches++;
+    }
+    return mismatches;
+}
+
+/** \brief Compares the winner search of a trained graph with the one of its frozen snapshot
+*   and with the spatial indices
+*
+*  usage: WinnerBenchmark [nodes] [dim] [queries]
+*  A GNGGraph with random weights and edges is created, frozen and both are queried
+*  with the same random items, afterwards the graph is queried using a kd-tree, a ball
+*  tree and the automatic choice of the index. The throughput of all winner searches is printed and the winners and their
+*  distances have to agree. Finally the approximate quantized prefilter is queried.
+*/
+int main(int argc, char *argv[])
+{
+    unsigned int num_nodes   = (argc > 1) ? atoi(argv[1]) : 1000;
+    unsigned int dim         = (argc > 2) ? atoi(argv[2]) : 16;
+    unsigned int num_queries = (argc > 3) ? atoi(argv[3]) : 10000;
+    srand(1);
+
+    GNGGraph<double,int> graph(dim);
+    graph.setLowLimits(Vector<double>(dim, -1.0));
+    graph.setHighLimits(Vector<double>(dim, 1.0));
+    graph.initRandomGraph(num_nodes);
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        graph.setError(i, double(rand()) / RAND_MAX);
+        for (unsigned int k = 0; k < 3; k++)
+        {
+            unsigned int j = rand() % num_nodes;
+            if (j != i)
+                graph.setAge(i, j, rand() % 100);
+        }
+    }
+
+    clock_t start = clock();
+    std::vector<double> errors = graph.getErrors();
+    FrozenGraph<double> frozen(graph, &errors);
+    double build_time = seconds(start);
+    cout << "frozen " << frozen.size() << " nodes, " << frozen.numEntries() << " adjacency entries in "
+         << build_time << " s" << endl;
+
+    std::vector< Vector<double> > items(num_queries, Vector<double>(dim));
+    for (unsigned int q = 0; q < num_queries; q++)
+        for (unsigned int k = 0; k < dim; k++)
+            items[q][k] = 2.0 * rand() / RAND_MAX - 1.0;
+
+    std::vector<unsigned int> winners(2 * num_queries);
+    std::vector<double> distances(num_queries);
+    unsigned int first, second;
+    start = clock();
+    for (unsigned int q = 0; q < num_queries; q++)
+    {
+        distances[q]       = graph.getWinner(first, second, items[q]);
+        winners[2 * q]     = first;
+        winners[2 * q + 1] = second;
+    }
+    double graph_time = seconds(start);
+
+    unsigned int mismatches = 0;
+    start = clock();
+    for (unsigned int q = 0; q < num_queries; q++)
+    {
+        double distance = frozen.getWinner(first, second, items[q]);
+        if (winners[2 * q] != first || winners[2 * q + 1] != second || distances[q] != distance)
+            mismatches++;
+    }
+    double frozen_time = seconds(start);
+
+    cout << "GNGModulGraph::getWinner " << num_queries / graph_time << " queries/s" << endl;
+    cout << "FrozenGraph::getWinner   " << num_queries / frozen_time << " queries/s" << endl;
+
+    const SpatialIndex<double>::Kind kinds[] = {SpatialIndex<double>::KDTREE, SpatialIndex<double>::BALLTREE, SpatialIndex<double>::AUTO};
+    const char* names[] = {"kd-tree", "ball tree", "auto index"};
+    for (unsigned int k = 0; k < 3; k++)
+    {
+        graph.setWinnerIndex(kinds[k]);
+        unsigned long evaluations = graph.winnerIndex().evaluations();
+        unsigned long scans = graph.winnerIndex().scans();
+        start = clock();
+        mismatches += countMismatches(graph, items, winners, distances);
+        double index_time = seconds(start);
+        cout << names[k] << " getWinner       " << num_queries / index_time << " queries/s, "
+             << double(graph.winnerIndex().evaluations() - evaluations) / num_queries << " distances per query, "
+             << graph.winnerIndex().scans() - scans << " scans" << endl;
+    }
+
+    // the prefilter is approximate, only its misses of the first winner are reported
+    graph.setWinnerIndex(SpatialIndex<double>::NONE);
+    graph.setPrefilter(32);
+    unsigned int misses = 0;
+    start = clock();
+    for (unsigned int q = 0; q < num_queries; q++)
+    {
+        graph.getWinner(first, second, items[q]);
+        if (winners[2 * q] != first)
+            misses++;
+    }
+    double prefilter_time = seconds(start);
+    cout << "prefilter getWinner       " << num_queries / prefilter_time << " queries/s, "
+         << misses << " first winners missed, " << graph.prefilter().stats().certified << " certified, "
+         << graph.prefilter().stats().scans << " scans" << endl;
+    graph.setPrefilter(0);
+    cout << "mismatches " << mismatches << endl;
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,300 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file TopologicalSearch.h
+* \brief Approximate winner search walking along the edges of the graph
+*
+*  \date    2026
+*/
+
+#ifndef TOPOLOGICALSEARCH_H
+#define TOPOLOGICALSEARCH_H
+
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <Graphs/Base_Graph.h>
+
+namespace neuralgas {
+
+/** \class TopologicalSearch
+ *  \brief Approximate winner search walking along the edges of the graph
+ *
+ * Consecutive items of a time series usually have their winners close to the winners
+ * of the previous item. The search starts at the two previous winners and does a beam
+ * search over the edges of the graph: the _beamWidth closest nodes found so far are
+ * kept, their neighbors are visited until every kept node has been expanded. A beam
+ * width of 1 is the greedy walk. The first winner is the closest visited node, the
+ * second winner the second closest visited node.
+ *
+ * The exact search of the graph is used instead if the walk cannot start, i.e. there is
+ * no previous winner or no visited node has a neighbor, or if it visits more than the
+ * fraction _budget of all nodes. Every _verification-th walk is checked against the exact
+ * search, the counters tell how often the walk found the exact first winner and how many
+ * distances it computed compared to scanning all nodes.
+ * Copies only share the settings, the seeds and counters start empty.
+ *
+ * \param _beamWidth number of closest nodes that are expanded, 0 disables the search
+ * \param _budget maximal fraction of the nodes whose distance is computed by a walk
+ * \param _verification period of the walks that are verified by the exact search, 0 for none
+ * \param _seeds winners of the previous search
+ * \param _stats counters of the searches
+ * \param _visited stamp of the last search that visited a node
+ * \param _stamp stamp of the current search
+ * \param _beam closest nodes found by the current search, ascending
+ */
+template<typename T> class TopologicalSearch
+{
+public:
+	/// counters of the searches
+	struct Stats
+	{
+		Stats() : queries(0), fallbacks(0), verified(0), hits(0), evaluations(0), scanned(0) {}
+		// fraction of the verified walks that found the exact first winner
+		double hitRate() const { return verified ? double(hits) / verified : 1.0; }
+		// number of distances a scan would have computed per computed distance
+		double speedup() const { return evaluations ? double(scanned) / evaluations : 1.0; }
+		// number of searches
+		unsigned long queries;
+		// number of searches done by the exact search
+		unsigned long fallbacks;
+		// number of walks checked by the exact search
+		unsigned long verified;
+		// number of checked walks that found the exact first winner
+		unsigned long hits;
+		// number of distances computed by the searches, a fallback counts all nodes, a verification none
+		unsigned long evaluations;
+		// number of distances a scan of all nodes would have computed
+		unsigned long scanned;
+	};
+	//std cto, the search is disabled
+	TopologicalSearch() : _beamWidth(0), _budget(0.25), _verification(0), _stamp(0) {}
+	//copy cto copying the settings only
+	TopologicalSearch(const TopologicalSearch& t) : _beamWidth(t._beamWidth), _budget(t._budget), _verification(t._verification), _stamp(0) {}
+	//assignment copying the settings only
+	TopologicalSearch& operator=(const TopologicalSearch&);
+	//sets the beam width, 0 disables the search
+	void                     setBeamWidth(const unsigned int& width) { _beamWidth = width; }
+	//sets the maximal fraction of the nodes visited by a walk
+	void                     setBudget(const T& budget) { assert (budget > 0); _budget = budget; }
+	//sets the period of the walks verified by the exact search, 0 for none
+	void                     setVerification(const unsigned int& period) { _verification = period; }
+	//returns whether the search is enabled
+	inline bool              enabled() const { return _beamWidth > 0; }
+	//returns the beam width
+	inline unsigned int      beamWidth() const { return _beamWidth; }
+	//returns the counters
+	inline const Stats&      stats() const { return _stats; }
+	//resets the counters
+	inline void              resetStats() { _stats = Stats(); }
+	//forgets the previous winners
+	inline void              clearSeeds() { _seeds[0] = _seeds[1] = NodeHandle(); }
+	//determines the two winner nodes of the graph for the given item
+	template<typename G>
+	T                        getWinner(const G&, unsigned int&, unsigned int&, const Vector<T>&);
+
+private:
+	typedef std::pair<T,unsigned int> Entry;
+	//walks from the seeds, returns false if the exact search has to be used
+	template<typename G>
+	bool                     walk(const G&, unsigned int&, unsigned int&, T&, const Vector<T>&);
+	//inserts the node into the beam if it is among the closest ones
+	void                     insert(const T&, const unsigned int&);
+	//updates the two closest nodes, equal distances prefer the smaller index
+	static inline void       rank(const T&, const unsigned int&, T*, unsigned int*);
+	unsigned int             _beamWidth;
+	T                        _budget;
+	unsigned int             _verification;
+	NodeHandle               _seeds[2];
+	Stats                    _stats;
+	std::vector<unsigned int> _visited;
+	unsigned int             _stamp;
+	std::vector<Entry>       _beam;
+	std::vector<bool>        _expanded;
+};
+
+/** \brief assignment copying the settings only
+*/
+template<typename T> TopologicalSearch<T>& TopologicalSearch<T>::operator=(const TopologicalSearch& t)
+{
+	_beamWidth    = t._beamWidth;
+	_budget       = t._budget;
+	_verification = t._verification;
+	clearSeeds();
+	return *this;
+}
+
+/** \brief determines the two winner nodes of the graph for the given item
+*
+* \param graph whose getDistance and getExactWinner are used
+* \param first_winner after func call the closest node found
+* \param second_winner after func call the second closest node found
+* \param item data vector
+* \return distance of the item to the first winner
+*/
+template<typename T> template<typename G>
+T TopologicalSearch<T>::getWinner(const G& graph, unsigned int& first_winner, unsigned int& second_winner, const Vector<T>& item)
+{
+	T distance;
+	_stats.queries++;
+	_stats.scanned += graph.size();
+	if (!walk(graph, first_winner, second_winner, distance, item))
+	{
+		_stats.fallbacks++;
+		_stats.evaluations += graph.size();
+		distance = graph.getExactWinner(first_winner, second_winner, item);
+	}
+	else if (_verification > 0 && (_stats.queries - _stats.fallbacks) % _verification == 0)
+	{
+		unsigned int first, second;
+		graph.getExactWinner(first, second, item);
+		_stats.verified++;
+		if (first == first_winner)
+			_stats.hits++;
+	}
+	_seeds[0] = graph.getHandle(first_winner);
+	_seeds[1] = graph.getHandle(second_winner);
+	return distance;
+}
+
+/** \brief walks from the previous winners along the edges toward the item
+*
+* \return false if the walk cannot start or exceeds the budget
+*/
+template<typename T> template<typename G>
+bool TopologicalSearch<T>::walk(const G& graph, unsigned int& first_winner, unsigned int& second_winner, T& distance, const Vector<T>& item)
+{
+	typedef typename G::Adjacency::const_iterator const_iterator;
+	const unsigned int n = graph.size();
+	const unsigned long budget = (unsigned long) (_budget * n);
+	unsigned long evaluations = 0;
+
+	if (_visited.size() < n)
+		_visited.resize(n, 0);
+	if (++_stamp == 0)
+	{
+		// the stamps wrapped around, older stamps could be mistaken for the current one
+		std::fill(_visited.begin(), _visited.end(), 0);
+		_stamp = 1;
+	}
+	_beam.clear();
+	_expanded.clear();
+
+	// the two closest visited nodes
+	T best[2]             = {std::numeric_limits<T>::max(), std::numeric_limits<T>::max()};
+	unsigned int winner[2] = {n, n};
+	for (unsigned int s = 0; s < 2; s++)
+	{
+		if (!graph.isValid(_seeds[s]))
+			continue;
+		const unsigned int i = graph.getIndex(_seeds[s]);
+		if (_visited[i] == _stamp)
+			continue;
+		_visited[i] = _stamp;
+		T d = graph.getDistance(item, i);
+		evaluations++;
+		insert(d, i);
+		rank(d, i, best, winner);
+	}
+	if (_beam.empty())
+		return false;
+
+	bool moved = false;
+	for (;;)
+	{
+		unsigned int e = 0;
+		while (e < _beam.size() && _expanded[e])
+			e++;
+		if (e == _beam.size())
+			break;
+		_expanded[e] = true;
+		const unsigned int x = _beam[e].second;
+		for (const_iterator it = graph.adjacency().begin(x); it != graph.adjacency().end(x); ++it)
+		{
+			const unsigned int j = it->index;
+			moved = true;
+			if (_visited[j] == _stamp)
+				continue;
+			_visited[j] = _stamp;
+			T d = graph.getDistance(item, j);
+			if (++evaluations > budget)
+			{
+				_stats.evaluations += evaluations;
+				return false;
+			}
+			insert(d, j);
+			rank(d, j, best, winner);
+		}
+	}
+	_stats.evaluations += evaluations;
+	// without any edge the walk could not leave the seeds
+	if (!moved || winner[1] == n)
+		return false;
+	first_winner  = winner[0];
+	second_winner = winner[1];
+	distance      = best[0];
+	return true;
+}
+
+/** \brief inserts the node into the beam if it is among the _beamWidth closest nodes
+*
+* The beam is kept in ascending order, a node that is inserted has not been expanded.
+*/
+template<typename T> void TopologicalSearch<T>::insert(const T& d, const unsigned int& index)
+{
+	const Entry entry(d, index);
+	if (_beam.size() == _beamWidth && !(entry < _beam.back()))
+		return;
+	unsigned int p = _beam.size();
+	while (p > 0 && entry < _beam[p - 1])
+		p--;
+	_beam.insert(_beam.begin() + p, entry);
+	_expanded.insert(_expanded.begin() + p, false);
+	if (_beam.size() > _beamWidth)
+	{
+		_beam.pop_back();
+		_expanded.pop_back();
+	}
+}
+
+/** \brief updates the two closest nodes by the given node
+*
+* \param d distance of the node
+* \param index of the node
+* \param best distances of the two closest nodes
+* \param winner indices of the two closest nodes
+*/
+template<typename T> inline void TopologicalSearch<T>::rank(const T& d, const unsigned int& index, T* best, unsigned int* winner)
+{
+	if (d < best[0] || (d == best[0] && index < winner[0]))
+	{
+		best[1]   = best[0];
+		winner[1] = winner[0];
+		best[0]   = d;
+		winner[0] = index;
+	}
+	else if (d < best[1] || (d == best[1] && index < winner[1]))
+	{
+		best[1]   = d;
+		winner[1] = index;
+	}
+}
+
+} // namespace neuralgas
+
+#endif
@@ -36,6 +36,7 @@
 #include <limits>
 #include <Graphs/Base_Graph.h>
 #include <tools/math_helpers.h>
+#include <tools/dataStatistics.h>
 #include <boost/iostreams/tee.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <sstream>
@@ -97,8 +98,8 @@ public:
     ~NeuralGas(void);
     //sets the data to be processed
     inline void             setData(std::vector< Vector<T>* >*);
-    /// gets current data set
-    inline std::vector< Vector<T>* >* getData() { return _data; }
+    /// gets current data set, it may be changed by the caller thus the cached statistics are dropped
+    inline std::vector< Vector<T>* >* getData() { _statistics.invalidate(); return _data; }
     //adds a single datum
     inline void             addData(Vector<T>*);
     //adds an arbitrary number of data
@@ -117,13 +118,17 @@ public:
     //determines the minimal value within the given data set
     const T                 minValue() const;
     //determines the maximal values for each dim within the given data set
-    Vector<T>               maxValues() const;
+    const Vector<T>&        maxValues() const;
     //determines the minimal values for each dim within the given data set
-    Vector<T>               minValues() const;
+    const Vector<T>&        minValues() const;
+    //determines the mean of all values within the given data set
+    T                       meanValue() const;
+    //determines the variances for each dim within the given data set
+    Vector<T>               variances() const;
     // saves the nodes weight in a file
     void                    save(const char*, bool t = false);
-    // loads nodes
-    void                    setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes);
+    // loads nodes, the edges are taken from the given adjacency
+    void                    setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes, const typename Base_Graph<T,S>::Adjacency* adjacency = NULL);
     // sets the sampling mode for learning instances
     virtual void            setSamplingMode (unsigned int);
     //sets a user defined stopping criterion
@@ -143,6 +148,8 @@ protected:
     inline void             applyFunc2AllNodes(void (*)(Base_Node<T,S>* n,const float&),const float&); 
     // returns the dimension of the data vectors
     inline unsigned int     getDimension(void) const; 
+    // returns the padded length of the storage of the data vectors
+    inline unsigned int     getStride(void) const;
     // ptr to the underlying graph
     Base_Graph<T,S>*        graphptr;          
     // returns a reference to the indexed element
@@ -169,11 +176,16 @@ protected:
     unsigned int _dimension; 
     // ptr to the input data
     std::vector< Vector<T>* >* _data; 
+    // statistics of the data set, computed on first use and updated by addData
+    mutable DataStatistics<T> _statistics;
     //user specified metric
     //T                       (*_metric_to_use)(const Vector<T>&,const Vector<T>&);
     Metric _metric_to_use;
 
 
+    // returns the statistics of the data set, computes them if they are outdated
+    const DataStatistics<T>& statistics() const;
+
 private:
     template<class Archive>
     void serialize(Archive & ar, const unsigned int);
@@ -285,28 +297,54 @@ void NeuralGas<T,S>::setFuncArray(T (*func)(const unsigned int& time),const unsi
  */
 template<typename T,typename S> const T NeuralGas<T,S>::maxValue() const
 {
-    return neuralgas::maxValue (_data);
+    return statistics().maxValue ();
 }
 /** \brief Determines the minimal value within the given data set
  *
  */
 template<typename T,typename S> const T NeuralGas<T,S>::minValue() const
 {
-    return neuralgas::minValue (_data);
+    return statistics().minValue ();
 }
 /** \brief Determines the minimal values in each dim within the given data set
  *
  */
-template<typename T,typename S> Vector<T> NeuralGas<T,S>::minValues() const
+template<typename T,typename S> const Vector<T>& NeuralGas<T,S>::minValues() const
 {
-    return neuralgas::minValues (_data);
+    return statistics().minValues ();
 }
 /** \brief Determines the maximal values in each dim within the given data set
  *
  */
-template<typename T,typename S> Vector<T> NeuralGas<T,S>::maxValues() const
+template<typename T,typename S> const Vector<T>& NeuralGas<T,S>::maxValues() const
+{
+    return statistics().maxValues ();
+}
+/** \brief Determines the mean of all values within the given data set
+ *
+ */
+template<typename T,typename S> T NeuralGas<T,S>::meanValue() const
+{
+    return T (statistics().meanValue ());
+}
+/** \brief Determines the variances in each dim within the given data set
+ *
+ */
+template<typename T,typename S> Vector<T> NeuralGas<T,S>::variances() const
 {
-    return neuralgas::maxValues (_data);
+    return statistics().variances ();
+}
+/** \brief Returns the statistics of the data set
+ *
+ *  They are computed in one pass over the data set the first time they are needed after
+ *  setData or getData and kept up to date by addData.
+ */
+template<typename T,typename S> const DataStatistics<T>& NeuralGas<T,S>::statistics() const
+{
+    assert (_data != NULL);
+    if (!_statistics.isValid ())
+      _statistics.compute (*_data);
+    return _statistics;
 }
 
 
@@ -377,6 +415,7 @@ template < typename T, typename S > inline void NeuralGas<T,S>::setData(std::vec
     Vector<T> *new_item = new Vector<T>(*data->at(i));
     _data->push_back (new_item);
   }
+  _statistics.invalidate ();
 
 }
 
@@ -385,7 +424,11 @@ template < typename T, typename S > inline void NeuralGas<T,S>::setData(std::vec
 *   \param to_add the item to add
 */
 template < typename T, typename S > inline void NeuralGas<T,S>::addData(Vector<T>* to_add)
-{_data->push_back(to_add);}
+{
+  _data->push_back(to_add);
+  if (_statistics.isValid ())
+    _statistics.add (*to_add);
+}
 
 /** \brief adds an arbitrary number of data
 *
@@ -396,11 +439,14 @@ template < typename T, typename S > inline void NeuralGas<T,S>::addData(std::vec
   if (_data == NULL)
     _data = new std::vector< Vector<T>* >;
 
+  const unsigned int first = _data->size();
   for(unsigned int i=0;i < to_add->size(); i++)
   {
     Vector<T> *new_item = new Vector<T>(*to_add->at(i));
     _data->push_back(new_item);
   }
+  if (_statistics.isValid ())
+    _statistics.add (*_data, first);
 }
 
 
@@ -493,7 +539,15 @@ template < typename T, typename S > void NeuralGas<T,S>::applyFunc2AllNodes(void
 /** \brief Function returns the vectors dimension.
 */
 template < typename T, typename S > unsigned int NeuralGas<T,S>::getDimension(void) const 
-{return _dimension;}  
+{return _dimension;}
+
+/** \brief Function returns the number of elements the storage of a data vector is padded to.
+*
+* Every data vector starts at a 64 byte boundary and its elements behind the dimension
+* up to the stride are zero, see AlignedAllocator.
+*/
+template < typename T, typename S > unsigned int NeuralGas<T,S>::getStride(void) const
+{return paddedLength<T>(_dimension);}  
 
 /** returns the number of data items currently stored
 */
@@ -514,13 +568,13 @@ template <typename T, typename S > Vector<T>& NeuralGas<T,S>::operator[](const u
 template <typename T, typename S > const Vector<T>& NeuralGas<T,S>::operator[](const unsigned int& index) const
 {return *(*_data)[index];}
 
-/** \brief Loads the nodes weight from a file
-    \param filename
-    \param text if text file then true
+/** \brief Loads the nodes weight, see Base_Graph::setNodes
+    \param nodes
+    \param adjacency adjacency whose edges are added or NULL for a graph without edges
  */
-template<typename T, typename S> void NeuralGas<T,S>::setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes)
+template<typename T, typename S> void NeuralGas<T,S>::setNodes( std::vector < Base_Node<T, S>*, _NGPoolAlloc_ >* nodes, const typename Base_Graph<T,S>::Adjacency* adjacency)
 {
-  graphptr->setNodes (nodes);
+  graphptr->setNodes (nodes, adjacency);
 }
 
 /** \brief Redirects output to a file */
@@ -18,6 +18,7 @@
 #include <DataGenerator/GaussianNoise.h>
 #include "Voronoi.h"
 #include <tools/metrics.h>
+#include <tools/batchAssignment.h>
 
 using namespace neuralgas;
 
@@ -25,19 +26,41 @@ double getMSError (std::vector<Vector<double> >& centers, SeqNeurons& nodes)
 {
 	double MSError = 0.0;
 	std::vector<double> errors;
-	for (unsigned int i=0; i<centers.size(); i++)
+	if (nodes.size() >= 2 && !centers.empty())
 	{
-		double nearest_distance = std::numeric_limits<double>::max();
-		double distance;
+		// the nearest nodes of all centers are determined at once
+		WeightMatrix<double> weights;
+		weights.setDim (centers[0].size());
 		for (unsigned int j=0; j<nodes.size(); j++)
 		{
-			distance = euclidean<double, int> (centers[i], nodes[j]->weight);
-			if (distance < nearest_distance)
+			weights.addRow ();
+			for (unsigned int k=0; k<weights.dim(); k++)
+				weights.row(j)[k] = nodes[j]->weight[k];
+		}
+		std::vector<const double*> items (centers.size());
+		for (unsigned int i=0; i<centers.size(); i++)
+			items[i] = &centers[i][0];
+		std::vector< Assignment<double> > nearest (centers.size());
+		BatchAssignment<double> (weights).assign (&items[0], items.size(), &nearest[0]);
+		for (unsigned int i=0; i<nearest.size(); i++)
+			errors.push_back (nearest[i].first_distance);
+	}
+	else
+	{
+		for (unsigned int i=0; i<centers.size(); i++)
+		{
+			double nearest_distance = std::numeric_limits<double>::max();
+			double distance;
+			for (unsigned int j=0; j<nodes.size(); j++)
 			{
-				nearest_distance = distance;
+				distance = euclidean<double, int> (centers[i], nodes[j]->weight);
+				if (distance < nearest_distance)
+				{
+					nearest_distance = distance;
+				}
 			}
+			errors.push_back (nearest_distance);
 		}
-		errors.push_back (nearest_distance);
 	}
 	for (unsigned int i =0; i < errors.size(); i++)
 		MSError += errors[i];
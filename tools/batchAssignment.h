@@ -0,0 +1,394 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file batchAssignment.h
+* \brief Multithreaded assignment of data items to their two closest nodes
+*
+*  \date    2026
+*/
+#ifndef BATCHASSIGNMENT_H
+#define BATCHASSIGNMENT_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <QThread>
+#include <Graphs/WeightMatrix.h>
+#include <tools/metrics.h>
+#include <tools/distanceKernels.h>
+
+namespace neuralgas
+{
+
+/**
+ * \struct Assignment
+ * \brief the two closest nodes of a data item
+ */
+template<typename T> struct Assignment
+{
+	/// closest node, the smallest index among equally close ones
+	unsigned int first;
+	/// second closest node
+	unsigned int second;
+	/// euclidean distance of the item to the first node
+	T first_distance;
+	/// euclidean distance of the item to the second node
+	T second_distance;
+};
+
+//! \class RangeThread
+/*! \brief thread calling job.run (begin, end) for a range of a parallel pass
+ */
+template<typename Job> class RangeThread : public QThread
+{
+public:
+	RangeThread (const Job& job, const unsigned int& begin, const unsigned int& end) : _job (job), _begin (begin), _end (end) {}
+	void run () { _job.run (_begin, _end); }
+private:
+	const Job& _job;
+	unsigned int _begin;
+	unsigned int _end;
+};
+
+//! \brief calls job.run (begin, end) for consecutive ranges of [0, count) in parallel threads
+/*!
+  The calling thread runs the first range itself. Every range gets at least grain
+  elements, thus small passes are not split. The ranges have to be independent.
+
+  \param job object whose const function run (begin, end) does the work
+  \param count number of elements
+  \param threads number of threads, 0 for the number of cores
+  \param grain minimal number of elements of a range
+*/
+template<typename Job>
+void parallelRanges (const Job& job, const unsigned int& count, const unsigned int& threads, const unsigned int& grain)
+{
+	unsigned int n = threads;
+	if (n == 0)
+		n = (QThread::idealThreadCount () > 0) ? QThread::idealThreadCount () : 1;
+	n = std::min (n, (count + grain - 1) / std::max (grain, 1u));
+	if (n <= 1)
+	{
+		job.run (0, count);
+		return;
+	}
+	std::vector< RangeThread<Job>* > workers;
+	for (unsigned int t = 1; t < n; t++)
+	{
+		workers.push_back (new RangeThread<Job> (job, (unsigned long) count * t / n, (unsigned long) count * (t + 1) / n));
+		workers.back()->start ();
+	}
+	job.run (0, count / n);
+	for (unsigned int t = 0; t < workers.size(); t++)
+	{
+		workers[t]->wait ();
+		delete workers[t];
+	}
+}
+
+//! \brief dot products of four centered items with all nodes of a tile
+/*!
+  A block of four items and eight nodes is accumulated in registers over all dimensions,
+  the compiler vectorizes the eight nodes.
+
+  \param x four items, dim elements each
+  \param dim dimension
+  \param tile transposed tile, dim rows of tile_size nodes
+  \param tile_size number of nodes of the tile, a multiple of eight
+  \param dots after func call the dot products, four rows of tile_size elements
+*/
+inline void dotProductTile (const double* x, const unsigned int& dim, const double* tile, const unsigned int& tile_size, double* dots)
+{
+	for (unsigned int j = 0; j < tile_size; j += 8)
+	{
+		double sum[4][8] = {{0}};
+		for (unsigned int k = 0; k < dim; k++)
+		{
+			const double* column = tile + k * tile_size + j;
+			for (unsigned int i = 0; i < 4; i++)
+			{
+				const double value = x[i * dim + k];
+				for (unsigned int l = 0; l < 8; l++)
+					sum[i][l] += value * column[l];
+			}
+		}
+		for (unsigned int i = 0; i < 4; i++)
+			for (unsigned int l = 0; l < 8; l++)
+				dots[i * tile_size + j + l] = sum[i][l];
+	}
+}
+
+#ifdef NEURALGAS_SIMD_X86
+//! \brief dotProductTile compiled for AVX2
+__attribute__((target("avx2")))
+inline void dotProductTileAvx2 (const double* x, const unsigned int& dim, const double* tile, const unsigned int& tile_size, double* dots)
+{
+	dotProductTile (x, dim, tile, tile_size, dots);
+}
+
+//! \brief dotProductTile compiled for AVX-512
+__attribute__((target("avx512f")))
+inline void dotProductTileAvx512 (const double* x, const unsigned int& dim, const double* tile, const unsigned int& tile_size, double* dots)
+{
+	dotProductTile (x, dim, tile, tile_size, dots);
+}
+#endif
+
+/** \class BatchAssignment
+ *  \brief Determines the two closest nodes for many data items at once
+ *
+ * Bulk passes compare every data item with every node. Instead of computing the
+ * distances one by one, the squared distances are expanded as |x|^2 - 2 x.w + |w|^2:
+ * the nodes are centered at their mean and stored transposed in tiles of nodeTile
+ * nodes together with their squared norms, the dot products of itemTile items with a
+ * tile are accumulated like a matrix multiplication whose operands stay in the cache.
+ * The items are split among threads (see parallelRanges).
+ *
+ * The expansion is computed in double and its rounding error is bounded. Only nodes
+ * whose lower bound does not exceed the upper bound of the second closest node are
+ * candidates, their distances are computed again by euclidean. Thus the result is
+ * exactly the one of a scan using euclidean: the first node is the closest one with the
+ * smallest index among equally close ones, the second the closest of the other nodes.
+ * The weights must not change while the BatchAssignment is used.
+ *
+ * \param _weights weight matrix of the nodes
+ * \param _threads number of threads, 0 for the number of cores
+ * \param _dim dimension of the weights
+ * \param _nodes number of nodes
+ * \param _center mean of the weights
+ * \param _tiles centered weights, transposed in tiles of nodeTile nodes
+ * \param _norms squared norms of the centered weights
+ */
+template<typename T> class BatchAssignment
+{
+public:
+	enum { itemTile = 8, nodeTile = 256 };
+	//cto precomputing the tiles and norms of the nodes
+	BatchAssignment (const WeightMatrix<T>&, const unsigned int& threads = 0);
+	//assigns the given items
+	void assign (const T* const*, const unsigned int&, Assignment<T>*) const;
+	//assigns the given data items
+	void assign (const std::vector< Vector<T>* >&, std::vector< Assignment<T> >&) const;
+	//assigns the data items given by their indices
+	void assign (const std::vector< Vector<T>* >&, const std::vector<unsigned int>&, std::vector< Assignment<T> >&) const;
+	//assigns the items from begin to end, called by the threads
+	void assignRange (const T* const*, Assignment<T>*, const unsigned int&, const unsigned int&) const;
+
+private:
+	/// pass over a block of items run by parallelRanges
+	struct Job
+	{
+		Job (const BatchAssignment& b, const T* const* i, Assignment<T>* r) : batch (b), items (i), result (r) {}
+		void run (const unsigned int& begin, const unsigned int& end) const { batch.assignRange (items, result, begin, end); }
+		const BatchAssignment& batch;
+		const T* const* items;
+		Assignment<T>* result;
+	};
+	const WeightMatrix<T>&   _weights;
+	unsigned int             _threads;
+	unsigned int             _dim;
+	unsigned int             _nodes;
+	std::vector<double>      _center;
+	std::vector<double>      _tiles;
+	std::vector<double>      _norms;
+};
+
+/** \brief cto precomputing the tiles and norms of the nodes
+*
+* \param weights weight matrix with at least two rows, it must not change afterwards
+* \param threads number of threads, 0 for the number of cores
+*/
+template<typename T>
+BatchAssignment<T>::BatchAssignment (const WeightMatrix<T>& weights, const unsigned int& threads) :
+	_weights (weights),
+	_threads (threads),
+	_dim (weights.dim()),
+	_nodes (weights.rows()),
+	_center (weights.dim(), 0.0)
+{
+	assert (_nodes >= 2);
+	const unsigned int tiles = (_nodes + nodeTile - 1) / nodeTile;
+	for (unsigned int j = 0; j < _nodes; j++)
+		for (unsigned int k = 0; k < _dim; k++)
+			_center[k] += weights.row(j)[k];
+	for (unsigned int k = 0; k < _dim; k++)
+		_center[k] /= _nodes;
+	// padded nodes are zero and never considered
+	_tiles.assign ((unsigned long) tiles * nodeTile * _dim, 0.0);
+	_norms.assign ((unsigned long) tiles * nodeTile, 0.0);
+	for (unsigned int j = 0; j < _nodes; j++)
+	{
+		double* tile = &_tiles[(unsigned long) (j / nodeTile) * nodeTile * _dim];
+		for (unsigned int k = 0; k < _dim; k++)
+		{
+			const double value = weights.row(j)[k] - _center[k];
+			tile[k * nodeTile + j % nodeTile] = value;
+			_norms[j] += value * value;
+		}
+	}
+}
+
+/** \brief assigns the given items
+*
+* \param items pointers to the items, dim elements each
+* \param count number of items
+* \param result the assignment of every item, count elements
+*/
+template<typename T>
+void BatchAssignment<T>::assign (const T* const* items, const unsigned int& count, Assignment<T>* result) const
+{
+	parallelRanges (Job (*this, items, result), count, _threads, 4 * itemTile);
+}
+
+/** \brief assigns the given data items
+*
+* \param data items
+* \param result after func call the assignment of every item
+*/
+template<typename T>
+void BatchAssignment<T>::assign (const std::vector< Vector<T>* >& data, std::vector< Assignment<T> >& result) const
+{
+	std::vector<const T*> items (data.size());
+	for (unsigned int i = 0; i < data.size(); i++)
+		items[i] = &(*data[i])[0];
+	result.resize (data.size());
+	if (!data.empty())
+		assign (&items[0], items.size(), &result[0]);
+}
+
+/** \brief assigns the data items given by their indices
+*
+* \param data items
+* \param indices of the items to be assigned
+* \param result after func call the assignment of every given item
+*/
+template<typename T>
+void BatchAssignment<T>::assign (const std::vector< Vector<T>* >& data, const std::vector<unsigned int>& indices, std::vector< Assignment<T> >& result) const
+{
+	std::vector<const T*> items (indices.size());
+	for (unsigned int i = 0; i < indices.size(); i++)
+		items[i] = &(*data[indices[i]])[0];
+	result.resize (indices.size());
+	if (!indices.empty())
+		assign (&items[0], items.size(), &result[0]);
+}
+
+/** \brief assigns the items from begin to end
+*
+* The expanded squared distance s of a node differs from the exact one by at most
+* relative (|x|^2 + |w|^2), the sum of euclidean differs from the exact one by at most
+* rounding times s. A node is a candidate if its lower bound does not exceed the second
+* smallest upper bound, the candidates are compared by euclidean.
+*/
+template<typename T>
+void BatchAssignment<T>::assignRange (const T* const* items, Assignment<T>* result, const unsigned int& begin, const unsigned int& end) const
+{
+	const double relative = 4.0 * (_dim + 4) * std::numeric_limits<double>::epsilon();
+	const double rounding = (_dim + 8) * (double) std::numeric_limits<T>::epsilon();
+	const unsigned int tiles = (_nodes + nodeTile - 1) / nodeTile;
+	std::vector<double> x (itemTile * _dim);
+	std::vector<double> norm (itemTile);
+	std::vector<double> dots (itemTile * nodeTile);
+	std::vector<double> upper (2 * itemTile);
+	std::vector< std::vector< std::pair<double,unsigned int> > > candidates (itemTile);
+
+	for (unsigned int i0 = begin; i0 < end; i0 += itemTile)
+	{
+		const unsigned int m = std::min ((unsigned int) itemTile, end - i0);
+		for (unsigned int i = 0; i < m; i++)
+		{
+			norm[i] = 0;
+			for (unsigned int k = 0; k < _dim; k++)
+			{
+				x[i * _dim + k] = items[i0 + i][k] - _center[k];
+				norm[i] += x[i * _dim + k] * x[i * _dim + k];
+			}
+			upper[2 * i] = upper[2 * i + 1] = std::numeric_limits<double>::max();
+			candidates[i].clear();
+		}
+		for (unsigned int t = 0; t < tiles; t++)
+		{
+			const double* tile = &_tiles[(unsigned long) t * nodeTile * _dim];
+			const unsigned int first = t * nodeTile;
+			const unsigned int count = std::min ((unsigned int) nodeTile, _nodes - first);
+			for (unsigned int i = 0; i < m; i += 4)
+			{
+				const double* items_x = &x[i * _dim];
+				double* dot = &dots[i * nodeTile];
+#ifdef NEURALGAS_SIMD_X86
+				if (simdLevel () == avx512)
+					dotProductTileAvx512 (items_x, _dim, tile, nodeTile, dot);
+				else if (simdLevel () == avx2)
+					dotProductTileAvx2 (items_x, _dim, tile, nodeTile, dot);
+				else
+#endif
+					dotProductTile (items_x, _dim, tile, nodeTile, dot);
+			}
+			for (unsigned int i = 0; i < m; i++)
+			{
+				const double* dot = &dots[i * nodeTile];
+				double* up = &upper[2 * i];
+				for (unsigned int j = 0; j < count; j++)
+				{
+					const double squared = norm[i] - 2 * dot[j] + _norms[first + j];
+					const double error = relative * (norm[i] + _norms[first + j]);
+					const double high = (squared + error) * (1 + rounding);
+					const double low = (squared - error) * (1 - rounding);
+					if (high < up[1])
+					{
+						up[1] = std::max (up[0], high);
+						up[0] = std::min (up[0], high);
+					}
+					if (low <= up[1])
+						candidates[i].push_back (std::make_pair (low, first + j));
+				}
+			}
+		}
+		for (unsigned int i = 0; i < m; i++)
+		{
+			Assignment<T>& a = result[i0 + i];
+			a.first = a.second = _nodes;
+			a.first_distance = a.second_distance = std::numeric_limits<T>::max();
+			for (unsigned int c = 0; c < candidates[i].size(); c++)
+			{
+				if (candidates[i][c].first > upper[2 * i + 1])
+					continue;
+				const unsigned int j = candidates[i][c].second;
+				const T distance = euclidean<T> (items[i0 + i], _weights.row(j), _dim);
+				// the candidates are in ascending order of the nodes
+				if (distance < a.first_distance)
+				{
+					a.second          = a.first;
+					a.second_distance = a.first_distance;
+					a.first           = j;
+					a.first_distance  = distance;
+				}
+				else if (distance < a.second_distance)
+				{
+					a.second          = j;
+					a.second_distance = distance;
+				}
+			}
+		}
+	}
+}
+
+} //namespace neuralgas
+
+#endif
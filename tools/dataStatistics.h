@@ -0,0 +1,327 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+* \file dataStatistics.h
+* \brief Per dimension statistics of a data set computed in one pass
+*
+*  \date    2026
+*/
+#ifndef DATASTATISTICS_H
+#define DATASTATISTICS_H
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <Graphs/Vector.h>
+#include <tools/batchAssignment.h>
+
+namespace neuralgas
+{
+
+/** \class DataStatistics
+ *  \brief Minimum, maximum, mean and variance of each dim of a data set
+ *
+ * All statistics are computed in one pass over the data set. The items are split into
+ * blocks of blockSize items whose moments are computed in parallel threads (see
+ * parallelRanges) and merged in the order of the blocks, thus the result does not
+ * depend on the number of threads. Within a block the rows are traversed up to their
+ * padded length, see AlignedAllocator, such that the loops over the dims vectorize.
+ * Items that are added later are merged into the statistics without a new pass.
+ * The means and the sums of the squared deviations are of type Accumulator<T>::type.
+ *
+ * \param _count number of items
+ * \param _dim dimension of the items
+ * \param _valid true if the statistics have been computed
+ * \param _min minimal values of each dim
+ * \param _max maximal values of each dim
+ * \param _mean means of each dim
+ * \param _m2 sums of the squared deviations from the means of each dim
+ */
+template<typename T> class DataStatistics
+{
+public:
+	/// type of the means and of the sums of the squared deviations
+	typedef typename Accumulator<T>::type SumType;
+	enum { blockSize = 1024 };
+	/// std cto, the statistics have to be computed before they are used
+	DataStatistics () : _count (0), _dim (0), _valid (false) {}
+	//computes the statistics of the data set
+	void compute (const std::vector< Vector<T>* >&, const unsigned int& threads = 0);
+	//adds an item to the statistics
+	void add (const Vector<T>&);
+	//adds the items of the data set from the given index on to the statistics
+	void add (const std::vector< Vector<T>* >&, const unsigned int&, const unsigned int& threads = 0);
+	/// marks the statistics as outdated, e.g. if the data set is replaced
+	void invalidate () { _valid = false; }
+	/// returns true if the statistics are up to date
+	bool isValid () const { return _valid; }
+	/// returns the number of items
+	unsigned int count () const { return _count; }
+	/// returns the minimal values of each dim
+	const Vector<T>& minValues () const { assert (_valid); return _min; }
+	/// returns the maximal values of each dim
+	const Vector<T>& maxValues () const { assert (_valid); return _max; }
+	//returns the minimal value of all dims
+	T minValue () const;
+	//returns the maximal value of all dims
+	T maxValue () const;
+	//returns the means of each dim
+	Vector<T> means () const;
+	//returns the mean of the values of all dims
+	SumType meanValue () const;
+	//returns the variances of each dim
+	Vector<T> variances () const;
+
+private:
+	/// statistics of a block of items, the vectors have the padded length of the items
+	struct Moments
+	{
+		unsigned int         count;
+		std::vector<T>       min;
+		std::vector<T>       max;
+		std::vector<SumType> mean;
+		std::vector<SumType> m2;
+	};
+	/// pass over the blocks run by parallelRanges
+	struct Job
+	{
+		Job (const DataStatistics& s, const std::vector< Vector<T>* >& d, const unsigned int& f, Moments* m) : statistics (s), data (d), first (f), moments (m) {}
+		void run (const unsigned int& begin, const unsigned int& end) const
+		{
+			for (unsigned int b = begin; b < end; b++)
+				statistics.blockMoments (data, first + b * blockSize, std::min<unsigned int> (first + (b + 1) * blockSize, data.size()), moments[b]);
+		}
+		const DataStatistics& statistics;
+		const std::vector< Vector<T>* >& data;
+		unsigned int first;
+		Moments* moments;
+	};
+	// computes the moments of the items from begin to end
+	void blockMoments (const std::vector< Vector<T>* >&, const unsigned int&, const unsigned int&, Moments&) const;
+	// merges the moments of a block into the statistics
+	void merge (const Moments&);
+	unsigned int         _count;
+	unsigned int         _dim;
+	bool                 _valid;
+	Vector<T>            _min;
+	Vector<T>            _max;
+	std::vector<SumType> _mean;
+	std::vector<SumType> _m2;
+};
+
+/** \brief computes the statistics of the data set
+*
+* \param data data set, it must not be empty
+* \param threads number of threads, 0 for the number of cores
+*/
+template<typename T>
+void DataStatistics<T>::compute (const std::vector< Vector<T>* >& data, const unsigned int& threads)
+{
+	assert (data.size());
+	_count = 0;
+	_dim = data[0]->size();
+	assert (_dim);
+	_valid = true;
+	add (data, 0, threads);
+}
+
+/** \brief adds an item to the statistics
+*
+* The means and the sums of the squared deviations are updated as proposed by Welford.
+* \param item item of the dimension of the data set
+*/
+template<typename T>
+void DataStatistics<T>::add (const Vector<T>& item)
+{
+	assert (_valid && item.size() == _dim);
+	_count++;
+	for (unsigned int k = 0; k < _dim; k++)
+	{
+		if (_count == 1 || item[k] < _min[k])
+			_min[k] = item[k];
+		if (_count == 1 || item[k] > _max[k])
+			_max[k] = item[k];
+		const SumType deviation = item[k] - _mean[k];
+		_mean[k] += deviation / _count;
+		_m2[k] += deviation * (item[k] - _mean[k]);
+	}
+}
+
+/** \brief adds the items of the data set from the given index on to the statistics
+*
+* \param data data set
+* \param first index of the first item that is added
+* \param threads number of threads, 0 for the number of cores
+*/
+template<typename T>
+void DataStatistics<T>::add (const std::vector< Vector<T>* >& data, const unsigned int& first, const unsigned int& threads)
+{
+	assert (_valid);
+	if (first >= data.size())
+		return;
+	if (_count == 0)
+	{
+		_min.resize (_dim);
+		_max.resize (_dim);
+		_mean.assign (_dim, 0);
+		_m2.assign (_dim, 0);
+	}
+	const unsigned int blocks = (data.size() - first + blockSize - 1) / blockSize;
+	std::vector<Moments> moments (blocks);
+	parallelRanges (Job (*this, data, first, &moments[0]), blocks, threads, 4);
+	for (unsigned int b = 0; b < blocks; b++)
+		merge (moments[b]);
+}
+
+/** \brief computes the moments of the items from begin to end
+*
+* The items are read twice, for the means and for the squared deviations from them,
+* the block stays in the cache in between. The padding of the items is zero, thus the
+* moments of the padding are zero as well and never read.
+* \param data data set
+* \param begin index of the first item of the block
+* \param end index behind the last item of the block
+* \param moments after func call the moments of the block
+*/
+template<typename T>
+void DataStatistics<T>::blockMoments (const std::vector< Vector<T>* >& data, const unsigned int& begin, const unsigned int& end, Moments& moments) const
+{
+	assert (begin < end);
+	const unsigned int stride = paddedLength<T> (_dim);
+	const T* first = &(*data[begin])[0];
+	moments.count = end - begin;
+	moments.min.assign (first, first + stride);
+	moments.max.assign (first, first + stride);
+	moments.mean.assign (stride, 0);
+	moments.m2.assign (stride, 0);
+	T* NEURALGAS_RESTRICT min = &moments.min[0];
+	T* NEURALGAS_RESTRICT max = &moments.max[0];
+	SumType* NEURALGAS_RESTRICT mean = &moments.mean[0];
+	SumType* NEURALGAS_RESTRICT m2 = &moments.m2[0];
+	for (unsigned int i = begin; i < end; i++)
+	{
+		assert (data[i]->size() == _dim);
+		const T* row = static_cast<const T*> (NEURALGAS_ASSUME_ALIGNED (&(*data[i])[0]));
+		for (unsigned int k = 0; k < stride; k++)
+		{
+			min[k] = (row[k] < min[k]) ? row[k] : min[k];
+			max[k] = (row[k] > max[k]) ? row[k] : max[k];
+			mean[k] += row[k];
+		}
+	}
+	for (unsigned int k = 0; k < stride; k++)
+		mean[k] /= moments.count;
+	for (unsigned int i = begin; i < end; i++)
+	{
+		const T* row = static_cast<const T*> (NEURALGAS_ASSUME_ALIGNED (&(*data[i])[0]));
+		for (unsigned int k = 0; k < stride; k++)
+		{
+			const SumType deviation = row[k] - mean[k];
+			m2[k] += deviation * deviation;
+		}
+	}
+}
+
+/** \brief merges the moments of a block into the statistics
+*
+* The means and the sums of the squared deviations are combined as proposed by
+* Chan, Golub and LeVeque.
+* \param moments moments of a block
+*/
+template<typename T>
+void DataStatistics<T>::merge (const Moments& moments)
+{
+	if (_count == 0)
+	{
+		std::copy (moments.min.begin(), moments.min.begin() + _dim, _min.begin());
+		std::copy (moments.max.begin(), moments.max.begin() + _dim, _max.begin());
+		std::copy (moments.mean.begin(), moments.mean.begin() + _dim, _mean.begin());
+		std::copy (moments.m2.begin(), moments.m2.begin() + _dim, _m2.begin());
+		_count = moments.count;
+		return;
+	}
+	const SumType count = SumType (_count) + moments.count;
+	const SumType weight = moments.count / count;
+	const SumType product = SumType (_count) * moments.count / count;
+	for (unsigned int k = 0; k < _dim; k++)
+	{
+		_min[k] = std::min (_min[k], moments.min[k]);
+		_max[k] = std::max (_max[k], moments.max[k]);
+		const SumType deviation = moments.mean[k] - _mean[k];
+		_mean[k] += deviation * weight;
+		_m2[k] += moments.m2[k] + deviation * deviation * product;
+	}
+	_count += moments.count;
+}
+
+/** \brief returns the minimal value of all dims
+*/
+template<typename T>
+T DataStatistics<T>::minValue () const
+{
+	assert (_valid);
+	return *std::min_element (_min.begin(), _min.end());
+}
+
+/** \brief returns the maximal value of all dims
+*/
+template<typename T>
+T DataStatistics<T>::maxValue () const
+{
+	assert (_valid);
+	return *std::max_element (_max.begin(), _max.end());
+}
+
+/** \brief returns the means of each dim
+*/
+template<typename T>
+Vector<T> DataStatistics<T>::means () const
+{
+	assert (_valid);
+	Vector<T> mean_values (_dim);
+	for (unsigned int k = 0; k < _dim; k++)
+		mean_values[k] = T (_mean[k]);
+	return mean_values;
+}
+
+/** \brief returns the mean of the values of all dims
+*/
+template<typename T>
+typename DataStatistics<T>::SumType DataStatistics<T>::meanValue () const
+{
+	assert (_valid);
+	SumType sum = 0;
+	for (unsigned int k = 0; k < _dim; k++)
+		sum += _mean[k];
+	return sum / _dim;
+}
+
+/** \brief returns the variances of each dim, i.e. the mean squared deviations from the means
+*/
+template<typename T>
+Vector<T> DataStatistics<T>::variances () const
+{
+	assert (_valid && _count);
+	Vector<T> variance_values (_dim);
+	for (unsigned int k = 0; k < _dim; k++)
+		variance_values[k] = T (_m2[k] / _count);
+	return variance_values;
+}
+
+} // namespace neuralgas
+
+#endif
@@ -0,0 +1,572 @@
+/*
+ *   This file is part of NeuralGas.
+ *
+ *   NeuralGas is free software: you can redistribute it and/or modify it
+ *   under the terms of the GNU Lesser General Public License as published
+ *   by the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+
+ *   NeuralGas is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with NeuralGas.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+* \file distanceKernels.h
+* \brief Vectorized distance kernels with runtime dispatch on the instruction set
+*
+*  \date    2026
+*/
+#ifndef DISTANCEKERNELS_H
+#define DISTANCEKERNELS_H
+
+#include <Graphs/WeightMatrix.h>
+#include <limits>
+#include <math.h>
+#include <cassert>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NEURALGAS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace neuralgas
+{
+
+/**
+ * \enum SimdLevel
+ * \brief instruction sets of the distance kernels
+ */
+enum SimdLevel {scalar, /**< plain C++ loops */
+		sse2,   /**< 128 bit vectors */
+		avx2,   /**< 256 bit vectors */
+		avx512  /**< 512 bit vectors */
+};
+
+//! \brief returns the best instruction set supported by the cpu
+inline SimdLevel detectSimdLevel ()
+{
+#ifdef NEURALGAS_SIMD_X86
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx512f"))
+		return avx512;
+	if (__builtin_cpu_supports ("avx2"))
+		return avx2;
+	if (__builtin_cpu_supports ("sse2"))
+		return sse2;
+#endif
+	return scalar;
+}
+
+//! \brief returns the instruction set used by the distance kernels
+/*!
+  It is detected once, assigning a lower level, e.g. for benchmarking, is allowed.
+*/
+inline SimdLevel& simdLevel ()
+{
+	static SimdLevel level = detectSimdLevel ();
+	return level;
+}
+
+//! \brief squared euclidean distances of an item to rows of a weight matrix, plain C++
+/*!
+  Every distance is summed over the dimensions in ascending order like euclidean,
+  the vectorized kernels keep that order, thus all kernels return identical sums.
+  Only the dimensions from first to last are added, if first is not 0 the sums are
+  continued from the partial sums in result, see addSquaredDistances.
+
+  \param x item, dim elements
+  \param weights weight matrix
+  \param begin first row
+  \param count number of rows
+  \param first first dimension, a multiple of the elements in WeightMatrix::alignment bytes
+  \param last dimension behind the last one that is added
+  \param result squared distance of every row, count elements
+*/
+template<typename T>
+inline void squaredDistancesScalar (const T* x, const WeightMatrix<T>& weights, const unsigned int& begin, const unsigned int& count,
+				    const unsigned int& first, const unsigned int& last, T* result)
+{
+		for (unsigned int i = 0; i < count; i++)
+	{
+		const T* y = weights.row(begin + i);
+		T sum = first ? result[i] : T(0);
+		for (unsigned int k = first; k < last; k++)
+		{
+			const T value = x[k] - y[k];
+			sum += value * value;
+		}
+		result[i] = sum;
+	}
+}
+
+#ifdef NEURALGAS_SIMD_X86
+
+// The vectorized kernels put one row into every lane and transpose blocks of the rows,
+// such that every lane adds up its row dimension by dimension. The rows are aligned and
+// padded to 64 bytes by WeightMatrix, so a block never reads behind the storage; the
+// dimensions of the last block that lie behind the range are not added. Multiplication and
+// addition are separate instructions, the sums are the same as the ones of the scalar kernel.
+
+//! \brief SSE2 kernel for double, two rows per vector
+/*!
+  Four rows are processed at once in two vectors, such that the two chains of additions
+  overlap, the transposition of a pair of dimensions is a single unpack per vector.
+*/
+__attribute__((target("sse2")))
+inline void squaredDistancesSse2 (const double* x, const WeightMatrix<double>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, double* result)
+{
+		const unsigned int stride = weights.stride();
+	const unsigned int pairs = last - (last - first) % 2;
+	unsigned int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const double* r = weights.row(begin + i);
+		__m128d sum01 = first ? _mm_loadu_pd(result + i) : _mm_setzero_pd();
+		__m128d sum23 = first ? _mm_loadu_pd(result + i + 2) : _mm_setzero_pd();
+		for (unsigned int k = first; k < pairs; k += 2)
+		{
+			const __m128d a = _mm_load_pd(r + k);
+			const __m128d b = _mm_load_pd(r + stride + k);
+			const __m128d c = _mm_load_pd(r + 2 * stride + k);
+			const __m128d d = _mm_load_pd(r + 3 * stride + k);
+			const __m128d x0 = _mm_set1_pd(x[k]);
+			const __m128d x1 = _mm_set1_pd(x[k + 1]);
+			__m128d v01 = _mm_sub_pd(x0, _mm_unpacklo_pd(a, b));
+			__m128d v23 = _mm_sub_pd(x0, _mm_unpacklo_pd(c, d));
+			sum01 = _mm_add_pd(sum01, _mm_mul_pd(v01, v01));
+			sum23 = _mm_add_pd(sum23, _mm_mul_pd(v23, v23));
+			v01 = _mm_sub_pd(x1, _mm_unpackhi_pd(a, b));
+			v23 = _mm_sub_pd(x1, _mm_unpackhi_pd(c, d));
+			sum01 = _mm_add_pd(sum01, _mm_mul_pd(v01, v01));
+			sum23 = _mm_add_pd(sum23, _mm_mul_pd(v23, v23));
+		}
+		if (pairs < last)
+		{
+			const __m128d x0 = _mm_set1_pd(x[pairs]);
+			const __m128d v01 = _mm_sub_pd(x0, _mm_unpacklo_pd(_mm_load_pd(r + pairs), _mm_load_pd(r + stride + pairs)));
+			const __m128d v23 = _mm_sub_pd(x0, _mm_unpacklo_pd(_mm_load_pd(r + 2 * stride + pairs), _mm_load_pd(r + 3 * stride + pairs)));
+			sum01 = _mm_add_pd(sum01, _mm_mul_pd(v01, v01));
+			sum23 = _mm_add_pd(sum23, _mm_mul_pd(v23, v23));
+		}
+		_mm_storeu_pd(result + i, sum01);
+		_mm_storeu_pd(result + i + 2, sum23);
+	}
+	squaredDistancesScalar<double> (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+//! \brief SSE2 kernel for float, four rows per vector
+__attribute__((target("sse2")))
+inline void squaredDistancesSse2 (const float* x, const WeightMatrix<float>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, float* result)
+{
+		const unsigned int stride = weights.stride();
+	unsigned int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const float* r = weights.row(begin + i);
+		__m128 sum = first ? _mm_loadu_ps(result + i) : _mm_setzero_ps();
+		for (unsigned int k = first; k < last; k += 4)
+		{
+			__m128 v[4] = {_mm_load_ps(r + k), _mm_load_ps(r + stride + k),
+				       _mm_load_ps(r + 2 * stride + k), _mm_load_ps(r + 3 * stride + k)};
+			_MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+			const unsigned int n = (last - k < 4) ? last - k : 4;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				const __m128 value = _mm_sub_ps(_mm_set1_ps(x[k + j]), v[j]);
+				sum = _mm_add_ps(sum, _mm_mul_ps(value, value));
+			}
+		}
+		_mm_storeu_ps(result + i, sum);
+	}
+	squaredDistancesScalar<float> (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+//! \brief AVX2 kernel for double, four rows per vector
+__attribute__((target("avx2")))
+inline void squaredDistancesAvx2 (const double* x, const WeightMatrix<double>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, double* result)
+{
+		const unsigned int stride = weights.stride();
+	unsigned int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const double* r = weights.row(begin + i);
+		__m256d sum = first ? _mm256_loadu_pd(result + i) : _mm256_setzero_pd();
+		for (unsigned int k = first; k < last; k += 4)
+		{
+			const __m256d t0 = _mm256_unpacklo_pd(_mm256_load_pd(r + k), _mm256_load_pd(r + stride + k));
+			const __m256d t1 = _mm256_unpackhi_pd(_mm256_load_pd(r + k), _mm256_load_pd(r + stride + k));
+			const __m256d t2 = _mm256_unpacklo_pd(_mm256_load_pd(r + 2 * stride + k), _mm256_load_pd(r + 3 * stride + k));
+			const __m256d t3 = _mm256_unpackhi_pd(_mm256_load_pd(r + 2 * stride + k), _mm256_load_pd(r + 3 * stride + k));
+			__m256d v[4] = {_mm256_permute2f128_pd(t0, t2, 0x20), _mm256_permute2f128_pd(t1, t3, 0x20),
+					_mm256_permute2f128_pd(t0, t2, 0x31), _mm256_permute2f128_pd(t1, t3, 0x31)};
+			const unsigned int n = (last - k < 4) ? last - k : 4;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				const __m256d value = _mm256_sub_pd(_mm256_set1_pd(x[k + j]), v[j]);
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(value, value));
+			}
+		}
+		_mm256_storeu_pd(result + i, sum);
+	}
+	squaredDistancesSse2 (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+//! \brief AVX2 kernel for float, eight rows per vector
+__attribute__((target("avx2")))
+inline void squaredDistancesAvx2 (const float* x, const WeightMatrix<float>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, float* result)
+{
+		const unsigned int stride = weights.stride();
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const float* r = weights.row(begin + i);
+		__m256 sum = first ? _mm256_loadu_ps(result + i) : _mm256_setzero_ps();
+		for (unsigned int k = first; k < last; k += 8)
+		{
+			__m256 t[8], u[8];
+			for (unsigned int j = 0; j < 8; j += 2)
+			{
+				t[j]     = _mm256_unpacklo_ps(_mm256_load_ps(r + j * stride + k), _mm256_load_ps(r + (j + 1) * stride + k));
+				t[j + 1] = _mm256_unpackhi_ps(_mm256_load_ps(r + j * stride + k), _mm256_load_ps(r + (j + 1) * stride + k));
+			}
+			for (unsigned int j = 0; j < 8; j += 4)
+			{
+				u[j]     = _mm256_shuffle_ps(t[j], t[j + 2], _MM_SHUFFLE(1, 0, 1, 0));
+				u[j + 1] = _mm256_shuffle_ps(t[j], t[j + 2], _MM_SHUFFLE(3, 2, 3, 2));
+				u[j + 2] = _mm256_shuffle_ps(t[j + 1], t[j + 3], _MM_SHUFFLE(1, 0, 1, 0));
+				u[j + 3] = _mm256_shuffle_ps(t[j + 1], t[j + 3], _MM_SHUFFLE(3, 2, 3, 2));
+			}
+			__m256 v[8];
+			for (unsigned int j = 0; j < 4; j++)
+			{
+				v[j]     = _mm256_permute2f128_ps(u[j], u[j + 4], 0x20);
+				v[j + 4] = _mm256_permute2f128_ps(u[j], u[j + 4], 0x31);
+			}
+			const unsigned int n = (last - k < 8) ? last - k : 8;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				const __m256 value = _mm256_sub_ps(_mm256_set1_ps(x[k + j]), v[j]);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(value, value));
+			}
+		}
+		_mm256_storeu_ps(result + i, sum);
+	}
+	squaredDistancesSse2 (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+// AVX-512 implies fused multiply-add, the explicitly rounded operations are never fused.
+
+//! \brief AVX-512 kernel for double, eight rows per vector gathered dimension by dimension
+__attribute__((target("avx512f")))
+inline void squaredDistancesAvx512 (const double* x, const WeightMatrix<double>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, double* result)
+{
+		const int stride = weights.stride();
+	const __m256i rows = _mm256_mullo_epi32(_mm256_set1_epi32(stride), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const double* r = weights.row(begin + i);
+		__m512d sum = first ? _mm512_loadu_pd(result + i) : _mm512_setzero_pd();
+		for (unsigned int k = first; k < last; k++)
+		{
+			const __m512d value = _mm512_maskz_sub_round_pd(0xFF, _mm512_set1_pd(x[k]), _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, rows, r + k, 8),
+								  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			sum = _mm512_maskz_add_round_pd(0xFF, sum, _mm512_maskz_mul_round_pd(0xFF, value, value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC),
+						  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		}
+		_mm512_storeu_pd(result + i, sum);
+	}
+	squaredDistancesAvx2 (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+//! \brief AVX-512 kernel for float, sixteen rows per vector gathered dimension by dimension
+__attribute__((target("avx512f")))
+inline void squaredDistancesAvx512 (const float* x, const WeightMatrix<float>& weights, const unsigned int& begin, const unsigned int& count,
+				   const unsigned int& first, const unsigned int& last, float* result)
+{
+		const int stride = weights.stride();
+	const __m512i rows = _mm512_mullo_epi32(_mm512_set1_epi32(stride),
+						_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	unsigned int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const float* r = weights.row(begin + i);
+		__m512 sum = first ? _mm512_loadu_ps(result + i) : _mm512_setzero_ps();
+		for (unsigned int k = first; k < last; k++)
+		{
+			const __m512 value = _mm512_maskz_sub_round_ps(0xFFFF, _mm512_set1_ps(x[k]), _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, rows, r + k, 4),
+								 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			sum = _mm512_maskz_add_round_ps(0xFFFF, sum, _mm512_maskz_mul_round_ps(0xFFFF, value, value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC),
+						  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		}
+		_mm512_storeu_ps(result + i, sum);
+	}
+	squaredDistancesAvx2 (x, weights, begin + i, count - i, first, last, result + i);
+}
+
+#endif
+
+//! \brief squared euclidean distances of an item to rows of a weight matrix
+/*!
+  The kernel is chosen by simdLevel, float and double are vectorized, other types use
+  the plain C++ kernel. All kernels return the same sums.
+
+  \param x item, dim elements
+  \param weights weight matrix
+  \param begin first row
+  \param count number of rows
+  \param result squared distance of every row, count elements
+*/
+template<typename T>
+inline void squaredDistances (const T* x, const WeightMatrix<T>& weights, const unsigned int& begin, const unsigned int& count, T* result)
+{
+	squaredDistancesScalar<T> (x, weights, begin, count, 0, weights.dim(), result);
+}
+
+//! \brief adds a range of dimensions to partial squared distances of an item to rows of a weight matrix
+/*!
+  The sums are continued in ascending order, thus adding the ranges of the dimensions one
+  after the other yields the same sums as squaredDistances, every intermediate sum is a
+  prefix of them. The kernel is chosen like for squaredDistances.
+
+  \param x item, dim elements
+  \param weights weight matrix
+  \param begin first row
+  \param count number of rows
+  \param first first dimension of the range, a multiple of the elements in WeightMatrix::alignment bytes
+  \param last dimension behind the range
+  \param result partial squared distances over the dimensions before first, count elements,
+  after func call the partial squared distances over the dimensions before last
+*/
+template<typename T>
+inline void addSquaredDistances (const T* x, const WeightMatrix<T>& weights, const unsigned int& begin, const unsigned int& count,
+				 const unsigned int& first, const unsigned int& last, T* result)
+{
+	assert (first % (WeightMatrix<T>::alignment / sizeof(T)) == 0 && first < last && last <= weights.dim());
+	squaredDistancesScalar<T> (x, weights, begin, count, first, last, result);
+}
+
+#ifdef NEURALGAS_SIMD_X86
+//! \brief squared euclidean distances for double, see squaredDistances
+template<>
+inline void squaredDistances<double> (const double* x, const WeightMatrix<double>& weights, const unsigned int& begin, const unsigned int& count, double* result)
+{
+	const unsigned int dim = weights.dim();
+	switch (simdLevel ())
+	{
+	case avx512: squaredDistancesAvx512 (x, weights, begin, count, 0, dim, result); break;
+	case avx2:   squaredDistancesAvx2 (x, weights, begin, count, 0, dim, result); break;
+	case sse2:   squaredDistancesSse2 (x, weights, begin, count, 0, dim, result); break;
+	default:     squaredDistancesScalar<double> (x, weights, begin, count, 0, dim, result);
+	}
+}
+
+//! \brief adds a range of dimensions to partial squared distances for double, see addSquaredDistances
+template<>
+inline void addSquaredDistances<double> (const double* x, const WeightMatrix<double>& weights, const unsigned int& begin, const unsigned int& count,
+				      const unsigned int& first, const unsigned int& last, double* result)
+{
+	assert (first % (WeightMatrix<double>::alignment / sizeof(double)) == 0 && first < last && last <= weights.dim());
+	switch (simdLevel ())
+	{
+	case avx512: squaredDistancesAvx512 (x, weights, begin, count, first, last, result); break;
+	case avx2:   squaredDistancesAvx2 (x, weights, begin, count, first, last, result); break;
+	case sse2:   squaredDistancesSse2 (x, weights, begin, count, first, last, result); break;
+	default:     squaredDistancesScalar<double> (x, weights, begin, count, first, last, result);
+	}
+}
+
+//! \brief squared euclidean distances for float, see squaredDistances
+template<>
+inline void squaredDistances<float> (const float* x, const WeightMatrix<float>& weights, const unsigned int& begin, const unsigned int& count, float* result)
+{
+	const unsigned int dim = weights.dim();
+	switch (simdLevel ())
+	{
+	case avx512: squaredDistancesAvx512 (x, weights, begin, count, 0, dim, result); break;
+	case avx2:   squaredDistancesAvx2 (x, weights, begin, count, 0, dim, result); break;
+	case sse2:   squaredDistancesSse2 (x, weights, begin, count, 0, dim, result); break;
+	default:     squaredDistancesScalar<float> (x, weights, begin, count, 0, dim, result);
+	}
+}
+
+//! \brief adds a range of dimensions to partial squared distances for float, see addSquaredDistances
+template<>
+inline void addSquaredDistances<float> (const float* x, const WeightMatrix<float>& weights, const unsigned int& begin, const unsigned int& count,
+				      const unsigned int& first, const unsigned int& last, float* result)
+{
+	assert (first % (WeightMatrix<float>::alignment / sizeof(float)) == 0 && first < last && last <= weights.dim());
+	switch (simdLevel ())
+	{
+	case avx512: squaredDistancesAvx512 (x, weights, begin, count, first, last, result); break;
+	case avx2:   squaredDistancesAvx2 (x, weights, begin, count, first, last, result); break;
+	case sse2:   squaredDistancesSse2 (x, weights, begin, count, first, last, result); break;
+	default:     squaredDistancesScalar<float> (x, weights, begin, count, first, last, result);
+	}
+}
+#endif
+
+//! \brief approximate squared distances of a quantized item to quantized rows
+/*!
+  The rows are 8 bit codes, the squared difference of the codes of a dimension is
+  weighted by the squared scale of the dimension. The sums are accumulated in eight float
+  lanes like the vectorized kernel does.
+
+  \param item codes of the item, dim elements
+  \param codes codes of the rows, count rows of dim elements
+  \param scale2 squared scale of every dimension
+  \param dim dimension
+  \param count number of rows
+  \param result approximate squared distance of every row, count elements
+*/
+inline void quantizedDistancesScalar (const signed char* item, const signed char* codes, const float* scale2, const unsigned int& dim, const unsigned int& count, float* result)
+{
+	const unsigned int blocks = dim - dim % 8;
+	for (unsigned int j = 0; j < count; j++)
+	{
+		const signed char* c = codes + (unsigned long) j * dim;
+		float lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		for (unsigned int k = 0; k < blocks; k += 8)
+			for (unsigned int l = 0; l < 8; l++)
+			{
+				const float value = float (int (item[k + l]) - int (c[k + l]));
+				lanes[l] += scale2[k + l] * value * value;
+			}
+		float sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+		for (unsigned int k = blocks; k < dim; k++)
+		{
+			const float value = float (int (item[k]) - int (c[k]));
+			sum += scale2[k] * value * value;
+		}
+		result[j] = sum;
+	}
+}
+
+#ifdef NEURALGAS_SIMD_X86
+//! \brief weighted squared differences of eight codes of the item and of a row
+__attribute__((target("avx2")))
+inline __m256 quantizedBlockAvx2 (const __m256i& item, const __m256& scale2, const signed char* codes)
+{
+	const __m256i code  = _mm256_cvtepi8_epi32 (_mm_loadl_epi64 ((const __m128i*) codes));
+	const __m256  value = _mm256_cvtepi32_ps (_mm256_sub_epi32 (item, code));
+	return _mm256_mul_ps (_mm256_mul_ps (scale2, value), value);
+}
+
+//! \brief quantizedDistancesScalar for AVX2
+/*!
+  Four rows are processed at once, eight codes of a row are widened to floats per step
+  and the lanes of the four rows are reduced together by horizontal additions.
+*/
+__attribute__((target("avx2")))
+inline void quantizedDistancesAvx2 (const signed char* item, const signed char* codes, const float* scale2, const unsigned int& dim, const unsigned int& count, float* result)
+{
+	const unsigned int blocks = dim - dim % 8;
+	const unsigned int groups = count - count % 4;
+	for (unsigned int i = 0; i < groups; i += 4)
+	{
+		const signed char* c = codes + (unsigned long) i * dim;
+		__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+		for (unsigned int k = 0; k < blocks; k += 8)
+		{
+			const __m256i a = _mm256_cvtepi8_epi32 (_mm_loadl_epi64 ((const __m128i*) (item + k)));
+			const __m256  w = _mm256_loadu_ps (scale2 + k);
+			s0 = _mm256_add_ps (s0, quantizedBlockAvx2 (a, w, c + k));
+			s1 = _mm256_add_ps (s1, quantizedBlockAvx2 (a, w, c + dim + k));
+			s2 = _mm256_add_ps (s2, quantizedBlockAvx2 (a, w, c + 2 * dim + k));
+			s3 = _mm256_add_ps (s3, quantizedBlockAvx2 (a, w, c + 3 * dim + k));
+		}
+		const __m256 h = _mm256_hadd_ps (_mm256_hadd_ps (s0, s1), _mm256_hadd_ps (s2, s3));
+		_mm_storeu_ps (result + i, _mm_add_ps (_mm256_castps256_ps128 (h), _mm256_extractf128_ps (h, 1)));
+		for (unsigned int r = 0; r < 4; r++)
+			for (unsigned int k = blocks; k < dim; k++)
+			{
+				const float value = float (int (item[k]) - int (c[r * dim + k]));
+				result[i + r] += scale2[k] * value * value;
+			}
+	}
+	quantizedDistancesScalar (item, codes + (unsigned long) groups * dim, scale2, dim, count - groups, result + groups);
+}
+#endif
+
+//! \brief approximate squared distances of a quantized item to quantized rows, see quantizedDistancesScalar
+/*!
+  The kernel is chosen by simdLevel, the sums of the kernels may differ by rounding.
+*/
+inline void quantizedDistances (const signed char* item, const signed char* codes, const float* scale2, const unsigned int& dim, const unsigned int& count, float* result)
+{
+#ifdef NEURALGAS_SIMD_X86
+	switch (simdLevel ())
+	{
+	case avx512:
+	case avx2:   quantizedDistancesAvx2 (item, codes, scale2, dim, count, result); return;
+	default:     break;
+	}
+#endif
+	quantizedDistancesScalar (item, codes, scale2, dim, count, result);
+}
+
+//! \brief determines the two winner rows of a weight matrix for an item
+/*!
+  The rows are scanned like GNGModulGraph::getWinner does with the pre-specified metric:
+  the first winner is the closest row, the one with the smallest index among equally close
+  ones, the second winner is the row that was closest before the first winner was found.
+  The squared distances come from squaredDistances, the root is only taken when a row
+  is closer than the current first winner, the euclidean distances are compared then.
+  Thus the winners and the returned distance are the same as the ones of the scan using
+  euclidean, without a temporary vector and with one root per improvement.
+
+  \param x item, dim elements
+  \param weights weight matrix with at least two rows
+  \param first_winner after func call the closest row
+  \param second_winner after func call the row that was closest before first_winner was found
+
+  \return euclidean distance of the item to the first winner
+*/
+template<typename T>
+inline T nearestTwo (const T* x, const WeightMatrix<T>& weights, unsigned int& first_winner, unsigned int& second_winner)
+{
+	// rows per call of the kernel, the squared distances stay in the L1 cache
+	enum { block = 64 };
+	T squared[block];
+	T best_distance = std::numeric_limits<T>::max();
+	T best_squared  = std::numeric_limits<T>::max();
+	const unsigned int rows = weights.rows();
+
+	assert (rows >= 2);
+	first_winner  = 1;
+	second_winner = 0;
+
+	for (unsigned int begin = 0; begin < rows; begin += block)
+	{
+		const unsigned int count = (rows - begin < block) ? rows - begin : (unsigned int) block;
+		squaredDistances<T> (x, weights, begin, count, squared);
+		for (unsigned int i = 0; i < count; i++)
+			if (squared[i] < best_squared)
+			{
+				// different squares may have the same root
+				const T distance = T(sqrt(squared[i]));
+				if (distance < best_distance)
+				{
+					second_winner = first_winner;
+					first_winner  = begin + i;
+					best_distance = distance;
+					best_squared  = squared[i];
+				}
+			}
+	}
+	return best_distance;
+}
+
+} //namespace neuralgas
+
+#endif
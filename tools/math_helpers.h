@@ -179,6 +179,37 @@ template<typename T> Vector<T> maxValues(std::vector< Vector<T>* >* _data)
 	return max_data_values;
 } 
 
+/** \brief Determines the variances in each dim within the given data set
+*
+*  The mean of every dim is computed first, the variance is the mean squared
+*  deviation from it.
+* \param data data set
+*/
+template<typename T> Vector<T> variances(std::vector< Vector<T>* >* _data)
+{
+	assert (_data->size());
+	assert ((*_data)[0]->size());
+	const unsigned int dim = (*_data)[0]->size();
+	Vector<T> means (dim);
+	Vector<T> variance_values (dim);
+	for (unsigned int j = 0; j < dim; j++)
+		means[j] = variance_values[j] = 0;
+	for ( unsigned int i = 0; i < _data->size(); i++)
+		for ( unsigned int j = 0; j < dim; j++)
+			means[j] += (*(*_data)[i])[j];
+	for ( unsigned int j = 0; j < dim; j++)
+		means[j] /= _data->size();
+	for ( unsigned int i = 0; i < _data->size(); i++)
+		for ( unsigned int j = 0; j < dim; j++)
+		{
+			const T deviation = (*(*_data)[i])[j] - means[j];
+			variance_values[j] += deviation * deviation;
+		}
+	for ( unsigned int j = 0; j < dim; j++)
+		variance_values[j] /= _data->size();
+	return variance_values;
+}
+
 
 
 } // namespace neuralgas
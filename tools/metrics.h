@@ -29,7 +29,9 @@
 #define METRICS_H
 
 #include <Graphs/Vector.h>
+#include <Graphs/WeightMatrix.h>
 #include <math.h>
+#include <cassert>
 
 namespace neuralgas
 {
@@ -42,9 +44,33 @@ enum _meandistance_mode {harmonic, /**< calculate harmonic mean distances  */
 			 arithmetic /**< calculate arithmetic mean distances */
 };
 
-//! \brief The euclidean distance function
+//! \brief The euclidean distance function on raw arrays, no temporary vector is created
 /*! 
   
+  \param x first array
+  \param y second array
+  \param dim number of elements of both arrays
+  
+  \return distance
+*/template<typename T>
+inline T euclidean (const T* x, const T* y, const unsigned int& dim)
+{
+	T result = 0;
+	
+	for (unsigned int i=0; i < dim; i++)
+	{
+		const T value = x[i] - y[i];
+		result += value * value;
+	}
+	return T(sqrt(result));
+}
+
+//! \brief The euclidean distance function
+/*! 
+  The sum is the same as the one of the difference vector x - y, but the
+  difference is not stored in a temporary vector. Like x - y vectors of
+  different size have distance 0.
+
   \param x first vector
   \param y second vector
   
@@ -52,20 +78,178 @@ enum _meandistance_mode {harmonic, /**< calculate harmonic mean distances  */
 */template<typename T, typename S>
 inline T euclidean (const Vector<T>& x, const Vector<T>& y)
 {
-	T result;
-	T value;
-	Vector<T> z = x - y;
-	
-	//result =  _zero;
-	result = 0;
-	unsigned int tsize = z.size();
-	
-	for (unsigned int i=0; i < tsize; i++)
+	assert (x.size() == y.size());
+	if (x.size() == 0 || x.size() != y.size())
+		return 0;
+	return euclidean<T> (&x[0], &y[0], x.size());
+}
+
+//! \brief The euclidean distance between a vector and the weight vector of a node
+/*! 
+  
+  \param x vector
+  \param y weight vector of a node
+  
+  \return distance
+*/template<typename T, typename S>
+inline T euclidean (const Vector<T>& x, const NodeWeight<T>& y)
+{
+	assert (x.size() == y.size());
+	return euclidean<T> (&x[0], y.data(), y.size());
+}
+
+/** \struct L2Metric
+ *  \brief metric policy of the euclidean distance
+ *
+ * The metric policies are the compile-time alternative to a user defined metric set by
+ * setMetric: a graph instantiated with a policy calls its operator () directly in the
+ * innermost loop of the winner search, where it can be inlined and vectorized, instead of
+ * dispatching through a pointer to a member function. A policy provides
+ *
+ * T operator () (const T* x, const T* y, const unsigned int& dim) const
+ *
+ * and the enum isEuclidean telling whether it computes exactly euclidean, only then the
+ * accelerated winner searches for the euclidean distance are used.
+ */
+template<typename T> struct L2Metric
+{
+	enum { isEuclidean = 1 };
+	inline T operator () (const T* x, const T* y, const unsigned int& dim) const { return euclidean<T> (x, y, dim); }
+};
+
+/** \struct SquaredL2Metric
+ *  \brief metric policy of the squared euclidean distance, it has the same winners as L2Metric
+ */
+template<typename T> struct SquaredL2Metric
+{
+	enum { isEuclidean = 0 };
+	inline T operator () (const T* x, const T* y, const unsigned int& dim) const
 	{
-		value  = (z[i]*z[i]);
-		result+=  value;
+		T result = 0;
+		for (unsigned int i=0; i < dim; i++)
+		{
+			const T value = x[i] - y[i];
+			result += value * value;
+		}
+		return result;
 	}
-	return T(sqrt(result));
+};
+
+/** \struct L1Metric
+ *  \brief metric policy of the manhattan distance
+ */
+template<typename T> struct L1Metric
+{
+	enum { isEuclidean = 0 };
+	inline T operator () (const T* x, const T* y, const unsigned int& dim) const
+	{
+		T result = 0;
+		for (unsigned int i=0; i < dim; i++)
+			result += T(fabs (x[i] - y[i]));
+		return result;
+	}
+};
+
+/** \struct LInfMetric
+ *  \brief metric policy of the maximum distance
+ */
+template<typename T> struct LInfMetric
+{
+	enum { isEuclidean = 0 };
+	inline T operator () (const T* x, const T* y, const unsigned int& dim) const
+	{
+		T result = 0;
+		for (unsigned int i=0; i < dim; i++)
+		{
+			const T value = T(fabs (x[i] - y[i]));
+			if (value > result)
+				result = value;
+		}
+		return result;
+	}
+};
+
+/** \struct CosineMetric
+ *  \brief metric policy of the cosine distance 1 - cos(x,y)
+ *
+ * A zero vector has distance 1 to every vector.
+ */
+template<typename T> struct CosineMetric
+{
+	enum { isEuclidean = 0 };
+	inline T operator () (const T* x, const T* y, const unsigned int& dim) const
+	{
+		T dot = 0, xx = 0, yy = 0;
+		for (unsigned int i=0; i < dim; i++)
+		{
+			dot += x[i] * y[i];
+			xx  += x[i] * x[i];
+			yy  += y[i] * y[i];
+		}
+		if (xx == 0 || yy == 0)
+			return 1;
+		return 1 - dot / T(sqrt (xx * yy));
+	}
+};
+
+/** \class DiagonalMahalanobisMetric
+ *  \brief metric policy of the mahalanobis distance with a diagonal covariance matrix
+ *
+ * Every squared difference is divided by the variance of its dimension, without given
+ * variances the distance is euclidean.
+ *
+ * \param _inverseVariances inverse of the variance of every dimension
+ */
+template<typename T> class DiagonalMahalanobisMetric
+{
+public:
+	enum { isEuclidean = 0 };
+	//std cto, the distance is euclidean
+	DiagonalMahalanobisMetric () {}
+	//cto taking the variances of the dimensions
+	DiagonalMahalanobisMetric (const Vector<T>& variances) { setVariances (variances); }
+	//sets the variances of the dimensions, they have to be positive
+	void setVariances (const Vector<T>&);
+	//returns the distance
+	inline T operator () (const T*, const T*, const unsigned int&) const;
+private:
+	std::vector<T> _inverseVariances;
+};
+
+//! \brief sets the variances of the dimensions
+/*!
+  \param variances variance of every dimension, an empty vector makes the distance euclidean
+*/
+template<typename T> void DiagonalMahalanobisMetric<T>::setVariances (const Vector<T>& variances)
+{
+	_inverseVariances.resize (variances.size());
+	for (unsigned int i=0; i < variances.size(); i++)
+	{
+		assert (variances[i] > 0);
+		_inverseVariances[i] = 1 / variances[i];
+	}
+}
+
+//! \brief The mahalanobis distance with a diagonal covariance matrix
+/*!
+  \param x first array
+  \param y second array
+  \param dim number of elements of both arrays, the number of variances if set
+
+  \return distance
+*/
+template<typename T> inline T DiagonalMahalanobisMetric<T>::operator () (const T* x, const T* y, const unsigned int& dim) const
+{
+	if (_inverseVariances.empty())
+		return euclidean<T> (x, y, dim);
+	assert (_inverseVariances.size() == dim);
+	T result = 0;
+	for (unsigned int i=0; i < dim; i++)
+	{
+		const T value = x[i] - y[i];
+		result += value * value * _inverseVariances[i];
+	}
+	return T(sqrt (result));
 }
 
 } //namespace neuralgas